@@ -40,9 +40,33 @@ FOUNDATION_EXPORT const unsigned char ChronosVersionString[];
 // Protocols
 #import <Chronos/CHRTimer.h>
 #import <Chronos/CHRRepeatingTimer.h>
+#import <Chronos/CHRTimerScheduler.h>
 
 // Classes
 #import <Chronos/CHRDispatchTimer.h>
 #import <Chronos/CHRVariableTimer.h>
+#import <Chronos/CHRTimerWheel.h>
+#import <Chronos/CHRExecutionQueuePool.h>
+#import <Chronos/CHRTimerCoalescer.h>
+#import <Chronos/CHRLeewayPolicy.h>
+#import <Chronos/CHRTimerStatistics.h>
+#import <Chronos/CHRDebouncer.h>
+#import <Chronos/CHRThrottler.h>
+#import <Chronos/CHRTimeoutSet.h>
+#import <Chronos/CHRTimerPool.h>
+#import <Chronos/CHRParallelTimer.h>
+#import <Chronos/CHRTimerTrace.h>
+#import <Chronos/CHRTimerRegistry.h>
+#import <Chronos/CHRAdaptiveInterval.h>
+#import <Chronos/CHRVirtualClock.h>
+#import <Chronos/CHRBatcher.h>
+#import <Chronos/CHRCalendarSchedule.h>
+#import <Chronos/CHRCalendarTimer.h>
+#import <Chronos/CHRTimerGroup.h>
+#import <Chronos/CHRScheduleSnapshot.h>
+#import <Chronos/CHRPhasePolicy.h>
+
+// Functions
+#import <Chronos/CHRTimerFunctions.h>
 
 
@@ -0,0 +1,188 @@
+//
+//  CHRAdaptiveInterval.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRVariableTimer.h"
+
+
+#pragma mark - Type Definitions
+
+/**
+ The randomization applied to exponential backoff, which keeps many pollers
+ backing off from the same resource from polling in lockstep.
+ */
+typedef NS_ENUM(NSInteger, CHRBackoffJitter) {
+    /** Every interval is exactly the backoff. */
+    CHRBackoffJitterNone            = 0,
+    /** Every interval is uniformly distributed between the minimum interval
+     and the backoff. */
+    CHRBackoffJitterFull            = 1,
+    /** Every interval is uniformly distributed between the minimum interval
+     and the multiplier times the previous interval. */
+    CHRBackoffJitterDecorrelated    = 2
+};
+
+
+#pragma mark - CHRAdaptiveInterval Interface
+
+/**
+ The CHRAdaptiveInterval class computes the intervals of a polling
+ CHRVariableTimer from whether recent polls found work, so idle resources are
+ polled rarely and busy ones promptly.
+ 
+ Create an adaptive interval with one of the factory methods, pass its
+ intervalProvider to the timer and call reportWork: from the execution block
+ with the outcome of every poll. A poll that is not reported counts as idle.
+ Intervals always stay between the minimum and maximum interval, and the first
+ interval is the minimum.
+ 
+ An adaptive interval is thread safe but should drive a single timer.
+ */
+@interface CHRAdaptiveInterval : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating an Adaptive Interval
+// -----
+
+#pragma mark Creating an Adaptive Interval
+
+/**
+ Returns an exponential backoff. Every idle poll multiplies the backoff, every
+ poll that found work resets it to the minimum interval.
+ 
+ @param     minimumInterval
+            The interval after a poll that found work, in seconds.
+ @param     maximumInterval
+            The largest interval, in seconds.
+ @param     multiplier
+            The factor the backoff grows by on every idle poll, e.g. 2.0.
+ @param     jitter
+            The randomization applied to every interval.
+ @return    The adaptive interval.
+ */
++ (CHRAdaptiveInterval *)exponentialBackoffWithMinimumInterval:(NSTimeInterval)minimumInterval
+                                               maximumInterval:(NSTimeInterval)maximumInterval
+                                                    multiplier:(double)multiplier
+                                                        jitter:(CHRBackoffJitter)jitter;
+
+/**
+ Returns an additive increase, multiplicative decrease interval. Every idle
+ poll lengthens the interval by a fixed step, every poll that found work
+ shortens it by a factor, so a busy resource is caught up with quickly and an
+ idle one is backed off from gently.
+ 
+ @param     minimumInterval
+            The smallest interval, in seconds.
+ @param     maximumInterval
+            The largest interval, in seconds.
+ @param     increment
+            The amount added to the interval on every idle poll, in seconds.
+ @param     decreaseFactor
+            The factor the interval is multiplied by on every poll that found
+            work, between 0 and 1, e.g. 0.5.
+ @return    The adaptive interval.
+ */
++ (CHRAdaptiveInterval *)AIMDWithMinimumInterval:(NSTimeInterval)minimumInterval
+                                 maximumInterval:(NSTimeInterval)maximumInterval
+                                       increment:(NSTimeInterval)increment
+                                  decreaseFactor:(double)decreaseFactor;
+
+/**
+ Returns a bounded linear ramp. Every idle poll lengthens the interval by a
+ fixed step, every poll that found work resets it to the minimum interval.
+ 
+ @param     minimumInterval
+            The interval after a poll that found work, in seconds.
+ @param     maximumInterval
+            The largest interval, in seconds.
+ @param     step
+            The amount added to the interval on every idle poll, in seconds.
+ @return    The adaptive interval.
+ */
++ (CHRAdaptiveInterval *)linearRampWithMinimumInterval:(NSTimeInterval)minimumInterval
+                                       maximumInterval:(NSTimeInterval)maximumInterval
+                                                  step:(NSTimeInterval)step;
+
+// -----
+// @name Using an Adaptive Interval
+// -----
+
+#pragma mark Using an Adaptive Interval
+
+/**
+ Reports the outcome of the most recent poll. Call this from the execution
+ block before it returns.
+ 
+ @param     didWork
+            YES, if the poll found work.
+ */
+- (void)reportWork:(BOOL)didWork;
+
+/**
+ Computes the interval until the next poll from the outcome of the most recent
+ one. The interval provider calls this method.
+ 
+ @return    The next interval, in seconds.
+ */
+- (NSTimeInterval)nextInterval;
+
+/**
+ Returns the receiver to its initial state, as if nothing had been polled.
+ */
+- (void)reset;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The interval provider to create a CHRVariableTimer with. It retains the
+ receiver.
+ */
+@property (readonly) CHRVariableTimerIntervalProvider intervalProvider;
+
+/**
+ The smallest interval the receiver computes, in seconds.
+ */
+@property (readonly) NSTimeInterval minimumInterval;
+
+/**
+ The largest interval the receiver computes, in seconds.
+ */
+@property (readonly) NSTimeInterval maximumInterval;
+
+/**
+ The interval most recently computed, in seconds.
+ */
+@property (atomic, readonly) NSTimeInterval currentInterval;
+
+@end
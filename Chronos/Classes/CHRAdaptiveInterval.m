@@ -0,0 +1,247 @@
+//
+//  CHRAdaptiveInterval.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRAdaptiveInterval.h"
+#import <pthread.h>
+#import <stdlib.h>
+
+
+#pragma mark - Type Definitions
+
+typedef NS_ENUM(NSInteger, CHRAdaptiveIntervalKind) {
+    CHRAdaptiveIntervalKindExponentialBackoff   = 0,
+    CHRAdaptiveIntervalKindAIMD                 = 1,
+    CHRAdaptiveIntervalKindLinearRamp           = 2
+};
+
+
+#pragma mark - Constants and Functions
+
+/**
+ Returns a uniformly distributed value between the given bounds.
+ */
+static inline NSTimeInterval chr_uniform(NSTimeInterval lower, NSTimeInterval upper) {
+    return lower + (upper - lower) * ((double)arc4random() / UINT32_MAX);
+}
+
+
+#pragma mark - CHRAdaptiveInterval Class Extension
+
+@interface CHRAdaptiveInterval () {
+    pthread_mutex_t     _lock;
+    NSTimeInterval      _backoff;   // the interval before jitter
+    BOOL                _didWork;
+    BOOL                _started;
+}
+
+@property (readonly) CHRAdaptiveIntervalKind kind;
+@property (readonly) double     factor;
+@property (readonly) NSTimeInterval step;
+@property (readonly) CHRBackoffJitter jitter;
+
+@end
+
+
+#pragma mark - CHRAdaptiveInterval Implementation
+
+@implementation CHRAdaptiveInterval
+@synthesize currentInterval = _currentInterval;
+
+- (void)dealloc
+{
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating an Adaptive Interval
+
+- (instancetype)initWithKind:(CHRAdaptiveIntervalKind)kind
+             minimumInterval:(NSTimeInterval)minimumInterval
+             maximumInterval:(NSTimeInterval)maximumInterval
+                      factor:(double)factor
+                        step:(NSTimeInterval)step
+                      jitter:(CHRBackoffJitter)jitter
+{
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _kind = kind;
+        _minimumInterval = MAX(minimumInterval, 0.0);
+        _maximumInterval = MAX(maximumInterval, _minimumInterval);
+        _factor = MAX(factor, 0.0);
+        _step = MAX(step, 0.0);
+        _jitter = jitter;
+        _backoff = _minimumInterval;
+        _currentInterval = _minimumInterval;
+    }
+    return self;
+}
+
++ (CHRAdaptiveInterval *)exponentialBackoffWithMinimumInterval:(NSTimeInterval)minimumInterval
+                                               maximumInterval:(NSTimeInterval)maximumInterval
+                                                    multiplier:(double)multiplier
+                                                        jitter:(CHRBackoffJitter)jitter
+{
+    return [[CHRAdaptiveInterval alloc]initWithKind:CHRAdaptiveIntervalKindExponentialBackoff
+                                    minimumInterval:minimumInterval
+                                    maximumInterval:maximumInterval
+                                             factor:MAX(multiplier, 1.0)
+                                               step:0.0
+                                             jitter:jitter];
+}
+
++ (CHRAdaptiveInterval *)AIMDWithMinimumInterval:(NSTimeInterval)minimumInterval
+                                 maximumInterval:(NSTimeInterval)maximumInterval
+                                       increment:(NSTimeInterval)increment
+                                  decreaseFactor:(double)decreaseFactor
+{
+    return [[CHRAdaptiveInterval alloc]initWithKind:CHRAdaptiveIntervalKindAIMD
+                                    minimumInterval:minimumInterval
+                                    maximumInterval:maximumInterval
+                                             factor:MIN(decreaseFactor, 1.0)
+                                               step:increment
+                                             jitter:CHRBackoffJitterNone];
+}
+
++ (CHRAdaptiveInterval *)linearRampWithMinimumInterval:(NSTimeInterval)minimumInterval
+                                       maximumInterval:(NSTimeInterval)maximumInterval
+                                                  step:(NSTimeInterval)step
+{
+    return [[CHRAdaptiveInterval alloc]initWithKind:CHRAdaptiveIntervalKindLinearRamp
+                                    minimumInterval:minimumInterval
+                                    maximumInterval:maximumInterval
+                                             factor:1.0
+                                               step:step
+                                             jitter:CHRBackoffJitterNone];
+}
+
+#pragma mark Using an Adaptive Interval
+
+- (void)reportWork:(BOOL)didWork
+{
+    pthread_mutex_lock(&_lock);
+    _didWork = _didWork || didWork;
+    pthread_mutex_unlock(&_lock);
+}
+
+- (NSTimeInterval)nextInterval
+{
+    pthread_mutex_lock(&_lock);
+    NSTimeInterval interval = _minimumInterval;
+    if (_started) {
+        interval = [self intervalAfterWork:_didWork];
+    }
+    _started = YES;
+    _didWork = NO;
+    _currentInterval = interval;
+    pthread_mutex_unlock(&_lock);
+    return interval;
+}
+
+- (void)reset
+{
+    pthread_mutex_lock(&_lock);
+    _backoff = _minimumInterval;
+    _currentInterval = _minimumInterval;
+    _didWork = NO;
+    _started = NO;
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark Private
+
+/**
+ Advances the receiver by one poll and returns the next interval. Must be
+ called with the lock held.
+ */
+- (NSTimeInterval)intervalAfterWork:(BOOL)didWork
+{
+    switch (_kind) {
+        case CHRAdaptiveIntervalKindExponentialBackoff:
+            return [self backoffAfterWork:didWork];
+        case CHRAdaptiveIntervalKindAIMD:
+            _backoff = (didWork)? _backoff * _factor : _backoff + _step;
+            break;
+        case CHRAdaptiveIntervalKindLinearRamp:
+        default:
+            _backoff = (didWork)? _minimumInterval : _backoff + _step;
+            break;
+    }
+    _backoff = MIN(MAX(_backoff, _minimumInterval), _maximumInterval);
+    return _backoff;
+}
+
+/**
+ Advances the exponential backoff by one poll and returns the next interval.
+ Must be called with the lock held.
+ */
+- (NSTimeInterval)backoffAfterWork:(BOOL)didWork
+{
+    if (didWork) {
+        _backoff = _minimumInterval;
+        return _minimumInterval;
+    }
+    switch (_jitter) {
+        case CHRBackoffJitterFull:
+            _backoff = MIN(_backoff * _factor, _maximumInterval);
+            return chr_uniform(_minimumInterval, _backoff);
+        case CHRBackoffJitterDecorrelated:
+            // The previous interval, not the backoff, is what grows.
+            _backoff = MIN(chr_uniform(_minimumInterval, _currentInterval * _factor), _maximumInterval);
+            return MAX(_backoff, _minimumInterval);
+        case CHRBackoffJitterNone:
+        default:
+            _backoff = MIN(_backoff * _factor, _maximumInterval);
+            return _backoff;
+    }
+}
+
+#pragma mark Getters
+
+- (CHRVariableTimerIntervalProvider)intervalProvider
+{
+    return ^NSTimeInterval(__weak CHRVariableTimer *timer, NSUInteger nextInvocation) {
+        return [self nextInterval];
+    };
+}
+
+- (NSTimeInterval)currentInterval
+{
+    pthread_mutex_lock(&_lock);
+    NSTimeInterval interval = _currentInterval;
+    pthread_mutex_unlock(&_lock);
+    return interval;
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; minimum = %g; maximum = %g; current = %g>",
+            [self class], self, _minimumInterval, _maximumInterval, self.currentInterval];
+}
+
+@end
@@ -0,0 +1,225 @@
+//
+//  CHRBatcher.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - Type Definitions
+
+/**
+ The block that receives a batch of items.
+ 
+ @param     items
+            The items added since the previous flush, in the order each
+            producer added them.
+ */
+typedef void (^CHRBatcherFlushBlock)(NSArray *items);
+
+
+#pragma mark - CHRBatcher Interface
+
+/**
+ The CHRBatcher class accumulates items added from any number of threads and
+ hands them to a block in batches, once a batch reaches a maximum count or
+ size, or once its oldest item has waited for a maximum delay, whichever comes
+ first.
+ 
+ Adding an item is lock-free: items are pushed onto a multiple producer, single
+ consumer queue that is drained on the batcher's serial execution queue. The
+ batcher owns a single dispatch source, which is only armed while items are
+ pending, so an idle batcher causes no wakeups.
+ */
+@interface CHRBatcher : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Batcher
+// -----
+
+#pragma mark Creating a Batcher
+
+/**
+ Initializes a CHRBatcher object without a size threshold.
+ 
+ The flush block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool.
+ 
+ @param     maximumDelay
+            The longest time an item waits to be flushed, in seconds.
+ @param     maximumCount
+            The number of items that triggers a flush, or 0 for no limit.
+ @param     flushBlock
+            The block to execute for every batch.
+ @return    The newly initialized CHRBatcher object.
+ */
+- (instancetype)initWithMaximumDelay:(NSTimeInterval)maximumDelay
+                        maximumCount:(NSUInteger)maximumCount
+                          flushBlock:(CHRBatcherFlushBlock)flushBlock;
+
+/**
+ Initializes a CHRBatcher object.
+ 
+ @param     maximumDelay
+            The longest time an item waits to be flushed, in seconds.
+ @param     maximumCount
+            The number of items that triggers a flush, or 0 for no limit.
+ @param     maximumBytes
+            The total size of items, as given to addItem:size:, that triggers a
+            flush, or 0 for no limit.
+ @param     flushBlock
+            The block to execute for every batch.
+ @param     executionQueue
+            The serial queue that should execute the flushBlock.
+ @return    The newly initialized CHRBatcher object.
+ */
+- (instancetype)initWithMaximumDelay:(NSTimeInterval)maximumDelay
+                        maximumCount:(NSUInteger)maximumCount
+                        maximumBytes:(NSUInteger)maximumBytes
+                          flushBlock:(CHRBatcherFlushBlock)flushBlock
+                      executionQueue:(dispatch_queue_t)executionQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRBatcher object without a size threshold.
+ 
+ The flush block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool.
+ 
+ @param     maximumDelay
+            The longest time an item waits to be flushed, in seconds.
+ @param     maximumCount
+            The number of items that triggers a flush, or 0 for no limit.
+ @param     flushBlock
+            The block to execute for every batch.
+ @return    The newly created CHRBatcher object.
+ */
++ (CHRBatcher *)batcherWithMaximumDelay:(NSTimeInterval)maximumDelay
+                           maximumCount:(NSUInteger)maximumCount
+                             flushBlock:(CHRBatcherFlushBlock)flushBlock;
+
+/**
+ Creates and initializes a new CHRBatcher object.
+ 
+ @param     maximumDelay
+            The longest time an item waits to be flushed, in seconds.
+ @param     maximumCount
+            The number of items that triggers a flush, or 0 for no limit.
+ @param     maximumBytes
+            The total size of items, as given to addItem:size:, that triggers a
+            flush, or 0 for no limit.
+ @param     flushBlock
+            The block to execute for every batch.
+ @param     executionQueue
+            The serial queue that should execute the flushBlock.
+ @return    The newly created CHRBatcher object.
+ */
++ (CHRBatcher *)batcherWithMaximumDelay:(NSTimeInterval)maximumDelay
+                           maximumCount:(NSUInteger)maximumCount
+                           maximumBytes:(NSUInteger)maximumBytes
+                             flushBlock:(CHRBatcherFlushBlock)flushBlock
+                         executionQueue:(dispatch_queue_t)executionQueue;
+
+// -----
+// @name Using a Batcher
+// -----
+
+#pragma mark Using a Batcher
+
+/**
+ Adds an item of no particular size. Safe to call from any thread.
+ 
+ @param     item
+            The item to add.
+ */
+- (void)addItem:(id)item;
+
+/**
+ Adds an item. Safe to call from any thread.
+ 
+ @param     item
+            The item to add.
+ @param     size
+            The size of the item, in bytes, counted against maximumBytes.
+ */
+- (void)addItem:(id)item size:(NSUInteger)size;
+
+/**
+ Flushes the pending items as soon as possible, without waiting for a
+ threshold or the maximum delay.
+ */
+- (void)flush;
+
+/**
+ Stops the batcher. Items that are still pending are discarded and later items
+ are ignored; call flush first to deliver them.
+ */
+- (void)cancel;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The longest time an item waits to be flushed, in seconds.
+ */
+@property (readonly) NSTimeInterval maximumDelay;
+
+/**
+ The number of items that triggers a flush, or 0 for no limit. No batch holds
+ more items than this.
+ */
+@property (readonly) NSUInteger maximumCount;
+
+/**
+ The total size of items that triggers a flush, or 0 for no limit.
+ */
+@property (readonly) NSUInteger maximumBytes;
+
+/**
+ The receiver's execution queue.
+ */
+@property (readonly) dispatch_queue_t executionQueue;
+
+/**
+ The number of items added but not flushed yet.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ The number of batches handed to the flush block.
+ */
+@property (atomic, readonly) uint64_t flushes;
+
+/**
+ YES, if the receiver has not been canceled.
+ */
+@property (atomic, readonly, getter=isValid) BOOL valid;
+
+@end
@@ -0,0 +1,319 @@
+//
+//  CHRBatcher.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRBatcher.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRTimerInternal.h"
+
+
+#pragma mark - Constants and Functions
+
+typedef struct chr_batch_node_s *chr_batch_node_t;
+
+struct chr_batch_node_s {
+    _Atomic(chr_batch_node_t) next;
+    void                *item;      // retained
+    NSUInteger          size;
+};
+
+
+#pragma mark - CHRBatcher Class Extension
+
+@interface CHRBatcher () {
+    _Atomic(chr_batch_node_t) _head;    // most recently pushed node, written by producers
+    chr_batch_node_t    _tail;          // oldest node, owned by the consumer
+    struct chr_batch_node_s _stub;
+    _Atomic(int64_t)    _count;         // may briefly go negative, see -addItem:size:
+    _Atomic(int64_t)    _bytes;
+    _Atomic(uint64_t)   _flushes;
+    atomic_bool         _armed;         // the source is armed for the pending items
+    atomic_bool         _draining;      // a drain has been submitted to the queue
+    atomic_bool         _canceled;
+    uint64_t            _delay;         // maximum delay in nanoseconds
+}
+
+@property (readonly) dispatch_source_t timer;
+@property (readonly) CHRBatcherFlushBlock flushBlock;
+
+@end
+
+
+#pragma mark - CHRBatcher Implementation
+
+@implementation CHRBatcher
+
+- (void)dealloc
+{
+    [self cancel];
+    chr_batch_node_t node;
+    while ((node = [self pop])) {
+        CFBridgingRelease(node->item);
+        free(node);
+    }
+}
+
+#pragma mark Creating a Batcher
+
+- (instancetype)initWithMaximumDelay:(NSTimeInterval)maximumDelay
+                        maximumCount:(NSUInteger)maximumCount
+                          flushBlock:(CHRBatcherFlushBlock)flushBlock
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
+    return [self initWithMaximumDelay:maximumDelay
+                         maximumCount:maximumCount
+                         maximumBytes:0
+                           flushBlock:flushBlock
+                       executionQueue:executionQueue];
+}
+
+- (instancetype)initWithMaximumDelay:(NSTimeInterval)maximumDelay
+                        maximumCount:(NSUInteger)maximumCount
+                        maximumBytes:(NSUInteger)maximumBytes
+                          flushBlock:(CHRBatcherFlushBlock)flushBlock
+                      executionQueue:(dispatch_queue_t)executionQueue
+{
+    if (self = [super init]) {
+        _executionQueue = executionQueue;
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _executionQueue);
+        if (!_timer) {
+            NSLog(@"%@", @"Failed to create dispatch source for batcher.");
+            return nil;
+        }
+        atomic_init(&_stub.next, NULL);
+        atomic_init(&_head, &_stub);
+        _tail = &_stub;
+        _maximumDelay = maximumDelay;
+        _maximumCount = maximumCount;
+        _maximumBytes = maximumBytes;
+        _delay = chr_nanoseconds(maximumDelay);
+        _flushBlock = [flushBlock copy];
+        __weak CHRBatcher *weak = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weak drain];
+        });
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_timer);
+    }
+    return self;
+}
+
++ (CHRBatcher *)batcherWithMaximumDelay:(NSTimeInterval)maximumDelay
+                           maximumCount:(NSUInteger)maximumCount
+                             flushBlock:(CHRBatcherFlushBlock)flushBlock
+{
+    return [[CHRBatcher alloc]initWithMaximumDelay:maximumDelay
+                                      maximumCount:maximumCount
+                                        flushBlock:flushBlock];
+}
+
++ (CHRBatcher *)batcherWithMaximumDelay:(NSTimeInterval)maximumDelay
+                           maximumCount:(NSUInteger)maximumCount
+                           maximumBytes:(NSUInteger)maximumBytes
+                             flushBlock:(CHRBatcherFlushBlock)flushBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+{
+    return [[CHRBatcher alloc]initWithMaximumDelay:maximumDelay
+                                      maximumCount:maximumCount
+                                      maximumBytes:maximumBytes
+                                        flushBlock:flushBlock
+                                    executionQueue:executionQueue];
+}
+
+#pragma mark Using a Batcher
+
+- (void)addItem:(id)item
+{
+    [self addItem:item size:0];
+}
+
+- (void)addItem:(id)item size:(NSUInteger)size
+{
+    if (!item || atomic_load_explicit(&_canceled, memory_order_relaxed)) {
+        return;
+    }
+    chr_batch_node_t node = malloc(sizeof(struct chr_batch_node_s));
+    atomic_init(&node->next, NULL);
+    node->item = (__bridge_retained void *)item;
+    node->size = size;
+    [self push:node];
+    
+    // Counted after the push, so a concurrent drain may subtract the item first.
+    int64_t count = atomic_fetch_add(&_count, 1) + 1;
+    int64_t bytes = (size)? atomic_fetch_add_explicit(&_bytes, size, memory_order_relaxed) + size : 0;
+    if ((_maximumCount && count >= (int64_t)_maximumCount) || (_maximumBytes && bytes >= (int64_t)_maximumBytes)) {
+        [self submitDrain];
+    } else if (count > 0 && !atomic_load(&_armed)) {
+        // Sequentially consistent with the recheck at the end of -drain.
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&_armed, &expected, true)) {
+            dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, _delay), DISPATCH_TIME_FOREVER, chr_leeway(_maximumDelay));
+        }
+    }
+}
+
+- (void)flush
+{
+    [self submitDrain];
+}
+
+- (void)cancel
+{
+    bool expected = false;
+    if (atomic_compare_exchange_strong(&_canceled, &expected, true)) {
+        dispatch_source_cancel(_timer);
+    }
+}
+
+#pragma mark Private
+
+/**
+ Pushes a node onto the queue. Safe to call from any thread.
+ */
+- (void)push:(chr_batch_node_t)node
+{
+    chr_batch_node_t previous = atomic_exchange_explicit(&_head, node, memory_order_acq_rel);
+    atomic_store_explicit(&previous->next, node, memory_order_release);
+}
+
+/**
+ Pops the oldest node, or returns NULL if the queue is empty or the next node
+ is still being linked by a producer. Only the consumer may call this.
+ */
+- (chr_batch_node_t)pop
+{
+    chr_batch_node_t tail = _tail;
+    chr_batch_node_t next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (tail == &_stub) {
+        if (!next) {
+            return NULL;
+        }
+        _tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+    if (next) {
+        _tail = next;
+        return tail;
+    }
+    if (tail != atomic_load_explicit(&_head, memory_order_acquire)) {
+        return NULL;
+    }
+    atomic_store_explicit(&_stub.next, NULL, memory_order_relaxed);
+    [self push:&_stub];
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next) {
+        _tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+/**
+ Submits a drain to the execution queue unless one is already pending.
+ */
+- (void)submitDrain
+{
+    bool expected = false;
+    if (atomic_compare_exchange_strong(&_draining, &expected, true)) {
+        __weak CHRBatcher *weak = self;
+        dispatch_async(_executionQueue, ^{
+            [weak drain];
+        });
+    }
+}
+
+/**
+ Runs on the execution queue. Hands every pending item to the flush block in
+ batches of at most maximumCount items, then leaves the source armed only if
+ items arrived in the meantime.
+ */
+- (void)drain
+{
+    atomic_store(&_draining, false);
+    if (atomic_load_explicit(&_canceled, memory_order_relaxed)) {
+        return;
+    }
+    NSUInteger capacity = (_maximumCount)? _maximumCount : 16;
+    NSMutableArray *batch = [NSMutableArray arrayWithCapacity:capacity];
+    NSUInteger batchBytes = 0;
+    int64_t count = 0;
+    int64_t bytes = 0;
+    chr_batch_node_t node;
+    while ((node = [self pop])) {
+        [batch addObject:CFBridgingRelease(node->item)];
+        batchBytes += node->size;
+        count++;
+        bytes += node->size;
+        free(node);
+        if ((_maximumCount && batch.count >= _maximumCount) || (_maximumBytes && batchBytes >= _maximumBytes)) {
+            [self deliver:batch];
+            batch = [NSMutableArray arrayWithCapacity:capacity];
+            batchBytes = 0;
+        }
+    }
+    if (batch.count) {
+        [self deliver:batch];
+    }
+    atomic_fetch_sub_explicit(&_bytes, bytes, memory_order_relaxed);
+    atomic_fetch_sub(&_count, count);
+    
+    dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+    atomic_store(&_armed, false);
+    if (atomic_load(&_count) > 0) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&_armed, &expected, true)) {
+            dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, _delay), DISPATCH_TIME_FOREVER, chr_leeway(_maximumDelay));
+        }
+    }
+}
+
+- (void)deliver:(NSArray *)batch
+{
+    atomic_fetch_add_explicit(&_flushes, 1, memory_order_relaxed);
+    _flushBlock(batch);
+}
+
+#pragma mark Getters
+
+- (NSUInteger)count
+{
+    int64_t count = atomic_load(&_count);
+    return (count > 0)? (NSUInteger)count : 0;
+}
+
+- (uint64_t)flushes
+{
+    return atomic_load_explicit(&_flushes, memory_order_relaxed);
+}
+
+- (BOOL)isValid
+{
+    return !atomic_load(&_canceled);
+}
+
+@end
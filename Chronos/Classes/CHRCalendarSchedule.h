@@ -0,0 +1,158 @@
+//
+//  CHRCalendarSchedule.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - CHRCalendarSchedule Interface
+
+/**
+ The CHRCalendarSchedule class describes a recurring wall-clock schedule with a
+ cron expression, e.g. @"15 2 * * 1-5" for every weekday at 02:15.
+ 
+ An expression has five fields, minute (0-59), hour (0-23), day of month
+ (1-31), month (1-12 or JAN-DEC) and day of week (0-7 or SUN-SAT, where both 0
+ and 7 are Sunday). Each field is either `*` or a comma-separated list of
+ values and ranges, each optionally followed by a `/step`. As in cron, if both
+ the day of month and the day of week are restricted, a day matches if either
+ field matches. The macros @yearly, @annually, @monthly, @weekly, @daily,
+ @midnight and @hourly are also accepted.
+ 
+ The expression is compiled once into one bitset per field. Computing the next
+ firing time then takes a few bit scans and integer date conversions instead of
+ NSCalendar arithmetic, and the time zone's offset is cached until its next
+ transition.
+ 
+ Around daylight saving time transitions, a time skipped when clocks go forward
+ fires at the first instant after the gap. As in cron, a time repeated when
+ clocks go back fires only on its first occurrence if the hour field is
+ restricted, so fixed-hour jobs run once. Schedules whose hour field starts
+ with `*` keep firing on the repeated wall-clock times.
+ 
+ Schedules are immutable and can be shared between threads and timers.
+ */
+@interface CHRCalendarSchedule : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Calendar Schedule
+// -----
+
+#pragma mark Creating a Calendar Schedule
+
+/**
+ Initializes a CHRCalendarSchedule object in the default time zone.
+ 
+ @param     expression
+            The cron expression.
+ @return    The newly initialized CHRCalendarSchedule object, or nil if the
+            expression is invalid or can never match.
+ */
+- (instancetype)initWithExpression:(NSString *)expression;
+
+/**
+ Initializes a CHRCalendarSchedule object.
+ 
+ @param     expression
+            The cron expression.
+ @param     timeZone
+            The time zone the expression's wall-clock times refer to.
+ @return    The newly initialized CHRCalendarSchedule object, or nil if the
+            expression is invalid or can never match.
+ */
+- (instancetype)initWithExpression:(NSString *)expression
+                          timeZone:(NSTimeZone *)timeZone NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRCalendarSchedule object in the default time
+ zone.
+ 
+ @param     expression
+            The cron expression.
+ @return    The newly created CHRCalendarSchedule object, or nil if the
+            expression is invalid or can never match.
+ */
++ (CHRCalendarSchedule *)scheduleWithExpression:(NSString *)expression;
+
+/**
+ Creates and initializes a new CHRCalendarSchedule object.
+ 
+ @param     expression
+            The cron expression.
+ @param     timeZone
+            The time zone the expression's wall-clock times refer to.
+ @return    The newly created CHRCalendarSchedule object, or nil if the
+            expression is invalid or can never match.
+ */
++ (CHRCalendarSchedule *)scheduleWithExpression:(NSString *)expression
+                                       timeZone:(NSTimeZone *)timeZone;
+
+// -----
+// @name Using a Calendar Schedule
+// -----
+
+#pragma mark Using a Calendar Schedule
+
+/**
+ Computes the first firing time strictly after the given time.
+ 
+ @param     time
+            The time, in seconds since 1970.
+ @return    The firing time, in seconds since 1970, or NAN if there is none
+            within the next nine years.
+ */
+- (NSTimeInterval)nextFireTimeAfterTime:(NSTimeInterval)time;
+
+/**
+ Computes the first firing date strictly after the given date.
+ 
+ @param     date
+            The date.
+ @return    The firing date, or nil if there is none within the next nine
+            years.
+ */
+- (NSDate *)nextFireDateAfterDate:(NSDate *)date;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The cron expression the receiver was compiled from.
+ */
+@property (readonly, copy) NSString *expression;
+
+/**
+ The time zone the receiver's wall-clock times refer to.
+ */
+@property (readonly) NSTimeZone *timeZone;
+
+@end
@@ -0,0 +1,463 @@
+//
+//  CHRCalendarSchedule.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRCalendarSchedule.h"
+#import <pthread.h>
+
+
+#pragma mark - Constants and Functions
+
+#define CHR_CRON_SEARCH_YEARS   9
+
+typedef struct chr_cron_s {
+    uint64_t    minutes;                // bits 0-59
+    uint32_t    hours;                  // bits 0-23
+    uint32_t    days;                   // bits 1-31
+    uint32_t    months;                 // bits 1-12
+    uint32_t    weekdays;               // bits 0-6, Sunday is 0
+    bool        hoursRestricted;
+    bool        daysRestricted;
+    bool        weekdaysRestricted;
+} chr_cron_t;
+
+/**
+ A range of time over which a time zone's offset from GMT is constant.
+ */
+typedef struct chr_zone_span_s {
+    int64_t     from;
+    int64_t     until;
+    int32_t     offset;
+} chr_zone_span_t;
+
+static const char * const chr_cronMonthNames[] = {
+    "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+};
+
+static const char * const chr_cronWeekdayNames[] = {
+    "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"
+};
+
+static inline int64_t chr_floor_div(int64_t a, int64_t b) {
+    return (a >= 0)? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ Converts a proleptic Gregorian date to days since 1970-01-01.
+ */
+static inline int64_t chr_days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= (month <= 2);
+    int64_t era = chr_floor_div(year, 400);
+    int64_t yoe = year - era * 400;
+    int64_t doy = (153 * (month + ((month > 2)? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ Converts days since 1970-01-01 to a proleptic Gregorian date.
+ */
+static inline void chr_civil_from_days(int64_t days, int64_t *year, unsigned *month, unsigned *day) {
+    days += 719468;
+    int64_t era = chr_floor_div(days, 146097);
+    int64_t doe = days - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    *day = (unsigned)(doy - (153 * mp + 2) / 5 + 1);
+    *month = (unsigned)((mp < 10)? mp + 3 : mp - 9);
+    *year = yoe + era * 400 + (*month <= 2);
+}
+
+static inline unsigned chr_days_in_month(int64_t year, unsigned month) {
+    if (month == 2) {
+        return ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)? 29 : 28;
+    }
+    return (month == 4 || month == 6 || month == 9 || month == 11)? 30 : 31;
+}
+
+/**
+ Returns the days of the given month matching the schedule, as bits 1-31.
+ */
+static inline uint32_t chr_cron_days(const chr_cron_t *cron, int64_t year, unsigned month) {
+    uint32_t valid = ((1U << chr_days_in_month(year, month)) - 1) << 1;
+    unsigned first = (unsigned)((chr_days_from_civil(year, month, 1) % 7 + 11) % 7);
+    // Rotate the weekdays so bit i is the weekday of day i + 1, then repeat them
+    // over five weeks.
+    uint64_t week = ((cron->weekdays >> first) | (cron->weekdays << (7 - first))) & 0x7F;
+    uint32_t weekdays = (uint32_t)((week | week << 7 | week << 14 | week << 21 | week << 28) << 1);
+    uint32_t days = (cron->daysRestricted && cron->weekdaysRestricted)? cron->days | weekdays : cron->days & weekdays;
+    return days & valid;
+}
+
+/**
+ Finds the first wall-clock minute strictly after the given wall-clock time that
+ matches the schedule, or returns false if there is none within the search
+ window. Wall-clock times are seconds since 1970-01-01 00:00 local time.
+ */
+static bool chr_cron_next(const chr_cron_t *cron, int64_t wall, int64_t *next) {
+    int64_t minutes = chr_floor_div(wall, 60) + 1;
+    int64_t days = chr_floor_div(minutes, 1440);
+    unsigned hour = (unsigned)(minutes - days * 1440) / 60;
+    unsigned minute = (unsigned)(minutes - days * 1440) % 60;
+    int64_t year;
+    unsigned month, day;
+    chr_civil_from_days(days, &year, &month, &day);
+    int64_t lastYear = year + CHR_CRON_SEARCH_YEARS;
+    
+    while (year <= lastYear) {
+        if (!(cron->months & (1U << month))) {
+            uint32_t months = cron->months & ~((2U << month) - 1);
+            if (months) {
+                month = __builtin_ctz(months);
+            } else {
+                year++;
+                month = __builtin_ctz(cron->months);
+            }
+            day = 1; hour = 0; minute = 0;
+        }
+        uint32_t matchingDays = (day <= 31)? chr_cron_days(cron, year, month) & ~((1U << day) - 1) : 0;
+        if (!matchingDays) {
+            if (++month > 12) {
+                month = 1;
+                year++;
+            }
+            day = 1; hour = 0; minute = 0;
+            continue;
+        }
+        unsigned nextDay = __builtin_ctz(matchingDays);
+        if (nextDay != day) {
+            day = nextDay; hour = 0; minute = 0;
+        }
+        uint32_t hours = cron->hours & ~((1U << hour) - 1);
+        if (!hours) {
+            day++; hour = 0; minute = 0;
+            continue;
+        }
+        unsigned nextHour = __builtin_ctz(hours);
+        if (nextHour != hour) {
+            hour = nextHour; minute = 0;
+        }
+        uint64_t mins = cron->minutes & ~((1ULL << minute) - 1);
+        if (!mins) {
+            minute = 0;
+            if (++hour == 24) {
+                day++;
+                hour = 0;
+            }
+            continue;
+        }
+        minute = __builtin_ctzll(mins);
+        *next = ((chr_days_from_civil(year, month, day) * 24 + hour) * 60 + minute) * 60;
+        return true;
+    }
+    return false;
+}
+
+/**
+ Parses a number or, if names are given, a three letter name at the cursor.
+ */
+static bool chr_cron_value(const char **cursor, int minimum, int maximum, const char * const *names, int nameCount, int nameBase, int *value) {
+    const char *p = *cursor;
+    if (isdigit(*p)) {
+        int v = 0;
+        while (isdigit(*p)) {
+            v = v * 10 + (*p++ - '0');
+            if (v > 9999) {
+                return false;
+            }
+        }
+        *value = v;
+    } else {
+        int i = 0;
+        while (names && i < nameCount && strncasecmp(p, names[i], 3) != 0) {
+            i++;
+        }
+        if (!names || i == nameCount) {
+            return false;
+        }
+        *value = i + nameBase;
+        p += 3;
+    }
+    *cursor = p;
+    return *value >= minimum && *value <= maximum;
+}
+
+/**
+ Compiles a single field of an expression into a bitset.
+ */
+static bool chr_cron_field(const char *field, int minimum, int maximum, const char * const *names, int nameCount, int nameBase, uint64_t *bits, bool *restricted) {
+    const char *p = field;
+    *bits = 0;
+    *restricted = (*p != '*');
+    for (;;) {
+        int low, high, step = 1;
+        bool range = true;
+        if (*p == '*') {
+            low = minimum;
+            high = maximum;
+            p++;
+        } else {
+            if (!chr_cron_value(&p, minimum, maximum, names, nameCount, nameBase, &low)) {
+                return false;
+            }
+            high = low;
+            range = false;
+            if (*p == '-') {
+                p++;
+                if (!chr_cron_value(&p, minimum, maximum, names, nameCount, nameBase, &high) || high < low) {
+                    return false;
+                }
+                range = true;
+            }
+        }
+        if (*p == '/') {
+            p++;
+            if (!chr_cron_value(&p, 1, 9999, NULL, 0, 0, &step)) {
+                return false;
+            }
+            if (!range) {
+                high = maximum;
+            }
+        }
+        for (int value = low; value <= high; value += step) {
+            *bits |= (1ULL << value);
+        }
+        if (*p == ',') {
+            p++;
+            continue;
+        }
+        return *p == '\0';
+    }
+}
+
+static bool chr_cron_compile(NSArray *fields, chr_cron_t *cron) {
+    uint64_t bits[5];
+    bool restricted[5];
+    if (fields.count != 5 ||
+        !chr_cron_field([fields[0] UTF8String], 0, 59, NULL, 0, 0, &bits[0], &restricted[0]) ||
+        !chr_cron_field([fields[1] UTF8String], 0, 23, NULL, 0, 0, &bits[1], &restricted[1]) ||
+        !chr_cron_field([fields[2] UTF8String], 1, 31, NULL, 0, 0, &bits[2], &restricted[2]) ||
+        !chr_cron_field([fields[3] UTF8String], 1, 12, chr_cronMonthNames, 12, 1, &bits[3], &restricted[3]) ||
+        !chr_cron_field([fields[4] UTF8String], 0, 7, chr_cronWeekdayNames, 7, 0, &bits[4], &restricted[4])) {
+        return false;
+    }
+    cron->minutes = bits[0];
+    cron->hours = (uint32_t)bits[1];
+    cron->days = (uint32_t)bits[2];
+    cron->months = (uint32_t)bits[3];
+    cron->weekdays = (uint32_t)((bits[4] | (bits[4] >> 7)) & 0x7F);
+    cron->hoursRestricted = restricted[1];
+    cron->daysRestricted = restricted[2];
+    cron->weekdaysRestricted = restricted[4];
+    
+    // Reject days of month that no selected month has, e.g. 0 0 30 2 *.
+    if (cron->daysRestricted && !cron->weekdaysRestricted) {
+        for (unsigned month = 1; month <= 12; ++month) {
+            if ((cron->months & (1U << month)) && (cron->days & (((1U << chr_days_in_month(2000, month)) - 1) << 1))) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+
+#pragma mark - CHRCalendarSchedule Class Extension
+
+@interface CHRCalendarSchedule () {
+    chr_cron_t          _cron;
+    chr_zone_span_t     _span;          // most recently used offset, guarded by _lock
+    pthread_mutex_t     _lock;
+}
+
+@end
+
+
+#pragma mark - CHRCalendarSchedule Implementation
+
+@implementation CHRCalendarSchedule
+
+- (void)dealloc
+{
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Calendar Schedule
+
+- (instancetype)initWithExpression:(NSString *)expression
+{
+    return [self initWithExpression:expression timeZone:[NSTimeZone defaultTimeZone]];
+}
+
+- (instancetype)initWithExpression:(NSString *)expression timeZone:(NSTimeZone *)timeZone
+{
+    if (self = [super init]) {
+        NSDictionary *macros = @{@"@yearly"     : @"0 0 1 1 *",
+                                 @"@annually"   : @"0 0 1 1 *",
+                                 @"@monthly"    : @"0 0 1 * *",
+                                 @"@weekly"     : @"0 0 * * 0",
+                                 @"@daily"      : @"0 0 * * *",
+                                 @"@midnight"   : @"0 0 * * *",
+                                 @"@hourly"     : @"0 * * * *"};
+        NSCharacterSet *whitespace = [NSCharacterSet whitespaceCharacterSet];
+        NSString *trimmed = [expression stringByTrimmingCharactersInSet:whitespace];
+        NSString *expanded = macros[trimmed.lowercaseString] ?: trimmed;
+        NSMutableArray *fields = [NSMutableArray arrayWithCapacity:5];
+        for (NSString *field in [expanded componentsSeparatedByCharactersInSet:whitespace]) {
+            if (field.length) {
+                [fields addObject:field];
+            }
+        }
+        if (!chr_cron_compile(fields, &_cron)) {
+            NSLog(@"Invalid cron expression: %@", expression);
+            return nil;
+        }
+        pthread_mutex_init(&_lock, NULL);
+        _expression = [expression copy];
+        _timeZone = timeZone;
+        _span.from = INT64_MAX;
+    }
+    return self;
+}
+
++ (CHRCalendarSchedule *)scheduleWithExpression:(NSString *)expression
+{
+    return [[CHRCalendarSchedule alloc]initWithExpression:expression];
+}
+
++ (CHRCalendarSchedule *)scheduleWithExpression:(NSString *)expression timeZone:(NSTimeZone *)timeZone
+{
+    return [[CHRCalendarSchedule alloc]initWithExpression:expression timeZone:timeZone];
+}
+
+#pragma mark Using a Calendar Schedule
+
+- (NSTimeInterval)nextFireTimeAfterTime:(NSTimeInterval)time
+{
+    if (isnan(time)) {
+        return NAN;
+    }
+    int64_t after = (int64_t)floor(time);
+    chr_zone_span_t span = [self spanAtTime:after];
+    int64_t wall = after + span.offset;
+    int64_t fire;
+    for (;;) {
+        int64_t local;
+        if (!chr_cron_next(&_cron, wall, &local)) {
+            return NAN;
+        }
+        fire = [self timeForWallTime:local latest:NO];
+        if (fire <= after && !_cron.hoursRestricted) {
+            // Schedules with a wildcard hour fire again on the second occurrence.
+            fire = [self timeForWallTime:local latest:YES];
+        }
+        if (fire > after) {
+            break;
+        }
+        // A repeated wall-clock time whose first occurrence has passed.
+        wall = local;
+    }
+    
+    if (!_cron.hoursRestricted && span.until < fire) {
+        // Clocks going back before the next firing restart the wall clock at an
+        // earlier time, which a schedule with a wildcard hour fires on again.
+        int32_t offset = [self spanAtTime:span.until].offset;
+        int64_t local;
+        if (offset < span.offset && chr_cron_next(&_cron, span.until + offset - 1, &local) && local - offset < fire) {
+            fire = local - offset;
+        }
+    }
+    return fire;
+}
+
+- (NSDate *)nextFireDateAfterDate:(NSDate *)date
+{
+    NSTimeInterval time = [self nextFireTimeAfterTime:date.timeIntervalSince1970];
+    return (isnan(time))? nil : [NSDate dateWithTimeIntervalSince1970:time];
+}
+
+#pragma mark Private
+
+/**
+ Returns the span of the time zone containing the given time, reusing the
+ previous span while the time falls into it.
+ */
+- (chr_zone_span_t)spanAtTime:(int64_t)time
+{
+    pthread_mutex_lock(&_lock);
+    chr_zone_span_t span = _span;
+    pthread_mutex_unlock(&_lock);
+    if (time >= span.from && time < span.until) {
+        return span;
+    }
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:time];
+    NSDate *transition = [_timeZone nextDaylightSavingTimeTransitionAfterDate:date];
+    span.from = time;
+    span.until = (transition)? (int64_t)ceil(transition.timeIntervalSince1970) : INT64_MAX;
+    span.offset = (int32_t)[_timeZone secondsFromGMTForDate:date];
+    pthread_mutex_lock(&_lock);
+    _span = span;
+    pthread_mutex_unlock(&_lock);
+    return span;
+}
+
+/**
+ Converts a wall-clock time to the earliest, or latest, time showing it, or to
+ the end of the gap if clocks skipped it.
+ */
+- (int64_t)timeForWallTime:(int64_t)wall latest:(BOOL)latest
+{
+    int32_t before = [self spanAtTime:wall - 86400].offset;
+    int32_t after = [self spanAtTime:wall + 86400].offset;
+    if (before == after) {
+        return wall - before;
+    }
+    int64_t early = wall - before;
+    int64_t late = wall - after;
+    bool earlyValid = [self spanAtTime:early].offset == before;
+    chr_zone_span_t lateSpan = [self spanAtTime:late];
+    bool lateValid = lateSpan.offset == after;
+    if (earlyValid && lateValid) {
+        return (latest)? MAX(early, late) : MIN(early, late);
+    } else if (earlyValid) {
+        return early;
+    } else if (lateValid) {
+        return late;
+    }
+    // Clocks went forward over the wall-clock time, so the late candidate falls
+    // before the transition that ends the gap.
+    return lateSpan.until;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; expression = %@; timeZone = %@>", [self class], self, _expression, _timeZone.name];
+}
+
+@end
@@ -0,0 +1,159 @@
+//
+//  CHRCalendarTimer.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRTimer.h"
+#import "CHRCalendarSchedule.h"
+
+
+#pragma mark - Forward Declarations
+
+@class CHRCalendarTimer;
+
+
+#pragma mark - Type Definitions
+
+/**
+ The block to execute each time the calendar timer fires.
+ 
+ @param     timer
+            The timer that fired.
+ @param     invocation
+            The current invocation number. The first invocation is 0.
+ */
+typedef void (^CHRCalendarTimerExecutionBlock)(__weak CHRCalendarTimer *timer, NSUInteger invocation);
+
+
+#pragma mark - CHRCalendarTimer Interface
+
+/**
+ The CHRCalendarTimer class allows you to create timers that fire at the
+ wall-clock times of a CHRCalendarSchedule, e.g. every weekday at 02:15.
+ 
+ Each firing time is computed once from the compiled schedule and armed with
+ dispatch_walltime, so the timer follows changes to the system clock and keeps
+ firing at the right time across sleep. Firing times that pass while the
+ timer is paused are not replayed.
+ */
+@interface CHRCalendarTimer : NSObject <CHRTimer>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Calendar Timer
+// -----
+
+#pragma mark Creating a Calendar Timer
+
+/**
+ Initializes a CHRCalendarTimer object.
+ 
+ The execution block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool.
+ 
+ @param     schedule
+            The schedule of the timer's firing times.
+ @param     executionBlock
+            The block to execute each time the timer fires.
+ @return    The newly initialized CHRCalendarTimer object.
+ */
+- (instancetype)initWithSchedule:(CHRCalendarSchedule *)schedule
+                  executionBlock:(CHRCalendarTimerExecutionBlock)executionBlock;
+
+/**
+ Initializes a CHRCalendarTimer object.
+ 
+ @param     schedule
+            The schedule of the timer's firing times.
+ @param     executionBlock
+            The block to execute each time the timer fires.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @return    The newly initialized CHRCalendarTimer object.
+ */
+- (instancetype)initWithSchedule:(CHRCalendarSchedule *)schedule
+                  executionBlock:(CHRCalendarTimerExecutionBlock)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRCalendarTimer object.
+ 
+ The execution block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool.
+ 
+ @param     schedule
+            The schedule of the timer's firing times.
+ @param     executionBlock
+            The block to execute each time the timer fires.
+ @return    The newly created CHRCalendarTimer object.
+ */
++ (CHRCalendarTimer *)timerWithSchedule:(CHRCalendarSchedule *)schedule
+                         executionBlock:(CHRCalendarTimerExecutionBlock)executionBlock;
+
+/**
+ Creates and initializes a new CHRCalendarTimer object.
+ 
+ @param     schedule
+            The schedule of the timer's firing times.
+ @param     executionBlock
+            The block to execute each time the timer fires.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @return    The newly created CHRCalendarTimer object.
+ */
++ (CHRCalendarTimer *)timerWithSchedule:(CHRCalendarSchedule *)schedule
+                         executionBlock:(CHRCalendarTimerExecutionBlock)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The schedule of the receiver's firing times.
+ */
+@property (readonly) CHRCalendarSchedule *schedule;
+
+/**
+ The block to execute each time the receiver fires.
+ */
+@property (readonly, copy) CHRCalendarTimerExecutionBlock executionBlock;
+
+/**
+ The number of times the execution block has been executed.
+ */
+@property (atomic, readonly) NSUInteger invocations;
+
+/**
+ The date the receiver fires next, or nil if it is not running.
+ */
+@property (atomic, readonly) NSDate *nextFireDate;
+
+@end
@@ -0,0 +1,270 @@
+//
+//  CHRCalendarTimer.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRCalendarTimer.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRTimerInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - Constants and Functions
+
+/**
+ The leeway of every firing. Calendar schedules have a resolution of a minute,
+ so a second lets the system coalesce the wakeup without firing visibly late.
+ */
+static const uint64_t CHRCalendarTimerLeeway = NSEC_PER_SEC;
+
+static inline NSTimeInterval chr_walltime(void) {
+    return CFAbsoluteTimeGetCurrent() + kCFAbsoluteTimeIntervalSince1970;
+}
+
+
+#pragma mark - CHRCalendarTimer Class Extension
+
+@interface CHRCalendarTimer () {
+    chr_state_t         _state;
+    chr_counter_t       _invocations;
+    pthread_mutex_t     _lock;          // guards arming the source
+    NSTimeInterval      _fireTime;      // NAN while the source is disarmed
+}
+
+@property (readonly) dispatch_source_t timer;
+
+@end
+
+
+#pragma mark - CHRCalendarTimer Implementation
+
+@implementation CHRCalendarTimer
+@synthesize executionQueue = _executionQueue;
+
+- (void)dealloc
+{
+    [self cancel];
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Calendar Timer
+
+- (instancetype)initWithSchedule:(CHRCalendarSchedule *)schedule
+                  executionBlock:(CHRCalendarTimerExecutionBlock)executionBlock
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
+    return [self initWithSchedule:schedule
+                   executionBlock:executionBlock
+                   executionQueue:executionQueue];
+}
+
+- (instancetype)initWithSchedule:(CHRCalendarSchedule *)schedule
+                  executionBlock:(CHRCalendarTimerExecutionBlock)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+{
+    if (self = [super init]) {
+        _executionQueue = executionQueue;
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _executionQueue);
+        if (!_timer) {
+            NSLog(@"%@", @"Failed to create dispatch source for timer.");
+            return nil;
+        }
+        pthread_mutex_init(&_lock, NULL);
+        atomic_init(&_state, CHRTimerStateStopped);
+        _schedule = schedule;
+        _executionBlock = [executionBlock copy];
+        _fireTime = NAN;
+        __weak CHRCalendarTimer *weak = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weak fire];
+        });
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_timer);
+    }
+    return self;
+}
+
++ (CHRCalendarTimer *)timerWithSchedule:(CHRCalendarSchedule *)schedule
+                         executionBlock:(CHRCalendarTimerExecutionBlock)executionBlock
+{
+    return [[CHRCalendarTimer alloc]initWithSchedule:schedule
+                                      executionBlock:executionBlock];
+}
+
++ (CHRCalendarTimer *)timerWithSchedule:(CHRCalendarSchedule *)schedule
+                         executionBlock:(CHRCalendarTimerExecutionBlock)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+{
+    return [[CHRCalendarTimer alloc]initWithSchedule:schedule
+                                      executionBlock:executionBlock
+                                      executionQueue:executionQueue];
+}
+
+#pragma mark Using a Calendar Timer
+
+- (void)start:(BOOL)now
+{
+    [self validate];
+    
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateStopped)) == CHRTimerStateStopped) {
+        pthread_mutex_lock(&_lock);
+        [self armAfter:chr_walltime()];
+        pthread_mutex_unlock(&_lock);
+        if (now) {
+            __weak CHRCalendarTimer *weak = self;
+            dispatch_async(_executionQueue, ^{
+                [weak execute];
+            });
+        }
+        chr_state_end(&_state, CHRTimerStateRunning);
+    }
+}
+
+- (void)pause
+{
+    [self validate];
+    
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateRunning)) == CHRTimerStateRunning) {
+        pthread_mutex_lock(&_lock);
+        [self disarm];
+        pthread_mutex_unlock(&_lock);
+        chr_state_end(&_state, CHRTimerStateStopped);
+    }
+}
+
+- (void)cancel
+{
+    int32_t mask = CHR_STATE_MASK(CHRTimerStateStopped) | CHR_STATE_MASK(CHRTimerStateRunning);
+    if (chr_state_begin(&_state, mask) != CHRTimerStateTransitioning) {
+        pthread_mutex_lock(&_lock);
+        _fireTime = NAN;
+        pthread_mutex_unlock(&_lock);
+        dispatch_source_cancel(_timer);
+        chr_state_end(&_state, CHRTimerStateInvalid);
+    }
+}
+
+#pragma mark Private
+
+/**
+ Arms the source for the first firing time after the given time. Must be
+ called with the lock held.
+ */
+- (void)armAfter:(NSTimeInterval)time
+{
+    _fireTime = [_schedule nextFireTimeAfterTime:time];
+    if (isnan(_fireTime)) {
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        return;
+    }
+    struct timespec when = {
+        .tv_sec = (time_t)_fireTime,
+        .tv_nsec = (long)((_fireTime - floor(_fireTime)) * NSEC_PER_SEC)
+    };
+    dispatch_source_set_timer(_timer, dispatch_walltime(&when, 0), DISPATCH_TIME_FOREVER, CHRCalendarTimerLeeway);
+}
+
+/**
+ Disarms the source. Must be called with the lock held.
+ */
+- (void)disarm
+{
+    _fireTime = NAN;
+    dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+}
+
+/**
+ Runs on the execution queue when the source fires. Arms the next firing time
+ before executing the block, so a long execution cannot delay it.
+ */
+- (void)fire
+{
+    pthread_mutex_lock(&_lock);
+    NSTimeInterval fireTime = _fireTime;
+    if (isnan(fireTime)) {
+        // Paused or canceled after the source fired.
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    NSTimeInterval now = chr_walltime();
+    if (now + 1.0 < fireTime) {
+        // The system clock was set back after the source was armed.
+        [self armAfter:now];
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    [self armAfter:MAX(now, fireTime)];
+    pthread_mutex_unlock(&_lock);
+    [self execute];
+}
+
+- (void)execute
+{
+    if (chr_state_load(&_state) == CHRTimerStateInvalid) {
+        return;
+    }
+    // Reached from the source handler and from the block -start: submits, which
+    // may run at the same time on a concurrent execution queue.
+    NSUInteger invocation = atomic_fetch_add_explicit(&_invocations, 1, memory_order_relaxed);
+    __weak CHRCalendarTimer *weak = self;
+    _executionBlock(weak, invocation);
+}
+
+- (void)validate
+{
+    if (chr_state_load(&_state) == CHRTimerStateInvalid) {
+        @throw [NSException exceptionWithName:NSInternalInconsistencyException
+                                       reason:@"Attempting to use invalid CHRCalendarTimer."
+                                     userInfo:nil];
+    }
+}
+
+#pragma mark Getters
+
+- (BOOL)isRunning
+{
+    return chr_state_load(&_state) == CHRTimerStateRunning;
+}
+
+- (BOOL)isValid
+{
+    return chr_state_load(&_state) != CHRTimerStateInvalid;
+}
+
+- (NSUInteger)invocations
+{
+    return chr_counter_load(&_invocations);
+}
+
+- (NSDate *)nextFireDate
+{
+    pthread_mutex_lock(&_lock);
+    NSTimeInterval fireTime = _fireTime;
+    pthread_mutex_unlock(&_lock);
+    return (isnan(fireTime))? nil : [NSDate dateWithTimeIntervalSince1970:fireTime];
+}
+
+@end
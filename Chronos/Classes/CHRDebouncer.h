@@ -0,0 +1,169 @@
+//
+//  CHRDebouncer.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - CHRDebouncer Interface
+
+/**
+ The CHRDebouncer class collapses a burst of signals into a single execution of
+ a block, run once the signals have stopped for a given interval.
+ 
+ A debouncer owns a single dispatch source for its whole lifetime and re-arms
+ it at most once per interval, so signaling is lock-free and does not allocate.
+ It is suitable for events that arrive in large bursts, such as file system
+ changes or cache invalidations.
+ */
+@interface CHRDebouncer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Debouncer
+// -----
+
+#pragma mark Creating a Debouncer
+
+/**
+ Initializes a CHRDebouncer object.
+ 
+ The execution block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool.
+ 
+ @param     interval
+            The quiet period that ends a burst, in seconds.
+ @param     executionBlock
+            The block to execute for a burst.
+ @return    The newly initialized CHRDebouncer object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(dispatch_block_t)executionBlock;
+
+/**
+ Initializes a CHRDebouncer object.
+ 
+ @param     interval
+            The quiet period that ends a burst, in seconds.
+ @param     executionBlock
+            The block to execute for a burst.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @return    The newly initialized CHRDebouncer object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(dispatch_block_t)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRDebouncer object.
+ 
+ @param     interval
+            The quiet period that ends a burst, in seconds.
+ @param     executionBlock
+            The block to execute for a burst.
+ @return    The newly created CHRDebouncer object.
+ */
++ (CHRDebouncer *)debouncerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(dispatch_block_t)executionBlock;
+
+/**
+ Creates and initializes a new CHRDebouncer object.
+ 
+ @param     interval
+            The quiet period that ends a burst, in seconds.
+ @param     executionBlock
+            The block to execute for a burst.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @return    The newly created CHRDebouncer object.
+ */
++ (CHRDebouncer *)debouncerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(dispatch_block_t)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue;
+
+// -----
+// @name Using a Debouncer
+// -----
+
+#pragma mark Using a Debouncer
+
+/**
+ Records an event. Safe to call from any thread.
+ */
+- (void)signal;
+
+/**
+ Permanently cancels the debouncer. Pending executions are dropped and later
+ signals are ignored.
+ */
+- (void)cancel;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The quiet period that ends a burst, in seconds.
+ */
+@property (readonly) NSTimeInterval interval;
+
+/**
+ YES, if the execution block runs as soon as a burst begins. Defaults to NO.
+ Set this property before the first signal.
+ */
+@property (nonatomic, getter=isLeading) BOOL leading;
+
+/**
+ YES, if the execution block runs once a burst ends. Defaults to YES. When
+ leading is also YES, the block only runs at the end of a burst that received
+ more than one signal. Set this property before the first signal.
+ */
+@property (nonatomic, getter=isTrailing) BOOL trailing;
+
+/**
+ The longest time, in seconds, a burst may defer the execution block. Once a
+ burst has lasted this long the block runs even though signals keep arriving.
+ Defaults to 0, which means no limit. Set this property before the first
+ signal.
+ */
+@property (nonatomic) NSTimeInterval maximumWait;
+
+/**
+ The queue that executes the execution block.
+ */
+@property (readonly) dispatch_queue_t executionQueue;
+
+/**
+ YES, if the debouncer has not been canceled.
+ */
+@property (atomic, readonly, getter=isValid) BOOL valid;
+
+@end
@@ -0,0 +1,207 @@
+//
+//  CHRDebouncer.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRDebouncer.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRTimerInternal.h"
+
+
+#pragma mark - CHRDebouncer Class Extension
+
+@interface CHRDebouncer () {
+    _Atomic(uint64_t)   _lastSignal;    // chr_now() of the latest signal
+    atomic_bool         _pending;       // a signal has not been executed yet
+    atomic_bool         _armed;         // a burst is in progress and owns the source
+    atomic_bool         _canceled;
+    uint64_t            _burstStart;
+    uint64_t            _quiet;         // interval in nanoseconds
+}
+
+@property (readonly) dispatch_source_t timer;
+@property (readonly) dispatch_block_t executionBlock;
+
+@end
+
+
+#pragma mark - CHRDebouncer Implementation
+
+@implementation CHRDebouncer
+
+- (void)dealloc
+{
+    [self cancel];
+}
+
+#pragma mark Creating a Debouncer
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(dispatch_block_t)executionBlock
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
+    return [self initWithInterval:interval
+                   executionBlock:executionBlock
+                   executionQueue:executionQueue];
+}
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(dispatch_block_t)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+{
+    if (self = [super init]) {
+        _executionQueue = executionQueue;
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _executionQueue);
+        if (!_timer) {
+            NSLog(@"%@", @"Failed to create dispatch source for debouncer.");
+            return nil;
+        }
+        _interval = interval;
+        _quiet = chr_nanoseconds(interval);
+        _executionBlock = [executionBlock copy];
+        _trailing = YES;
+        __weak CHRDebouncer *weak = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weak fire];
+        });
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_timer);
+    }
+    return self;
+}
+
++ (CHRDebouncer *)debouncerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(dispatch_block_t)executionBlock
+{
+    return [[CHRDebouncer alloc]initWithInterval:interval
+                                  executionBlock:executionBlock];
+}
+
++ (CHRDebouncer *)debouncerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(dispatch_block_t)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+{
+    return [[CHRDebouncer alloc]initWithInterval:interval
+                                  executionBlock:executionBlock
+                                  executionQueue:executionQueue];
+}
+
+#pragma mark Using a Debouncer
+
+- (void)signal
+{
+    if (atomic_load_explicit(&_canceled, memory_order_relaxed)) {
+        return;
+    }
+    uint64_t now = chr_now();
+    atomic_store_explicit(&_lastSignal, now, memory_order_relaxed);
+    // Sequentially consistent with the check of _pending in -fire, so either the
+    // handler sees this signal or this call sees the debouncer idle.
+    atomic_store(&_pending, true);
+    if (!atomic_load(&_armed)) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&_armed, &expected, true)) {
+            [self beginBurstAt:now];
+        }
+    }
+}
+
+- (void)cancel
+{
+    bool expected = false;
+    if (atomic_compare_exchange_strong(&_canceled, &expected, true)) {
+        dispatch_source_cancel(_timer);
+    }
+}
+
+#pragma mark Private
+
+/**
+ Starts a burst. Called by whichever thread moved the debouncer from idle to
+ armed, which then owns the source until the burst ends.
+ */
+- (void)beginBurstAt:(uint64_t)now
+{
+    _burstStart = now;
+    if (_leading && atomic_exchange(&_pending, false)) {
+        dispatch_async(_executionQueue, _executionBlock);
+    }
+    [self armAt:now + _quiet now:now];
+}
+
+- (void)armAt:(uint64_t)deadline now:(uint64_t)now
+{
+    if (_maximumWait > 0.0) {
+        deadline = MIN(deadline, _burstStart + chr_nanoseconds(_maximumWait));
+    }
+    uint64_t delay = (deadline > now)? deadline - now : 0;
+    dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, delay), DISPATCH_TIME_FOREVER, chr_leeway(_interval));
+}
+
+/**
+ Runs on the execution queue when the source fires. Either the burst has been
+ quiet for the interval and ends, the maximum wait has passed, or later signals
+ extended the burst and the source is re-armed.
+ */
+- (void)fire
+{
+    if (atomic_load_explicit(&_canceled, memory_order_relaxed)) {
+        return;
+    }
+    uint64_t now = chr_now();
+    uint64_t last = atomic_load_explicit(&_lastSignal, memory_order_relaxed);
+    
+    if (last + _quiet > now) {
+        if (_maximumWait > 0.0 && now >= _burstStart + chr_nanoseconds(_maximumWait)) {
+            if (atomic_exchange(&_pending, false) && _trailing) {
+                _executionBlock();
+            }
+            _burstStart = now;
+        }
+        [self armAt:last + _quiet now:now];
+        return;
+    }
+    
+    if (atomic_exchange(&_pending, false) && _trailing) {
+        _executionBlock();
+    }
+    atomic_store(&_armed, false);
+    if (atomic_load(&_pending)) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&_armed, &expected, true)) {
+            [self beginBurstAt:chr_now()];
+        }
+    }
+}
+
+#pragma mark Getters
+
+- (BOOL)isValid
+{
+    return !atomic_load(&_canceled);
+}
+
+@end
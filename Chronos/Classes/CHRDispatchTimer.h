@@ -28,7 +28,29 @@
 
 @import Foundation;
 #import "CHRRepeatingTimer.h"
-#import <libkern/OSAtomic.h>
+#import "CHRTimerScheduler.h"
+#import "CHRLeewayPolicy.h"
+#import "CHRPhasePolicy.h"
+#import "CHRExecutionQueuePool.h"
+
+
+#pragma mark - Type Definitions
+
+/**
+ Determines what a timer does with the periods that elapsed while its execution
+ queue was too busy to run the execution block.
+ */
+typedef NS_ENUM(NSInteger, CHRCatchUpPolicy) {
+    /** Runs the execution block once for the latest period and drops the
+     missed ones. */
+    CHRCatchUpPolicySkip        = 0,
+    /** Runs the execution block once for all elapsed periods. The block reads
+     their number from the timer's elapsedPeriods property. */
+    CHRCatchUpPolicyCoalesce    = 1,
+    /** Runs the execution block once per elapsed period, up to the timer's
+     maximumReplayedInvocations, and drops the oldest periods beyond that. */
+    CHRCatchUpPolicyReplay      = 2
+};
 
 
 #pragma mark - CHRDispatchTimer Interface
@@ -55,7 +77,8 @@
 /**
  Initializes a CHRDispatchTimer object.
  
- The execution block will be executed on the default execution queue.
+ The execution block will be executed on the default execution queue, a serial
+ queue taken from the shared CHRExecutionQueuePool.
  
  @param     interval
             The execution interval, in seconds.
@@ -66,6 +89,25 @@
 - (instancetype)initWithInterval:(NSTimeInterval)interval
                   executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock;
 
+/**
+ Initializes a CHRDispatchTimer object.
+ 
+ The execution block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool of the given priority class, so it is never queued
+ behind the execution blocks of timers in other classes.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     priority
+            The priority class of the timer.
+ @return    The newly initialized CHRDispatch object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                        priority:(CHRTimerPriority)priority;
+
 /**
  Initializes a CHRDispatchTimer object.
  
@@ -97,13 +139,55 @@
 - (instancetype)initWithInterval:(NSTimeInterval)interval
                   executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
                   executionQueue:(dispatch_queue_t)executionQueue
+                    failureBlock:(CHRTimerInitFailureBlock)failureBlock;
+
+/**
+ Initializes a CHRDispatchTimer object.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @param     leewayPolicy
+            The policy that determines how much the timer may be deferred.
+ @param     failureBlock
+            The block to execute if the timer fails to initialize. 
+ @return    The newly initialized CHRDispatch object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+                    leewayPolicy:(CHRLeewayPolicy *)leewayPolicy
                     failureBlock:(CHRTimerInitFailureBlock)failureBlock
                     NS_DESIGNATED_INITIALIZER;
 
+/**
+ Initializes a CHRDispatchTimer object that is driven by a scheduler instead of
+ its own dispatch source.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @param     scheduler
+            The scheduler that drives the timer, such as a CHRTimerWheel.
+ @return    The newly initialized CHRDispatch object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+                       scheduler:(id<CHRTimerScheduler>)scheduler
+                      NS_DESIGNATED_INITIALIZER;
+
 /**
  Creates and initializes a new CHRDispatchTimer object.
  
- The execution block will be executed on the default execution queue.
+ The execution block will be executed on the default execution queue, a serial
+ queue taken from the shared CHRExecutionQueuePool.
  
  @param     interval
             The execution interval, in seconds.
@@ -114,6 +198,25 @@
 + (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
                          executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock;
 
+/**
+ Creates and initializes a new CHRDispatchTimer object.
+ 
+ The execution block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool of the given priority class, so it is never queued
+ behind the execution blocks of timers in other classes.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     priority
+            The priority class of the timer.
+ @return    The newly created CHRDispatch object.
+ */
++ (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                               priority:(CHRTimerPriority)priority;
+
 /**
  Creates and initializes a new CHRDispatchTimer object.
  
@@ -147,6 +250,46 @@
                          executionQueue:(dispatch_queue_t)executionQueue
                            failureBlock:(CHRTimerInitFailureBlock)failureBlock;
 
+/**
+ Creates and initializes a new CHRDispatchTimer object.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @param     leewayPolicy
+            The policy that determines how much the timer may be deferred.
+ @param     failureBlock
+            The block to execute if the timer fails to initialize.
+ @return    The newly created CHRDispatch object.
+ */
++ (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+                           leewayPolicy:(CHRLeewayPolicy *)leewayPolicy
+                           failureBlock:(CHRTimerInitFailureBlock)failureBlock;
+
+/**
+ Creates and initializes a new CHRDispatchTimer object that is driven by a
+ scheduler instead of its own dispatch source.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @param     scheduler
+            The scheduler that drives the timer, such as a CHRTimerWheel.
+ @return    The newly created CHRDispatch object.
+ */
++ (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+                              scheduler:(id<CHRTimerScheduler>)scheduler;
+
 // -----
 // @name Properties
 // -----
@@ -158,4 +301,64 @@
  */
 @property (readonly) NSTimeInterval interval;
 
+/**
+ The policy that determines how much the receiver's firings may be deferred.
+ Timers driven by a scheduler use the default policy.
+ */
+@property (readonly) CHRLeewayPolicy *leewayPolicy;
+
+/**
+ The scheduler that drives the receiver, or nil if the receiver owns its own
+ dispatch source.
+ */
+@property (readonly) id<CHRTimerScheduler> scheduler;
+
+/**
+ The priority class whose shared pool provided the receiver's execution queue.
+ Timers created with an execution queue report CHRTimerPriorityDefault.
+ */
+@property (readonly) CHRTimerPriority priority;
+
+/**
+ What the receiver does when several periods elapse before its execution block
+ can run. Defaults to CHRCatchUpPolicySkip. Set this property before starting
+ the timer.
+ */
+@property (nonatomic) CHRCatchUpPolicy catchUpPolicy;
+
+/**
+ The largest number of times the execution block runs for a single firing when
+ the catch-up policy is CHRCatchUpPolicyReplay. Defaults to 10.
+ */
+@property (nonatomic) NSUInteger maximumReplayedInvocations;
+
+/**
+ The number of periods covered by the current execution of the execution
+ block. Always 1 unless the catch-up policy is CHRCatchUpPolicyCoalesce. Only
+ meaningful from within the execution block. Executions the overlap policy
+ queues report their own count. On a concurrent execution queue, executions
+ running at the same time share this property, so it reports the count of the
+ one that started last.
+ */
+@property (atomic, readonly) NSUInteger elapsedPeriods;
+
+/**
+ The number of periods whose execution was dropped by the catch-up policy.
+ */
+@property (atomic, readonly) NSUInteger missedInvocations;
+
+/**
+ The policy that staggers the receiver's firings against those of other timers
+ with the same interval, or nil to fire in phase with the call to start:.
+ Defaults to nil. Set this property before starting the timer.
+ */
+@property (nonatomic) CHRPhasePolicy *phasePolicy;
+
+/**
+ The offset chosen by the phase policy, in seconds, by which every start of the
+ receiver delays its first firing. 0 until the receiver first starts with a
+ phase policy.
+ */
+@property (readonly) NSTimeInterval phaseOffset;
+
 @end
@@ -27,23 +27,60 @@
 #pragma mark - Imports
 
 #import "CHRDispatchTimer.h"
+#import "CHRDispatchTimerInternal.h"
+#import "CHRExecutionGate.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRScheduleSnapshotInternal.h"
 #import "CHRTimerInternal.h"
+#import "CHRTimerRegistryInternal.h"
+#import "CHRTimerStatisticsInternal.h"
+#import "CHRTimerTraceInternal.h"
+#import "CHRTimerFunctions.h"
 
 
 #pragma mark - Constants and Functions
 
-static NSString * const CHRDispatchTimerExecutionQueueNamePrefix = @"com.chronus.CHRDispatchTimer";
+static NSUInteger CHRDispatchTimerDefaultMaximumReplayedInvocations = 10;
+
+/**
+ The block the timer's source or scheduler calls when the timer fires. periods
+ is 0 when the caller cannot tell how many periods elapsed.
+ */
+typedef void (^CHRDispatchTimerEventHandler)(NSUInteger periods);
+
+/**
+ Calls the event handler block retained as the context of the timer.
+ */
+static void chr_dispatchTimerFire(void *context, NSUInteger invocation, NSUInteger periods) {
+    ((__bridge CHRDispatchTimerEventHandler)context)(periods);
+}
+
+/**
+ Releases the event handler block once the timer can no longer fire.
+ */
+static void chr_dispatchTimerFinalize(void *context) {
+    CFBridgingRelease(context);
+}
 
 
 #pragma mark - CHRDispatchTimer Class Extension
 
 @interface CHRDispatchTimer () {
-    volatile int32_t    _running;
-    volatile int32_t    _valid;
-    volatile NSUInteger _invocations;
+    chr_state_t         _state;
+    chr_counter_t       _invocations;
+    chr_counter_t       _missedInvocations;
+    chr_counter_t       _skippedInvocations;
+    chr_counter_t       _elapsedPeriods;
+    CHRTimerSchedulerEntry _entry;
+    _Atomic(uint64_t)   _deadline;
+    uint64_t            _phaseOffset;
+    BOOL                _phaseAcquired;
+    chr_registry_record_t _record;
+    BOOL                _schedulerClock;
 }
 
-@property (readonly) dispatch_source_t timer;
+@property (readonly) chr_timer_t timer;
+@property (nonatomic) CHRExecutionGate *gate;
 
 @end
 
@@ -53,10 +90,16 @@ static NSString * const CHRDispatchTimerExecutionQueueNamePrefix = @"com.chronus
 @implementation CHRDispatchTimer
 @synthesize executionQueue  = _executionQueue;
 @synthesize executionBlock  = _executionBlock;
+@synthesize statistics      = _statistics;
+@synthesize overlapPolicy   = _overlapPolicy;
+@synthesize maximumConcurrentExecutions = _maximumConcurrentExecutions;
+@synthesize maximumPendingExecutions    = _maximumPendingExecutions;
+@synthesize skipBlock       = _skipBlock;
 
 - (void)dealloc
 {
     [self cancel];
+    chr_registry_unregister(_record);
 }
 
 #pragma mark Creating a Dispatch Timer
@@ -64,13 +107,25 @@ static NSString * const CHRDispatchTimerExecutionQueueNamePrefix = @"com.chronus
 - (instancetype)initWithInterval:(NSTimeInterval)interval
                   executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
 {
-    NSString *executionQueueName = [NSString stringWithFormat:@"%@.%p", CHRDispatchTimerExecutionQueueNamePrefix, self];
-    dispatch_queue_t executionQueue = dispatch_queue_create([executionQueueName UTF8String], DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
     return [self initWithInterval:interval
                    executionBlock:executionBlock
                    executionQueue:executionQueue];
 }
 
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                        priority:(CHRTimerPriority)priority
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPoolForPriority:priority] queueForObject:self];
+    if (self = [self initWithInterval:interval
+                       executionBlock:executionBlock
+                       executionQueue:executionQueue]) {
+        _priority = priority;
+    }
+    return self;
+}
+
 - (instancetype)initWithInterval:(NSTimeInterval)interval
                   executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
                   executionQueue:(dispatch_queue_t)executionQueue
@@ -85,11 +140,33 @@ static NSString * const CHRDispatchTimerExecutionQueueNamePrefix = @"com.chronus
                   executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
                   executionQueue:(dispatch_queue_t)executionQueue
                     failureBlock:(CHRTimerInitFailureBlock)failureBlock
+{
+    return [self initWithInterval:interval
+                   executionBlock:executionBlock
+                   executionQueue:executionQueue
+                     leewayPolicy:[CHRLeewayPolicy defaultPolicy]
+                     failureBlock:failureBlock];
+}
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+                    leewayPolicy:(CHRLeewayPolicy *)leewayPolicy
+                    failureBlock:(CHRTimerInitFailureBlock)failureBlock
 {
     if (self = [super init]) {
         _executionQueue = executionQueue;
-        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _executionQueue);
+        _priority = CHRTimerPriorityDefault;
+        _leewayPolicy = leewayPolicy ?: [CHRLeewayPolicy defaultPolicy];
+        void *handler = (__bridge_retained void *)[self eventHandler];
+        _timer = chr_timer_create_with_leeway(interval,
+                                              [_leewayPolicy leewayForInterval:interval],
+                                              _leewayPolicy.isStrict,
+                                              _executionQueue,
+                                              handler,
+                                              chr_dispatchTimerFire);
         if (!_timer) {
+            CFBridgingRelease(handler);
             if (failureBlock) {
                 failureBlock();
             } else {
@@ -97,16 +174,40 @@ static NSString * const CHRDispatchTimerExecutionQueueNamePrefix = @"com.chronus
             }
             return nil;
         }
-        _valid = CHRTimerStateValid;
+        atomic_init(&_state, CHRTimerStateStopped);
         _interval = interval;
         _executionBlock = [executionBlock copy];
-        __weak CHRDispatchTimer *weak = self;
-        dispatch_source_set_event_handler(_timer, ^{
-            CHRDispatchTimer *strong = weak;
-            if (strong) {
-                strong.executionBlock(weak, strong->_invocations++);
-            }
-        });
+        _maximumReplayedInvocations = CHRDispatchTimerDefaultMaximumReplayedInvocations;
+        _maximumConcurrentExecutions = 1;
+        _maximumPendingExecutions = 1;
+        chr_timer_set_finalizer_f(_timer, chr_dispatchTimerFinalize);
+        _record = chr_registry_register([self class], _executionQueue, interval);
+    }
+    return self;
+}
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+                       scheduler:(id<CHRTimerScheduler>)scheduler
+{
+    if (self = [super init]) {
+        _executionQueue = executionQueue;
+        _priority = CHRTimerPriorityDefault;
+        _scheduler = scheduler;
+        _schedulerClock = [scheduler respondsToSelector:@selector(currentTime)];
+        _leewayPolicy = [CHRLeewayPolicy defaultPolicy];
+        atomic_init(&_state, CHRTimerStateStopped);
+        _interval = interval;
+        _executionBlock = [executionBlock copy];
+        _maximumReplayedInvocations = CHRDispatchTimerDefaultMaximumReplayedInvocations;
+        _maximumConcurrentExecutions = 1;
+        _maximumPendingExecutions = 1;
+        CHRDispatchTimerEventHandler handler = [self eventHandler];
+        _entry = [_scheduler createEntryWithQueue:_executionQueue handler:^{
+            handler(0);
+        }];
+        _record = chr_registry_register([self class], _executionQueue, interval);
     }
     return self;
 }
@@ -118,6 +219,15 @@ static NSString * const CHRDispatchTimerExecutionQueueNamePrefix = @"com.chronus
                                       executionBlock:executionBlock];
 }
 
++ (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                               priority:(CHRTimerPriority)priority
+{
+    return [[CHRDispatchTimer alloc]initWithInterval:interval
+                                      executionBlock:executionBlock
+                                            priority:priority];
+}
+
 + (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
                          executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
                          executionQueue:(dispatch_queue_t)executionQueue
@@ -138,15 +248,39 @@ static NSString * const CHRDispatchTimerExecutionQueueNamePrefix = @"com.chronus
                                         failureBlock:failureBlock];
 }
 
++ (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+                           leewayPolicy:(CHRLeewayPolicy *)leewayPolicy
+                           failureBlock:(CHRTimerInitFailureBlock)failureBlock
+{
+    return [[CHRDispatchTimer alloc]initWithInterval:interval
+                                      executionBlock:executionBlock
+                                      executionQueue:executionQueue
+                                        leewayPolicy:leewayPolicy
+                                        failureBlock:failureBlock];
+}
+
++ (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+                              scheduler:(id<CHRTimerScheduler>)scheduler
+{
+    return [[CHRDispatchTimer alloc]initWithInterval:interval
+                                      executionBlock:executionBlock
+                                      executionQueue:executionQueue
+                                           scheduler:scheduler];
+}
+
 #pragma mark Using a Dispatch Timer
 
 - (void)start:(BOOL)now 
 {
     [self validate];
     
-    if (OSAtomicCompareAndSwap32Barrier(CHRTimerStateStopped, CHRTimerStateRunning, &_running)) {
-        dispatch_source_set_timer(_timer, chr_startTime(_interval, now), _interval * NSEC_PER_SEC, chr_leeway(_interval));
-        dispatch_resume(_timer);
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateStopped)) == CHRTimerStateStopped) {
+        [self armWithDelay:((now)? 0 : chr_nanoseconds(_interval)) + [self acquirePhase]];
+        chr_state_end(&_state, CHRTimerStateRunning);
     }
 }
 
@@ -154,46 +288,322 @@ static NSString * const CHRDispatchTimerExecutionQueueNamePrefix = @"com.chronus
 {
     [self validate];
     
-    if (OSAtomicCompareAndSwap32Barrier(CHRTimerStateRunning, CHRTimerStateStopped, &_running)) {
-        dispatch_suspend(_timer);
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateRunning)) == CHRTimerStateRunning) {
+        chr_trace(CHRTimerTraceEventPause, (__bridge void *)self, chr_counter_load(&_invocations));
+        if (_scheduler) {
+            [_scheduler disarmEntry:_entry];
+        } else {
+            chr_timer_pause(_timer);
+        }
+        chr_registry_set_state(_record, CHRTimerStateStopped);
+        chr_state_end(&_state, CHRTimerStateStopped);
     }
 }
 
 - (void)cancel
 {
-    if (OSAtomicCompareAndSwap32Barrier(CHRTimerStateValid, CHRTimerStateInvalid, &_valid)) {
-        if (_running == CHRTimerStateStopped) {
-            dispatch_resume(_timer);
+    int32_t mask = CHR_STATE_MASK(CHRTimerStateStopped) | CHR_STATE_MASK(CHRTimerStateRunning);
+    if (chr_state_begin(&_state, mask) != CHRTimerStateTransitioning) {
+        chr_trace(CHRTimerTraceEventCancel, (__bridge void *)self, chr_counter_load(&_invocations));
+        if (_scheduler) {
+            [_scheduler destroyEntry:_entry];
+            _entry = NULL;
+        } else {
+            chr_timer_cancel(_timer);
+        }
+        [self releasePhase];
+        chr_registry_set_state(_record, CHRTimerStateInvalid);
+        chr_state_end(&_state, CHRTimerStateInvalid);
+    }
+}
+
+/**
+ Arms the underlying source or scheduler entry with its first firing due after
+ the given delay, in nanoseconds, rebuilding the overlap gate if the overlap
+ settings changed while the timer was stopped. Executions admitted by a
+ replaced gate still run to completion. Must be called while transitioning from
+ the stopped state.
+ */
+- (void)armWithDelay:(uint64_t)delay
+{
+    if (![CHRExecutionGate gate:_gate enforcesPolicyOfTimer:self]) {
+        _gate = [CHRExecutionGate gateForTimer:self queue:_executionQueue handler:[self gateHandler]];
+    }
+    if (atomic_load_explicit(&_deadline, memory_order_relaxed)) {
+        chr_trace(CHRTimerTraceEventResume, (__bridge void *)self, chr_counter_load(&_invocations));
+    }
+    chr_trace(CHRTimerTraceEventArm, (__bridge void *)self, chr_counter_load(&_invocations));
+    atomic_store_explicit(&_deadline, [self currentTime] + delay, memory_order_relaxed);
+    if (_scheduler) {
+        [_scheduler armEntry:_entry
+                       delay:delay
+                    interval:chr_nanoseconds(_interval)
+                      leeway:[_leewayPolicy leewayForInterval:_interval]];
+    } else {
+        chr_timer_start_after(_timer, (NSTimeInterval)delay / NSEC_PER_SEC);
+    }
+    chr_registry_set_state(_record, CHRTimerStateRunning);
+}
+
+/**
+ Returns the offset of the timer's firings, asking the phase policy for it the
+ first time.
+ */
+- (uint64_t)acquirePhase
+{
+    if (_phasePolicy && !_phaseAcquired) {
+        _phaseOffset = [_phasePolicy acquireOffsetForInterval:_interval];
+        _phaseAcquired = YES;
+    }
+    return _phaseOffset;
+}
+
+/**
+ Gives the offset of the timer's firings back to the phase policy.
+ */
+- (void)releasePhase
+{
+    if (_phaseAcquired) {
+        [_phasePolicy releaseOffset:_phaseOffset forInterval:_interval];
+        _phaseAcquired = NO;
+        _phaseOffset = 0;
+    }
+}
+
+- (CHRDispatchTimerEventHandler)eventHandler
+{
+    __weak CHRDispatchTimer *weak = self;
+    return ^(NSUInteger periods) {
+        CHRDispatchTimer *strong = weak;
+        if (strong) {
+            [strong fireWithPeriods:periods];
         }
-        _running = CHRTimerStateStopped;
-        dispatch_source_cancel(_timer);
+    };
+}
+
+/**
+ Runs the execution block for the given number of elapsed periods according to
+ the catch-up policy, and records the firing if statistics are enabled.
+ */
+- (void)fireWithPeriods:(NSUInteger)periods
+{
+    CHRTimerStatistics *statistics = _statistics;
+    uint64_t interval = chr_nanoseconds(_interval);
+    uint64_t start = (statistics || periods == 0)? [self currentTime] : 0;
+    uint64_t deadline = atomic_load_explicit(&_deadline, memory_order_relaxed);
+    NSUInteger elapsed;
+    do {
+        // Schedulers skip missed periods without reporting them, infer them from the clock.
+        elapsed = (periods)? periods : 1 + ((interval && start > deadline)? (start - deadline) / interval : 0);
+    } while (!atomic_compare_exchange_weak_explicit(&_deadline, &deadline, deadline + elapsed * interval,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    periods = elapsed;
+    
+    NSUInteger executions = 1;
+    if (_catchUpPolicy == CHRCatchUpPolicyReplay) {
+        executions = MIN(periods, MAX(_maximumReplayedInvocations, 1));
+    }
+    NSUInteger missed = (_catchUpPolicy == CHRCatchUpPolicyCoalesce)? 0 : periods - executions;
+    // Scheduler expiries may run concurrently on a concurrent queue, claim every period at once.
+    NSUInteger invocation = atomic_fetch_add_explicit(&_invocations, periods, memory_order_relaxed);
+    chr_trace(CHRTimerTraceEventFire, (__bridge void *)self, invocation);
+    if (missed) {
+        atomic_fetch_add_explicit(&_missedInvocations, missed, memory_order_relaxed);
+    }
+    
+    if (_catchUpPolicy == CHRCatchUpPolicyCoalesce) {
+        [self executeInvocation:invocation periods:periods];
+    } else {
+        invocation += missed;
+        for (NSUInteger i = 0; i < executions; ++i, ++invocation) {
+            if (i > 0 && chr_state_load(&_state) != CHRTimerStateRunning) {
+                // The execution block paused or canceled the timer, end the burst and
+                // account for the claimed invocations that will not run.
+                atomic_fetch_add_explicit(&_missedInvocations, executions - i, memory_order_relaxed);
+                break;
+            }
+            [self executeInvocation:invocation periods:1];
+        }
+    }
+    
+    if (statistics) {
+        uint64_t lateness = (start > deadline)? start - deadline : 0;
+        [statistics recordLateness:lateness duration:[self currentTime] - start skipped:missed];
     }
 }
 
+/**
+ Runs the execution block for the given invocation, or submits it to the gate
+ enforcing the overlap policy. The period count is published to elapsedPeriods
+ right before the block runs, not when the timer fires, so an invocation the
+ gate queued still reports its own count.
+ */
+- (void)executeInvocation:(NSUInteger)invocation periods:(NSUInteger)periods
+{
+    CHRExecutionGate *gate = _gate;
+    if (!gate) {
+        atomic_store_explicit(&_elapsedPeriods, periods, memory_order_relaxed);
+        chr_trace(CHRTimerTraceEventExecuteBegin, (__bridge void *)self, invocation);
+        uint64_t start = chr_registry_begin(_record);
+        _executionBlock(self, invocation);
+        chr_registry_end(_record, start);
+        chr_trace(CHRTimerTraceEventExecuteEnd, (__bridge void *)self, invocation);
+    } else if (![gate submitInvocation:invocation periods:periods]) {
+        atomic_fetch_add_explicit(&_skippedInvocations, 1, memory_order_relaxed);
+        CHRRepeatingTimerExecutionBlock skipBlock = _skipBlock;
+        if (skipBlock) {
+            skipBlock(self, invocation);
+        }
+    }
+}
+
+/**
+ The block the overlap gate runs for an admitted invocation. It keeps the
+ execution block the gate was created with.
+ */
+- (CHRExecutionGateHandler)gateHandler
+{
+    __weak CHRDispatchTimer *weak = self;
+    CHRRepeatingTimerExecutionBlock executionBlock = _executionBlock;
+    return ^(NSUInteger invocation, NSUInteger periods) {
+        CHRDispatchTimer *strong = weak;
+        if (strong) {
+            atomic_store_explicit(&strong->_elapsedPeriods, periods, memory_order_relaxed);
+            chr_trace(CHRTimerTraceEventExecuteBegin, (__bridge void *)strong, invocation);
+            uint64_t start = chr_registry_begin(strong->_record);
+            executionBlock(strong, invocation);
+            chr_registry_end(strong->_record, start);
+            chr_trace(CHRTimerTraceEventExecuteEnd, (__bridge void *)strong, invocation);
+        }
+    };
+}
+
+/**
+ Returns the current time of the clock the timer's deadlines are measured on,
+ in nanoseconds.
+ */
+- (uint64_t)currentTime
+{
+    return (_schedulerClock)? [_scheduler currentTime] : chr_now();
+}
+
 - (void)validate
 {
-    if (_valid != CHRTimerStateValid) {
+    if (chr_state_load(&_state) == CHRTimerStateInvalid) {
         @throw [NSException exceptionWithName:NSInternalInconsistencyException
                                        reason:@"Attempting to use invalid CHRDispatchTimer."
                                      userInfo:nil];
     }
 }
 
+#pragma mark Recycling
+
+- (BOOL)resetWithInterval:(NSTimeInterval)interval
+           executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+{
+    if (_scheduler || chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateStopped)) != CHRTimerStateStopped) {
+        return NO;
+    }
+    chr_timer_reset(_timer, interval, [_leewayPolicy leewayForInterval:interval]);
+    [self releasePhase];
+    _phasePolicy = nil;
+    _interval = interval;
+    chr_registry_set_interval(_record, chr_nanoseconds(interval));
+    _executionBlock = [executionBlock copy];
+    _statistics = nil;
+    _catchUpPolicy = CHRCatchUpPolicySkip;
+    _maximumReplayedInvocations = CHRDispatchTimerDefaultMaximumReplayedInvocations;
+    atomic_store_explicit(&_elapsedPeriods, 0, memory_order_relaxed);
+    atomic_store_explicit(&_deadline, 0, memory_order_relaxed);
+    _gate = nil;
+    _overlapPolicy = CHROverlapPolicyUnbounded;
+    _maximumConcurrentExecutions = 1;
+    _maximumPendingExecutions = 1;
+    _skipBlock = nil;
+    atomic_store_explicit(&_skippedInvocations, 0, memory_order_relaxed);
+    atomic_store_explicit(&_invocations, 0, memory_order_relaxed);
+    atomic_store_explicit(&_missedInvocations, 0, memory_order_relaxed);
+    chr_state_end(&_state, CHRTimerStateStopped);
+    return YES;
+}
+
+#pragma mark Snapshots
+
+- (BOOL)getScheduleDelay:(int64_t *)delay
+                interval:(uint64_t *)interval
+             invocations:(NSUInteger *)invocations
+{
+    *invocations = chr_counter_load(&_invocations);
+    *interval = chr_nanoseconds(_interval);
+    if (chr_state_load(&_state) != CHRTimerStateRunning) {
+        *delay = 0;
+        return NO;
+    }
+    *delay = (int64_t)(atomic_load_explicit(&_deadline, memory_order_relaxed) - [self currentTime]);
+    return YES;
+}
+
+- (BOOL)restoreInvocations:(NSUInteger)invocations
+                     delay:(uint64_t)delay
+                  interval:(uint64_t)interval
+                   running:(BOOL)running
+{
+    [self validate];
+    
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateStopped)) != CHRTimerStateStopped) {
+        return NO;
+    }
+    atomic_store_explicit(&_invocations, invocations, memory_order_relaxed);
+    if (running) {
+        [self armWithDelay:delay];
+    }
+    chr_state_end(&_state, (running)? CHRTimerStateRunning : CHRTimerStateStopped);
+    return YES;
+}
+
+#pragma mark Setters
+
+- (void)setPhasePolicy:(CHRPhasePolicy *)phasePolicy
+{
+    [self releasePhase];
+    _phasePolicy = phasePolicy;
+}
+
 #pragma mark Getters
 
 - (BOOL)isRunning
 {
-    return _running == CHRTimerStateRunning;
+    return chr_state_load(&_state) == CHRTimerStateRunning;
 }
 
 - (BOOL)isValid
 {
-    return _valid == CHRTimerStateValid;
+    return chr_state_load(&_state) != CHRTimerStateInvalid;
 }
 
 - (NSUInteger)invocations
 {
-    return _invocations;
+    return chr_counter_load(&_invocations);
+}
+
+- (NSUInteger)missedInvocations
+{
+    return chr_counter_load(&_missedInvocations);
+}
+
+- (NSUInteger)elapsedPeriods
+{
+    return chr_counter_load(&_elapsedPeriods);
+}
+
+- (NSUInteger)skippedInvocations
+{
+    return chr_counter_load(&_skippedInvocations);
+}
+
+- (NSTimeInterval)phaseOffset
+{
+    return (NSTimeInterval)_phaseOffset / NSEC_PER_SEC;
 }
 
 @end
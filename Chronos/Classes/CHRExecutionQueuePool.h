@@ -0,0 +1,145 @@
+//
+//  CHRExecutionQueuePool.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - Type Definitions
+
+/**
+ The priority class of a timer. Each class has its own shared execution queue
+ pool whose queues target the global queue of the class's quality of service,
+ so execution blocks of one class are never queued behind those of another,
+ and the number of queues in the pool bounds how many threads the class can
+ occupy at once. Before iOS 8 and OS X 10.10, which lack quality of service
+ classes, the pools target the global queue of the closest dispatch queue
+ priority instead.
+ */
+typedef NS_ENUM(NSInteger, CHRTimerPriority) {
+    /** Housekeeping that can wait. QOS_CLASS_BACKGROUND, one queue per two
+     active processors. */
+    CHRTimerPriorityBackground  = 0,
+    /** Long running work the user is not waiting on. QOS_CLASS_UTILITY, one
+     queue per active processor. */
+    CHRTimerPriorityUtility     = 1,
+    /** The shared pool. */
+    CHRTimerPriorityDefault     = 2,
+    /** Latency-critical timers such as heartbeats. QOS_CLASS_USER_INTERACTIVE,
+     one queue per active processor. */
+    CHRTimerPriorityHigh        = 3
+};
+
+
+#pragma mark - CHRExecutionQueuePool Interface
+
+/**
+ The CHRExecutionQueuePool class maintains a fixed number of serial dispatch
+ queues that are shared between timers.
+ 
+ An object is always mapped to the same queue, so the execution blocks of a
+ timer never run concurrently with each other, but the total number of queues
+ stays bounded no matter how many timers are created. Timers that share a queue
+ also execute serially with respect to each other, so long running execution
+ blocks should be given a dedicated execution queue instead.
+ */
+@interface CHRExecutionQueuePool : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating an Execution Queue Pool
+// -----
+
+#pragma mark Creating an Execution Queue Pool
+
+/**
+ Initializes a CHRExecutionQueuePool object whose queues target the default
+ priority global queue.
+ 
+ @param     queueCount
+            The number of serial queues in the pool.
+ @return    The newly initialized CHRExecutionQueuePool object.
+ */
+- (instancetype)initWithQueueCount:(NSUInteger)queueCount;
+
+/**
+ Initializes a CHRExecutionQueuePool object.
+ 
+ @param     queueCount
+            The number of serial queues in the pool.
+ @param     targetQueue
+            The queue targeted by every queue in the pool.
+ @return    The newly initialized CHRExecutionQueuePool object.
+ */
+- (instancetype)initWithQueueCount:(NSUInteger)queueCount
+                       targetQueue:(dispatch_queue_t)targetQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Returns the pool used by the timer initializers that do not take an execution
+ queue. The shared pool holds four queues per active processor.
+ */
++ (CHRExecutionQueuePool *)sharedPool;
+
+/**
+ Returns the pool used by the timer initializers that take a priority. The
+ pool for CHRTimerPriorityDefault is the shared pool.
+ 
+ @param     priority
+            The priority class.
+ @return    The pool of the priority class.
+ */
++ (CHRExecutionQueuePool *)sharedPoolForPriority:(CHRTimerPriority)priority;
+
+// -----
+// @name Using an Execution Queue Pool
+// -----
+
+#pragma mark Using an Execution Queue Pool
+
+/**
+ Returns the serial queue assigned to the given object. The same queue is
+ returned every time for a given object.
+ 
+ @param     object
+            The object, typically a timer, to return a queue for.
+ @return    A serial queue from the pool.
+ */
+- (dispatch_queue_t)queueForObject:(id)object;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The number of serial queues in the receiver.
+ */
+@property (readonly) NSUInteger queueCount;
+
+@end
@@ -0,0 +1,161 @@
+//
+//  CHRExecutionQueuePool.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRExecutionQueuePool.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSString * const CHRExecutionQueuePoolQueueNamePrefix = @"com.chronus.CHRExecutionQueuePool";
+
+static const NSUInteger CHRExecutionQueuePoolQueuesPerProcessor = 4;
+
+/**
+ Mixes the bits of a pointer so that objects allocated next to each other are
+ spread evenly across the pool.
+ */
+static inline uint64_t chr_pointerHash(const void *pointer) {
+    uint64_t hash = (uintptr_t)pointer;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ Returns the global queue for a priority class. Quality of service classes
+ arrived with iOS 8 and OS X 10.10, earlier systems get the closest dispatch
+ queue priority instead.
+ */
+static dispatch_queue_t chr_globalQueueForPriority(CHRTimerPriority priority) {
+#if (defined(__IPHONE_OS_VERSION_MIN_REQUIRED) && __IPHONE_OS_VERSION_MIN_REQUIRED >= 80000) || \
+    (defined(__MAC_OS_X_VERSION_MIN_REQUIRED) && __MAC_OS_X_VERSION_MIN_REQUIRED >= 101000)
+    BOOL hasQoS = YES;
+#else
+    BOOL hasQoS = (&dispatch_queue_attr_make_with_qos_class != NULL);
+#endif
+    // Kept apart from the priorities: qos_class_t is unsigned, so mixing it with
+    // the negative priorities in one expression would turn them into invalid
+    // identifiers.
+    if (hasQoS) {
+        switch (priority) {
+            case CHRTimerPriorityBackground:
+                return dispatch_get_global_queue(QOS_CLASS_BACKGROUND, 0);
+            case CHRTimerPriorityUtility:
+                return dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+            case CHRTimerPriorityHigh:
+                return dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0);
+            default:
+                return dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0);
+        }
+    }
+    switch (priority) {
+        case CHRTimerPriorityBackground:
+            return dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0);
+        case CHRTimerPriorityUtility:
+            return dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0);
+        case CHRTimerPriorityHigh:
+            return dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+        default:
+            return dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    }
+}
+
+
+#pragma mark - CHRExecutionQueuePool Class Extension
+
+@interface CHRExecutionQueuePool ()
+
+@property (readonly) NSArray *queues;
+
+@end
+
+
+#pragma mark - CHRExecutionQueuePool Implementation
+
+@implementation CHRExecutionQueuePool
+
+#pragma mark Creating an Execution Queue Pool
+
+- (instancetype)initWithQueueCount:(NSUInteger)queueCount
+{
+    return [self initWithQueueCount:queueCount
+                        targetQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+}
+
+- (instancetype)initWithQueueCount:(NSUInteger)queueCount targetQueue:(dispatch_queue_t)targetQueue
+{
+    if (self = [super init]) {
+        _queueCount = MAX(queueCount, 1);
+        NSMutableArray *queues = [NSMutableArray arrayWithCapacity:_queueCount];
+        for (NSUInteger i = 0; i < _queueCount; ++i) {
+            NSString *queueName = [NSString stringWithFormat:@"%@.%p.%lu", CHRExecutionQueuePoolQueueNamePrefix, self, (unsigned long)i];
+            dispatch_queue_t queue = dispatch_queue_create([queueName UTF8String], DISPATCH_QUEUE_SERIAL);
+            dispatch_set_target_queue(queue, targetQueue);
+            [queues addObject:queue];
+        }
+        _queues = [queues copy];
+    }
+    return self;
+}
+
++ (CHRExecutionQueuePool *)sharedPool
+{
+    static CHRExecutionQueuePool *sharedPool = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSUInteger processorCount = [[NSProcessInfo processInfo] activeProcessorCount];
+        sharedPool = [[CHRExecutionQueuePool alloc]initWithQueueCount:CHRExecutionQueuePoolQueuesPerProcessor * processorCount];
+    });
+    return sharedPool;
+}
+
++ (CHRExecutionQueuePool *)sharedPoolForPriority:(CHRTimerPriority)priority
+{
+    static CHRExecutionQueuePool *pools[CHRTimerPriorityHigh + 1];
+    static dispatch_once_t onceTokens[CHRTimerPriorityHigh + 1];
+    if (priority < CHRTimerPriorityBackground || priority > CHRTimerPriorityHigh || priority == CHRTimerPriorityDefault) {
+        return [self sharedPool];
+    }
+    dispatch_once(&onceTokens[priority], ^{
+        NSUInteger processorCount = [[NSProcessInfo processInfo] activeProcessorCount];
+        NSUInteger queueCount = (priority == CHRTimerPriorityBackground)? MAX(processorCount / 2, 1) : processorCount;
+        pools[priority] = [[CHRExecutionQueuePool alloc]initWithQueueCount:queueCount
+                                                               targetQueue:chr_globalQueueForPriority(priority)];
+    });
+    return pools[priority];
+}
+
+#pragma mark Using an Execution Queue Pool
+
+- (dispatch_queue_t)queueForObject:(id)object
+{
+    return _queues[chr_pointerHash((__bridge const void *)object) % _queueCount];
+}
+
+@end
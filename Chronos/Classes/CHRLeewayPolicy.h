@@ -0,0 +1,111 @@
+//
+//  CHRLeewayPolicy.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - CHRLeewayPolicy Interface
+
+/**
+ The CHRLeewayPolicy class determines how much the system may defer the firing
+ of a timer.
+ 
+ A larger leeway lets the system coalesce the timer's wakeups with other work
+ and saves power, a smaller leeway improves accuracy. A strict policy requests
+ no leeway at all and additionally asks the system to never coalesce the timer
+ (DISPATCH_TIMER_STRICT), which is suitable for short control loops.
+ 
+ Policies are immutable and can be shared between timers.
+ */
+@interface CHRLeewayPolicy : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Leeway Policy
+// -----
+
+#pragma mark Creating a Leeway Policy
+
+/**
+ Returns the policy used by timers that are not given one, a leeway of 5% of
+ the timer's interval.
+ */
++ (CHRLeewayPolicy *)defaultPolicy;
+
+/**
+ Returns a policy whose leeway is a fraction of the timer's interval.
+ 
+ @param     percentage
+            The leeway as a fraction of the interval, e.g. 0.05 for 5%.
+ @return    The leeway policy.
+ */
++ (CHRLeewayPolicy *)policyWithPercentage:(double)percentage;
+
+/**
+ Returns a policy with the same leeway for every interval.
+ 
+ @param     leeway
+            The leeway, in seconds.
+ @return    The leeway policy.
+ */
++ (CHRLeewayPolicy *)policyWithFixedLeeway:(NSTimeInterval)leeway;
+
+/**
+ Returns a policy with no leeway that also prevents the system from coalescing
+ the timer, where supported.
+ */
++ (CHRLeewayPolicy *)strictPolicy;
+
+// -----
+// @name Using a Leeway Policy
+// -----
+
+#pragma mark Using a Leeway Policy
+
+/**
+ Computes the leeway for the given interval.
+ 
+ @param     interval
+            The timer's interval, in seconds.
+ @return    The leeway, in nanoseconds.
+ */
+- (uint64_t)leewayForInterval:(NSTimeInterval)interval;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ YES, if timers using the receiver are created with DISPATCH_TIMER_STRICT.
+ */
+@property (readonly, getter=isStrict) BOOL strict;
+
+@end
@@ -0,0 +1,113 @@
+//
+//  CHRLeewayPolicy.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRLeewayPolicy.h"
+#import "CHRTimerInternal.h"
+
+
+#pragma mark - Constants and Functions
+
+static const double CHRLeewayPolicyDefaultPercentage = 0.05;
+
+
+#pragma mark - CHRLeewayPolicy Class Extension
+
+@interface CHRLeewayPolicy ()
+
+@property (readonly) double     percentage;
+@property (readonly) uint64_t   fixedLeeway;
+
+@end
+
+
+#pragma mark - CHRLeewayPolicy Implementation
+
+@implementation CHRLeewayPolicy
+
+#pragma mark Creating a Leeway Policy
+
+- (instancetype)initWithPercentage:(double)percentage fixedLeeway:(uint64_t)fixedLeeway strict:(BOOL)strict
+{
+    if (self = [super init]) {
+        _percentage = MAX(percentage, 0.0);
+        _fixedLeeway = fixedLeeway;
+        _strict = strict;
+    }
+    return self;
+}
+
++ (CHRLeewayPolicy *)defaultPolicy
+{
+    static CHRLeewayPolicy *defaultPolicy = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        defaultPolicy = [CHRLeewayPolicy policyWithPercentage:CHRLeewayPolicyDefaultPercentage];
+    });
+    return defaultPolicy;
+}
+
++ (CHRLeewayPolicy *)policyWithPercentage:(double)percentage
+{
+    return [[CHRLeewayPolicy alloc]initWithPercentage:percentage fixedLeeway:0 strict:NO];
+}
+
++ (CHRLeewayPolicy *)policyWithFixedLeeway:(NSTimeInterval)leeway
+{
+    return [[CHRLeewayPolicy alloc]initWithPercentage:0.0 fixedLeeway:chr_nanoseconds(leeway) strict:NO];
+}
+
++ (CHRLeewayPolicy *)strictPolicy
+{
+    static CHRLeewayPolicy *strictPolicy = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        strictPolicy = [[CHRLeewayPolicy alloc]initWithPercentage:0.0 fixedLeeway:0 strict:YES];
+    });
+    return strictPolicy;
+}
+
+#pragma mark Using a Leeway Policy
+
+- (uint64_t)leewayForInterval:(NSTimeInterval)interval
+{
+    return _fixedLeeway + chr_nanoseconds(_percentage * interval);
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+    if (_strict) {
+        return [NSString stringWithFormat:@"<%@: %p; strict>", [self class], self];
+    } else if (_fixedLeeway) {
+        return [NSString stringWithFormat:@"<%@: %p; fixed = %llu ns>", [self class], self, _fixedLeeway];
+    }
+    return [NSString stringWithFormat:@"<%@: %p; percentage = %g>", [self class], self, _percentage];
+}
+
+@end
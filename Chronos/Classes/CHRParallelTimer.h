@@ -0,0 +1,203 @@
+//
+//  CHRParallelTimer.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRTimer.h"
+
+
+#pragma mark - Forward Declarations
+
+@class CHRParallelTimer;
+@class CHRTimerStatistics;
+
+
+#pragma mark - Type Definitions
+
+/**
+ The block to execute for every shard each time the timer fires.
+ 
+ @param     timer
+            The timer that fired.
+ @param     invocation
+            The current invocation number. The first invocation is 0.
+ @param     shard
+            The index of the shard to process, from 0 to shardCount - 1.
+ */
+typedef void (^CHRParallelTimerShardBlock)(__weak CHRParallelTimer *timer, NSUInteger invocation, NSUInteger shard);
+
+/**
+ The block to execute once every shard of a firing has been processed.
+ 
+ @param     timer
+            The timer that fired.
+ @param     invocation
+            The invocation number of the firing.
+ @param     duration
+            The wall time spent processing all shards, in seconds.
+ */
+typedef void (^CHRParallelTimerTickBlock)(__weak CHRParallelTimer *timer, NSUInteger invocation, NSTimeInterval duration);
+
+
+#pragma mark - CHRParallelTimer Interface
+
+/**
+ The CHRParallelTimer class allows you to create timers whose work is split
+ into shards that are processed in parallel every time the timer fires.
+ 
+ Each firing applies the shard block to every shard with dispatch_apply on the
+ timer's concurrent execution queue and waits for all of them before the
+ firing completes, so a firing takes roughly shardCount / active processors
+ times as long as a single shard. Firings never overlap; periods that elapse
+ while a firing is still running are skipped.
+ */
+@interface CHRParallelTimer : NSObject <CHRTimer>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Parallel Timer
+// -----
+
+#pragma mark Creating a Parallel Timer
+
+/**
+ Initializes a CHRParallelTimer object.
+ 
+ The shards will be processed on the default priority global queue.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     shardCount
+            The number of shards processed on every firing.
+ @param     shardBlock
+            The block to execute for every shard.
+ @return    The newly initialized CHRParallelTimer object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                      shardCount:(NSUInteger)shardCount
+                      shardBlock:(CHRParallelTimerShardBlock)shardBlock;
+
+/**
+ Initializes a CHRParallelTimer object.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     shardCount
+            The number of shards processed on every firing.
+ @param     shardBlock
+            The block to execute for every shard.
+ @param     executionQueue
+            The concurrent queue that should process the shards.
+ @return    The newly initialized CHRParallelTimer object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                      shardCount:(NSUInteger)shardCount
+                      shardBlock:(CHRParallelTimerShardBlock)shardBlock
+                  executionQueue:(dispatch_queue_t)executionQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRParallelTimer object.
+ 
+ The shards will be processed on the default priority global queue.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     shardCount
+            The number of shards processed on every firing.
+ @param     shardBlock
+            The block to execute for every shard.
+ @return    The newly created CHRParallelTimer object.
+ */
++ (CHRParallelTimer *)timerWithInterval:(NSTimeInterval)interval
+                             shardCount:(NSUInteger)shardCount
+                             shardBlock:(CHRParallelTimerShardBlock)shardBlock;
+
+/**
+ Creates and initializes a new CHRParallelTimer object.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     shardCount
+            The number of shards processed on every firing.
+ @param     shardBlock
+            The block to execute for every shard.
+ @param     executionQueue
+            The concurrent queue that should process the shards.
+ @return    The newly created CHRParallelTimer object.
+ */
++ (CHRParallelTimer *)timerWithInterval:(NSTimeInterval)interval
+                             shardCount:(NSUInteger)shardCount
+                             shardBlock:(CHRParallelTimerShardBlock)shardBlock
+                         executionQueue:(dispatch_queue_t)executionQueue;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The receiver's execution interval, in seconds.
+ */
+@property (readonly) NSTimeInterval interval;
+
+/**
+ The number of shards processed on every firing.
+ */
+@property (readonly) NSUInteger shardCount;
+
+/**
+ The receiver's shard block.
+ */
+@property (readonly, copy) CHRParallelTimerShardBlock shardBlock;
+
+/**
+ The block to execute once all shards of a firing have been processed, on the
+ receiver's internal serial queue. Optional. Set this property before starting
+ the timer.
+ */
+@property (nonatomic, copy) CHRParallelTimerTickBlock tickBlock;
+
+/**
+ The number of times the timer has fired.
+ */
+@property (atomic, readonly) NSUInteger invocations;
+
+/**
+ The wall time spent processing all shards of the most recent firing, in
+ seconds.
+ */
+@property (atomic, readonly) NSTimeInterval lastTickDuration;
+
+/**
+ The object recording the lateness and wall time of the receiver's firings, or
+ nil if none are recorded. Set this property before starting the timer.
+ */
+@property (nonatomic, strong) CHRTimerStatistics *statistics;
+
+@end
@@ -0,0 +1,242 @@
+//
+//  CHRParallelTimer.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRParallelTimer.h"
+#import "CHRTimerFunctions.h"
+#import "CHRTimerInternal.h"
+#import "CHRTimerStatisticsInternal.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSString * const CHRParallelTimerQueueNamePrefix = @"com.chronus.CHRParallelTimer";
+
+/**
+ The block the timer's source calls when the timer fires.
+ */
+typedef void (^CHRParallelTimerEventHandler)(NSUInteger invocation, NSUInteger periods);
+
+static void chr_parallelTimerFire(void *context, NSUInteger invocation, NSUInteger periods) {
+    ((__bridge CHRParallelTimerEventHandler)context)(invocation, periods);
+}
+
+static void chr_parallelTimerFinalize(void *context) {
+    CFBridgingRelease(context);
+}
+
+
+#pragma mark - CHRParallelTimer Class Extension
+
+@interface CHRParallelTimer () {
+    chr_state_t         _state;
+    chr_counter_t       _invocations;
+    _Atomic(uint64_t)   _lastTickDuration;  // nanoseconds
+    _Atomic(uint64_t)   _deadline;
+}
+
+@property (readonly) chr_timer_t timer;
+@property (readonly) dispatch_queue_t tickQueue;
+
+@end
+
+
+#pragma mark - CHRParallelTimer Implementation
+
+@implementation CHRParallelTimer
+@synthesize executionQueue = _executionQueue;
+
+- (void)dealloc
+{
+    [self cancel];
+}
+
+#pragma mark Creating a Parallel Timer
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                      shardCount:(NSUInteger)shardCount
+                      shardBlock:(CHRParallelTimerShardBlock)shardBlock
+{
+    return [self initWithInterval:interval
+                       shardCount:shardCount
+                       shardBlock:shardBlock
+                   executionQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+}
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                      shardCount:(NSUInteger)shardCount
+                      shardBlock:(CHRParallelTimerShardBlock)shardBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+{
+    if (self = [super init]) {
+        NSString *queueName = [NSString stringWithFormat:@"%@.%p", CHRParallelTimerQueueNamePrefix, self];
+        _tickQueue = dispatch_queue_create([queueName UTF8String], DISPATCH_QUEUE_SERIAL);
+        void *handler = (__bridge_retained void *)[self eventHandler];
+        _timer = chr_timer_create(interval, _tickQueue, handler, chr_parallelTimerFire);
+        if (!_timer) {
+            CFBridgingRelease(handler);
+            NSLog(@"%@", @"Failed to create dispatch source for timer.");
+            return nil;
+        }
+        chr_timer_set_finalizer_f(_timer, chr_parallelTimerFinalize);
+        atomic_init(&_state, CHRTimerStateStopped);
+        _interval = interval;
+        _shardCount = shardCount;
+        _shardBlock = [shardBlock copy];
+        _executionQueue = executionQueue;
+    }
+    return self;
+}
+
++ (CHRParallelTimer *)timerWithInterval:(NSTimeInterval)interval
+                             shardCount:(NSUInteger)shardCount
+                             shardBlock:(CHRParallelTimerShardBlock)shardBlock
+{
+    return [[CHRParallelTimer alloc]initWithInterval:interval
+                                          shardCount:shardCount
+                                          shardBlock:shardBlock];
+}
+
++ (CHRParallelTimer *)timerWithInterval:(NSTimeInterval)interval
+                             shardCount:(NSUInteger)shardCount
+                             shardBlock:(CHRParallelTimerShardBlock)shardBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+{
+    return [[CHRParallelTimer alloc]initWithInterval:interval
+                                          shardCount:shardCount
+                                          shardBlock:shardBlock
+                                      executionQueue:executionQueue];
+}
+
+#pragma mark Using a Parallel Timer
+
+- (void)start:(BOOL)now
+{
+    [self validate];
+    
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateStopped)) == CHRTimerStateStopped) {
+        atomic_store_explicit(&_deadline, chr_now() + ((now)? 0 : chr_nanoseconds(_interval)), memory_order_relaxed);
+        chr_timer_start(_timer, now);
+        chr_state_end(&_state, CHRTimerStateRunning);
+    }
+}
+
+- (void)pause
+{
+    [self validate];
+    
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateRunning)) == CHRTimerStateRunning) {
+        chr_timer_pause(_timer);
+        chr_state_end(&_state, CHRTimerStateStopped);
+    }
+}
+
+- (void)cancel
+{
+    int32_t mask = CHR_STATE_MASK(CHRTimerStateStopped) | CHR_STATE_MASK(CHRTimerStateRunning);
+    if (chr_state_begin(&_state, mask) != CHRTimerStateTransitioning) {
+        chr_timer_cancel(_timer);
+        chr_state_end(&_state, CHRTimerStateInvalid);
+    }
+}
+
+- (CHRParallelTimerEventHandler)eventHandler
+{
+    __weak CHRParallelTimer *weak = self;
+    return ^(NSUInteger invocation, NSUInteger periods) {
+        CHRParallelTimer *strong = weak;
+        if (strong) {
+            [strong fireWithPeriods:periods];
+        }
+    };
+}
+
+/**
+ Processes every shard in parallel and waits for all of them. Runs on the
+ timer's serial tick queue, whose thread takes part in the work.
+ */
+- (void)fireWithPeriods:(NSUInteger)periods
+{
+    uint64_t start = chr_now();
+    // A tick queued before a pause may still run while -start: resets the
+    // deadline, only advance the deadline this tick read.
+    uint64_t deadline = atomic_load_explicit(&_deadline, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&_deadline, &deadline, deadline + periods * chr_nanoseconds(_interval),
+                                                  memory_order_relaxed, memory_order_relaxed));
+    
+    NSUInteger invocation = chr_counter_increment(&_invocations);
+    __weak CHRParallelTimer *weak = self;
+    CHRParallelTimerShardBlock shardBlock = _shardBlock;
+    dispatch_apply(_shardCount, _executionQueue, ^(size_t shard) {
+        shardBlock(weak, invocation, shard);
+    });
+    
+    uint64_t duration = chr_now() - start;
+    atomic_store_explicit(&_lastTickDuration, duration, memory_order_relaxed);
+    CHRTimerStatistics *statistics = _statistics;
+    if (statistics) {
+        uint64_t lateness = (start > deadline)? start - deadline : 0;
+        [statistics recordLateness:lateness duration:duration skipped:periods - 1];
+    }
+    CHRParallelTimerTickBlock tickBlock = _tickBlock;
+    if (tickBlock) {
+        tickBlock(weak, invocation, duration / (NSTimeInterval)NSEC_PER_SEC);
+    }
+}
+
+- (void)validate
+{
+    if (chr_state_load(&_state) == CHRTimerStateInvalid) {
+        @throw [NSException exceptionWithName:NSInternalInconsistencyException
+                                       reason:@"Attempting to use invalid CHRParallelTimer."
+                                     userInfo:nil];
+    }
+}
+
+#pragma mark Getters
+
+- (BOOL)isRunning
+{
+    return chr_state_load(&_state) == CHRTimerStateRunning;
+}
+
+- (BOOL)isValid
+{
+    return chr_state_load(&_state) != CHRTimerStateInvalid;
+}
+
+- (NSUInteger)invocations
+{
+    return chr_counter_load(&_invocations);
+}
+
+- (NSTimeInterval)lastTickDuration
+{
+    return atomic_load_explicit(&_lastTickDuration, memory_order_relaxed) / (NSTimeInterval)NSEC_PER_SEC;
+}
+
+@end
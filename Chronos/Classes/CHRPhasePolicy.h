@@ -0,0 +1,226 @@
+//
+//  CHRPhasePolicy.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - CHRSpreadRegistry Interface
+
+/**
+ The CHRSpreadRegistry class balances timers across the phases of their
+ interval.
+ 
+ The registry divides every interval into a fixed number of equally spaced
+ phase slots and counts the timers holding each slot, separately for each
+ interval. A timer acquiring a slot gets one of the least occupied ones,
+ preferring slots far from those already taken, so that the first few timers
+ land half, then a quarter, then an eighth of an interval apart, and large
+ numbers of timers end up evenly spread.
+ */
+@interface CHRSpreadRegistry : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Spread Registry
+// -----
+
+#pragma mark Creating a Spread Registry
+
+/**
+ Returns the registry used by balanced phase policies that are not given one,
+ with 64 slots per interval.
+ */
++ (CHRSpreadRegistry *)sharedRegistry;
+
+/**
+ Initializes a CHRSpreadRegistry object.
+ 
+ @param     slotCount
+            The number of phase slots per interval, rounded up to a power of
+            two.
+ @return    The newly initialized CHRSpreadRegistry object.
+ */
+- (instancetype)initWithSlotCount:(NSUInteger)slotCount NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRSpreadRegistry object.
+ 
+ @param     slotCount
+            The number of phase slots per interval, rounded up to a power of
+            two.
+ @return    The newly created CHRSpreadRegistry object.
+ */
++ (CHRSpreadRegistry *)registryWithSlotCount:(NSUInteger)slotCount;
+
+// -----
+// @name Acquiring Slots
+// -----
+
+#pragma mark Acquiring Slots
+
+/**
+ Acquires one of the least occupied slots of the given interval.
+ 
+ @param     interval
+            The interval of the timer, in seconds.
+ @return    The slot, to be released with releaseSlot:forInterval:.
+ */
+- (NSUInteger)acquireSlotForInterval:(NSTimeInterval)interval;
+
+/**
+ Releases a slot acquired for the given interval.
+ 
+ @param     slot
+            The slot returned by acquireSlotForInterval:.
+ @param     interval
+            The interval the slot was acquired for, in seconds.
+ */
+- (void)releaseSlot:(NSUInteger)slot forInterval:(NSTimeInterval)interval;
+
+/**
+ Returns the number of timers holding the given slot of the given interval.
+ 
+ @param     slot
+            The slot.
+ @param     interval
+            The interval, in seconds.
+ @return    The number of timers holding the slot.
+ */
+- (NSUInteger)countForSlot:(NSUInteger)slot interval:(NSTimeInterval)interval;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The number of phase slots per interval.
+ */
+@property (readonly) NSUInteger slotCount;
+
+@end
+
+
+#pragma mark - CHRPhasePolicy Interface
+
+/**
+ The CHRPhasePolicy class staggers the firings of timers that share an
+ interval, so that timers started together do not all fire at the same instant
+ of every period.
+ 
+ A timer given a phase policy delays its first firing by an offset between
+ zero and its interval, chosen when the timer first starts and kept until it is
+ canceled. A hashed policy derives the offset from a key, so that the same key
+ always gets the same phase, even across processes. A random policy picks the
+ offset at random. A balanced policy takes the least occupied phase slot of a
+ CHRSpreadRegistry, which spreads timers most evenly.
+ 
+ Policies are immutable and, except for hashed ones, meant to be shared
+ between timers.
+ */
+@interface CHRPhasePolicy : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Phase Policy
+// -----
+
+#pragma mark Creating a Phase Policy
+
+/**
+ Returns a policy deriving the offset from a key.
+ 
+ @param     key
+            The key, e.g. the identifier of the resource the timer polls.
+ @return    The phase policy.
+ */
++ (CHRPhasePolicy *)hashedPolicyWithKey:(NSString *)key;
+
+/**
+ Returns a policy choosing a random offset for each timer.
+ */
++ (CHRPhasePolicy *)randomPolicy;
+
+/**
+ Returns a policy balancing timers over the phase slots of the shared spread
+ registry.
+ */
++ (CHRPhasePolicy *)balancedPolicy;
+
+/**
+ Returns a policy balancing timers over the phase slots of a spread registry.
+ 
+ @param     registry
+            The spread registry.
+ @return    The phase policy.
+ */
++ (CHRPhasePolicy *)balancedPolicyWithRegistry:(CHRSpreadRegistry *)registry;
+
+// -----
+// @name Using a Phase Policy
+// -----
+
+#pragma mark Using a Phase Policy
+
+/**
+ Chooses the phase of a timer.
+ 
+ @param     interval
+            The timer's interval, in seconds.
+ @return    The offset of the timer's firings, in nanoseconds, less than the
+            interval.
+ */
+- (uint64_t)acquireOffsetForInterval:(NSTimeInterval)interval;
+
+/**
+ Gives back an offset once the timer no longer fires. Only balanced policies
+ keep track of offsets.
+ 
+ @param     offset
+            The offset returned by acquireOffsetForInterval:.
+ @param     interval
+            The timer's interval, in seconds.
+ */
+- (void)releaseOffset:(uint64_t)offset forInterval:(NSTimeInterval)interval;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The registry the receiver balances timers over, or nil if the receiver is not
+ a balanced policy.
+ */
+@property (readonly) CHRSpreadRegistry *registry;
+
+@end
@@ -0,0 +1,291 @@
+//
+//  CHRPhasePolicy.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRPhasePolicy.h"
+#import "CHRTimerInternal.h"
+#import <math.h>
+#import <pthread.h>
+#import <stdlib.h>
+
+
+#pragma mark - Type Definitions
+
+typedef NS_ENUM(NSInteger, CHRPhasePolicyKind) {
+    CHRPhasePolicyKindHashed,
+    CHRPhasePolicyKindRandom,
+    CHRPhasePolicyKindBalanced,
+};
+
+
+#pragma mark - Constants and Functions
+
+static const NSUInteger CHRSpreadRegistryDefaultSlotCount = 64;
+
+/**
+ Hashes the UTF-8 bytes of a string with 64 bit FNV-1a followed by the
+ SplitMix64 finalizer, which unlike -hash is stable across releases and
+ processes and spreads similar keys apart.
+ */
+static uint64_t chr_phaseHash(NSString *key) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char *byte = key.UTF8String; byte && *byte; ++byte) {
+        hash = (hash ^ (uint8_t)*byte) * 0x100000001b3ULL;
+    }
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+
+#pragma mark - CHRSpreadRegistry Class Extension
+
+@interface CHRSpreadRegistry () {
+    pthread_mutex_t         _lock;
+    NSUInteger              _shift;
+    NSUInteger              *_order;        // slots, each as far as possible from the earlier ones
+    NSMutableDictionary     *_counts;       // interval in nanoseconds -> slot counts followed by their total
+}
+
+@end
+
+
+#pragma mark - CHRSpreadRegistry Implementation
+
+@implementation CHRSpreadRegistry
+
+- (void)dealloc
+{
+    free(_order);
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Spread Registry
+
++ (CHRSpreadRegistry *)sharedRegistry
+{
+    static CHRSpreadRegistry *sharedRegistry = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedRegistry = [CHRSpreadRegistry registryWithSlotCount:CHRSpreadRegistryDefaultSlotCount];
+    });
+    return sharedRegistry;
+}
+
+- (instancetype)initWithSlotCount:(NSUInteger)slotCount
+{
+    if (self = [super init]) {
+        while (((NSUInteger)1 << _shift) < slotCount) {
+            _shift++;
+        }
+        _slotCount = (NSUInteger)1 << _shift;
+        _order = malloc(_slotCount * sizeof(NSUInteger));
+        for (NSUInteger i = 0; i < _slotCount; ++i) {
+            // Bit reversal visits 0, 1/2, 1/4, 3/4, 1/8... of the interval.
+            NSUInteger reversed = 0;
+            for (NSUInteger bit = 0; bit < _shift; ++bit) {
+                reversed |= ((i >> bit) & 1) << (_shift - 1 - bit);
+            }
+            _order[i] = reversed;
+        }
+        _counts = [NSMutableDictionary dictionary];
+        pthread_mutex_init(&_lock, NULL);
+    }
+    return self;
+}
+
++ (CHRSpreadRegistry *)registryWithSlotCount:(NSUInteger)slotCount
+{
+    return [[CHRSpreadRegistry alloc]initWithSlotCount:slotCount];
+}
+
+#pragma mark Acquiring Slots
+
+- (NSUInteger)acquireSlotForInterval:(NSTimeInterval)interval
+{
+    NSNumber *key = @(chr_nanoseconds(interval));
+    pthread_mutex_lock(&_lock);
+    NSMutableData *data = _counts[key];
+    if (!data) {
+        data = [NSMutableData dataWithLength:(_slotCount + 1) * sizeof(NSUInteger)];
+        _counts[key] = data;
+    }
+    NSUInteger *counts = data.mutableBytes;
+    NSUInteger slot = _order[0];
+    for (NSUInteger i = 1; i < _slotCount && counts[slot] > 0; ++i) {
+        if (counts[_order[i]] < counts[slot]) {
+            slot = _order[i];
+        }
+    }
+    counts[slot]++;
+    counts[_slotCount]++;
+    pthread_mutex_unlock(&_lock);
+    return slot;
+}
+
+- (void)releaseSlot:(NSUInteger)slot forInterval:(NSTimeInterval)interval
+{
+    NSNumber *key = @(chr_nanoseconds(interval));
+    pthread_mutex_lock(&_lock);
+    NSMutableData *data = _counts[key];
+    NSUInteger *counts = data.mutableBytes;
+    if (counts && slot < _slotCount && counts[slot] > 0) {
+        counts[slot]--;
+        if (--counts[_slotCount] == 0) {
+            [_counts removeObjectForKey:key];
+        }
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (NSUInteger)countForSlot:(NSUInteger)slot interval:(NSTimeInterval)interval
+{
+    NSNumber *key = @(chr_nanoseconds(interval));
+    pthread_mutex_lock(&_lock);
+    const NSUInteger *counts = [_counts[key] bytes];
+    NSUInteger count = (counts && slot < _slotCount)? counts[slot] : 0;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; slotCount = %lu>", [self class], self, (unsigned long)_slotCount];
+}
+
+@end
+
+
+#pragma mark - CHRPhasePolicy Class Extension
+
+@interface CHRPhasePolicy ()
+
+@property (readonly) CHRPhasePolicyKind kind;
+@property (readonly) uint64_t           hash64;
+
+@end
+
+
+#pragma mark - CHRPhasePolicy Implementation
+
+@implementation CHRPhasePolicy
+
+#pragma mark Creating a Phase Policy
+
+- (instancetype)initWithKind:(CHRPhasePolicyKind)kind hash:(uint64_t)hash registry:(CHRSpreadRegistry *)registry
+{
+    if (self = [super init]) {
+        _kind = kind;
+        _hash64 = hash;
+        _registry = registry;
+    }
+    return self;
+}
+
++ (CHRPhasePolicy *)hashedPolicyWithKey:(NSString *)key
+{
+    return [[CHRPhasePolicy alloc]initWithKind:CHRPhasePolicyKindHashed hash:chr_phaseHash(key) registry:nil];
+}
+
++ (CHRPhasePolicy *)randomPolicy
+{
+    static CHRPhasePolicy *randomPolicy = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        randomPolicy = [[CHRPhasePolicy alloc]initWithKind:CHRPhasePolicyKindRandom hash:0 registry:nil];
+    });
+    return randomPolicy;
+}
+
++ (CHRPhasePolicy *)balancedPolicy
+{
+    static CHRPhasePolicy *balancedPolicy = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        balancedPolicy = [CHRPhasePolicy balancedPolicyWithRegistry:[CHRSpreadRegistry sharedRegistry]];
+    });
+    return balancedPolicy;
+}
+
++ (CHRPhasePolicy *)balancedPolicyWithRegistry:(CHRSpreadRegistry *)registry
+{
+    return [[CHRPhasePolicy alloc]initWithKind:CHRPhasePolicyKindBalanced hash:0 registry:registry];
+}
+
+#pragma mark Using a Phase Policy
+
+- (uint64_t)acquireOffsetForInterval:(NSTimeInterval)interval
+{
+    uint64_t nanoseconds = chr_nanoseconds(interval);
+    if (nanoseconds == 0) {
+        return 0;
+    }
+    switch (_kind) {
+        case CHRPhasePolicyKindHashed: {
+            uint64_t offset = ((_hash64 >> 11) * 0x1.0p-53) * nanoseconds;
+            return MIN(offset, nanoseconds - 1);
+        }
+        case CHRPhasePolicyKindRandom:
+            return (((uint64_t)arc4random() << 32) | arc4random()) % nanoseconds;
+        case CHRPhasePolicyKindBalanced:
+        default: {
+            NSUInteger slotCount = _registry.slotCount;
+            NSUInteger slot = [_registry acquireSlotForInterval:interval];
+            return nanoseconds / slotCount * slot + nanoseconds % slotCount * slot / slotCount;
+        }
+    }
+}
+
+- (void)releaseOffset:(uint64_t)offset forInterval:(NSTimeInterval)interval
+{
+    uint64_t nanoseconds = chr_nanoseconds(interval);
+    if (_kind == CHRPhasePolicyKindBalanced && nanoseconds) {
+        // Offsets are slot fractions of the interval rounded down to the nanosecond.
+        NSUInteger slotCount = _registry.slotCount;
+        NSUInteger slot = (NSUInteger)llround((double)offset * slotCount / nanoseconds);
+        [_registry releaseSlot:MIN(slot, slotCount - 1) forInterval:interval];
+    }
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+    switch (_kind) {
+        case CHRPhasePolicyKindHashed:
+            return [NSString stringWithFormat:@"<%@: %p; hashed = %016llx>", [self class], self, _hash64];
+        case CHRPhasePolicyKindRandom:
+            return [NSString stringWithFormat:@"<%@: %p; random>", [self class], self];
+        case CHRPhasePolicyKindBalanced:
+        default:
+            return [NSString stringWithFormat:@"<%@: %p; balanced = %@>", [self class], self, _registry];
+    }
+}
+
+@end
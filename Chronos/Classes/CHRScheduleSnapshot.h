@@ -0,0 +1,162 @@
+//
+//  CHRScheduleSnapshot.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+
+
+#pragma mark - CHRScheduleSnapshot Interface
+
+/**
+ The CHRScheduleSnapshot class saves the schedules of a set of timers to a
+ compact binary file and restores them in a later process, so that timers
+ resume with their original phase and invocation counts instead of all
+ starting over, in lockstep, from start:.
+ 
+ A snapshot holds one fixed size record per timer with its next firing time on
+ the wall clock, the interval leading up to it, its invocation count and
+ whether it was running. The file is written and read through a memory
+ mapping, and timers are restored in parallel, so restoring tens of thousands
+ of timers takes milliseconds.
+ 
+ Timers are matched to records by their position in the array they were
+ written from: restore timers created in the same order. A restored timer
+ fires at its recorded time if that is still ahead, or else at the next time
+ in phase with its recorded interval; periods that elapsed while no process
+ ran the timer are neither executed nor counted. A variable timer's interval
+ provider is next asked for the interval following its restored invocation
+ count.
+ 
+ Snapshots store values in the byte order of the machine that wrote them and
+ are meant to be read back on the same machine.
+ */
+@interface CHRScheduleSnapshot : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Writing a Snapshot
+// -----
+
+#pragma mark Writing a Snapshot
+
+/**
+ Writes the schedules of the given timers to a file. The timers keep running;
+ the file is replaced atomically.
+ 
+ @param     timers
+            An array of CHRDispatchTimer and CHRVariableTimer objects. Other
+            objects get an empty record, so the positions of the timers after
+            them are preserved.
+ @param     path
+            The path of the file to write.
+ @param     error
+            On failure, the error that occurred. May be NULL.
+ @return    YES, if the file was written.
+ */
++ (BOOL)writeTimers:(NSArray *)timers toFile:(NSString *)path error:(NSError **)error;
+
+// -----
+// @name Reading a Snapshot
+// -----
+
+#pragma mark Reading a Snapshot
+
+/**
+ Initializes a CHRScheduleSnapshot object by mapping a snapshot file into
+ memory.
+ 
+ @param     path
+            The path of a file written by writeTimers:toFile:error:.
+ @param     error
+            On failure, the error that occurred. May be NULL.
+ @return    The newly initialized CHRScheduleSnapshot object, or nil if the
+            file could not be read or is not a snapshot.
+ */
+- (instancetype)initWithContentsOfFile:(NSString *)path error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRScheduleSnapshot object by mapping a snapshot
+ file into memory.
+ 
+ @param     path
+            The path of a file written by writeTimers:toFile:error:.
+ @param     error
+            On failure, the error that occurred. May be NULL.
+ @return    The newly created CHRScheduleSnapshot object, or nil if the file
+            could not be read or is not a snapshot.
+ */
++ (CHRScheduleSnapshot *)snapshotWithContentsOfFile:(NSString *)path error:(NSError **)error;
+
+// -----
+// @name Restoring Timers
+// -----
+
+#pragma mark Restoring Timers
+
+/**
+ Restores the timers at the given positions from the records at the same
+ positions. Timers that are running or canceled, that have no record, or
+ whose class does not match their record's are left untouched.
+ 
+ @param     timers
+            An array of CHRDispatchTimer and CHRVariableTimer objects, in the
+            order the snapshot was written in.
+ @return    The number of timers restored.
+ */
+- (NSUInteger)restoreTimers:(NSArray *)timers;
+
+/**
+ Restores a timer from a single record.
+ 
+ @param     timer
+            A stopped CHRDispatchTimer or CHRVariableTimer object.
+ @param     index
+            The position of the record in the snapshot.
+ @return    YES, if the timer was restored.
+ */
+- (BOOL)restoreTimer:(id<CHRRepeatingTimer>)timer atIndex:(NSUInteger)index;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The number of records in the receiver.
+ */
+@property (readonly) NSUInteger count;
+
+/**
+ The time at which the receiver was written.
+ */
+@property (readonly) NSDate *date;
+
+@end
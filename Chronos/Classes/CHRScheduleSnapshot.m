@@ -0,0 +1,318 @@
+//
+//  CHRScheduleSnapshot.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRScheduleSnapshot.h"
+#import "CHRScheduleSnapshotInternal.h"
+#import "CHRTimerInternal.h"
+#import <fcntl.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <unistd.h>
+
+
+#pragma mark - Type Definitions
+
+typedef NS_OPTIONS(uint32_t, CHRScheduleRecordFlags) {
+    CHRScheduleRecordFlagDispatchTimer  = 1 << 0,
+    CHRScheduleRecordFlagVariableTimer  = 1 << 1,
+    CHRScheduleRecordFlagRunning        = 1 << 2,
+};
+
+/**
+ The start of a snapshot file, followed by count records.
+ */
+typedef struct chr_snapshot_header_s {
+    uint32_t    magic;
+    uint32_t    version;
+    uint64_t    count;
+    int64_t     time;           // nanoseconds since 1970
+    uint64_t    reserved;
+} chr_snapshot_header_t;
+
+/**
+ The schedule of a single timer. An empty record has no flags set.
+ */
+typedef struct chr_snapshot_record_s {
+    int64_t     deadline;       // nanoseconds since 1970
+    uint64_t    interval;       // nanoseconds
+    uint64_t    invocations;
+    uint32_t    flags;          // CHRScheduleRecordFlags
+    uint32_t    reserved;
+} chr_snapshot_record_t;
+
+
+#pragma mark - Constants and Functions
+
+static const uint32_t CHRScheduleSnapshotMagic = 0x53524843;    // "CHRS" in little endian
+static const uint32_t CHRScheduleSnapshotVersion = 1;
+
+/**
+ The number of timers each iteration of a parallel write or restore handles,
+ large enough to amortize the cost of dispatching the iteration.
+ */
+static const NSUInteger CHRScheduleSnapshotApplyStride = 1024;
+
+/**
+ Returns the wall clock time, in nanoseconds since 1970. Unlike chr_now(), it
+ is comparable across processes and restarts.
+ */
+static inline int64_t chr_wallNow(void) {
+    return (int64_t)((CFAbsoluteTimeGetCurrent() + kCFAbsoluteTimeIntervalSince1970) * NSEC_PER_SEC);
+}
+
+/**
+ Returns the record flag matching the class of the given timer, or 0 if the
+ timer cannot be snapshotted.
+ */
+static inline uint32_t chr_snapshotKind(id timer) {
+    if ([timer isKindOfClass:[CHRDispatchTimer class]]) {
+        return CHRScheduleRecordFlagDispatchTimer;
+    }
+    if ([timer isKindOfClass:[CHRVariableTimer class]]) {
+        return CHRScheduleRecordFlagVariableTimer;
+    }
+    return 0;
+}
+
+/**
+ Returns the delay until the first firing of a restored timer: the time left
+ until its recorded deadline, or until the next deadline in phase with it if
+ the recorded one has passed.
+ */
+static inline uint64_t chr_snapshotDelay(int64_t deadline, uint64_t interval, int64_t now) {
+    if (deadline >= now) {
+        return deadline - now;
+    }
+    uint64_t late = (interval)? (uint64_t)(now - deadline) % interval : 0;
+    return (late)? interval - late : 0;
+}
+
+/**
+ Sets the error, if requested, and returns NO.
+ */
+static BOOL chr_snapshotFail(NSError **error, NSString *domain, NSInteger code, NSString *path) {
+    if (error) {
+        *error = [NSError errorWithDomain:domain code:code userInfo:@{NSFilePathErrorKey: path}];
+    }
+    return NO;
+}
+
+/**
+ Calls the block with every index below count, in parallel strides.
+ */
+static void chr_snapshotApply(NSUInteger count, void (^block)(NSUInteger index)) {
+    size_t strides = (count + CHRScheduleSnapshotApplyStride - 1) / CHRScheduleSnapshotApplyStride;
+    dispatch_apply(strides, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t stride) {
+        NSUInteger end = MIN((stride + 1) * CHRScheduleSnapshotApplyStride, count);
+        for (NSUInteger i = stride * CHRScheduleSnapshotApplyStride; i < end; ++i) {
+            block(i);
+        }
+    });
+}
+
+
+#pragma mark - CHRScheduleSnapshot Class Extension
+
+@interface CHRScheduleSnapshot () {
+    void                            *_map;
+    size_t                          _size;
+    const chr_snapshot_record_t     *_records;
+}
+
+@end
+
+
+#pragma mark - CHRScheduleSnapshot Implementation
+
+@implementation CHRScheduleSnapshot
+
+- (void)dealloc
+{
+    if (_map) {
+        munmap(_map, _size);
+    }
+}
+
+#pragma mark Writing a Snapshot
+
++ (BOOL)writeTimers:(NSArray *)timers toFile:(NSString *)path error:(NSError **)error
+{
+    NSUInteger count = timers.count;
+    size_t size = sizeof(chr_snapshot_header_t) + count * sizeof(chr_snapshot_record_t);
+    NSString *temporaryPath = [path stringByAppendingFormat:@".%d.tmp", getpid()];
+    
+    int fd = open(temporaryPath.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return chr_snapshotFail(error, NSPOSIXErrorDomain, errno, path);
+    }
+    void *map = (ftruncate(fd, size) == 0)? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    int code = errno;
+    close(fd);
+    if (map == MAP_FAILED) {
+        unlink(temporaryPath.fileSystemRepresentation);
+        return chr_snapshotFail(error, NSPOSIXErrorDomain, code, path);
+    }
+    
+    int64_t now = chr_wallNow();
+    chr_snapshot_header_t *header = map;
+    chr_snapshot_record_t *records = (chr_snapshot_record_t *)(header + 1);
+    chr_snapshotApply(count, ^(NSUInteger index) {
+        id<CHRScheduleSnapshotting> timer = timers[index];
+        chr_snapshot_record_t *record = &records[index];
+        uint32_t kind = chr_snapshotKind(timer);
+        if (kind) {
+            int64_t delay;
+            uint64_t interval;
+            NSUInteger invocations;
+            BOOL running = [timer getScheduleDelay:&delay interval:&interval invocations:&invocations];
+            *record = (chr_snapshot_record_t) {
+                .deadline = now + delay,
+                .interval = interval,
+                .invocations = invocations,
+                .flags = kind | ((running)? CHRScheduleRecordFlagRunning : 0),
+            };
+        }
+    });
+    *header = (chr_snapshot_header_t) {
+        .magic = CHRScheduleSnapshotMagic,
+        .version = CHRScheduleSnapshotVersion,
+        .count = count,
+        .time = now,
+    };
+    
+    BOOL written = (msync(map, size, MS_SYNC) == 0);
+    code = errno;
+    munmap(map, size);
+    if (written && rename(temporaryPath.fileSystemRepresentation, path.fileSystemRepresentation) != 0) {
+        written = NO;
+        code = errno;
+    }
+    if (!written) {
+        unlink(temporaryPath.fileSystemRepresentation);
+        return chr_snapshotFail(error, NSPOSIXErrorDomain, code, path);
+    }
+    return YES;
+}
+
+#pragma mark Reading a Snapshot
+
+- (instancetype)initWithContentsOfFile:(NSString *)path error:(NSError **)error
+{
+    if (self = [super init]) {
+        int fd = open(path.fileSystemRepresentation, O_RDONLY);
+        if (fd < 0) {
+            chr_snapshotFail(error, NSPOSIXErrorDomain, errno, path);
+            return nil;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            chr_snapshotFail(error, NSPOSIXErrorDomain, errno, path);
+            close(fd);
+            return nil;
+        }
+        size_t size = (size_t)info.st_size;
+        if (size < sizeof(chr_snapshot_header_t)) {
+            chr_snapshotFail(error, NSCocoaErrorDomain, NSFileReadCorruptFileError, path);
+            close(fd);
+            return nil;
+        }
+        void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        int code = errno;
+        close(fd);
+        if (map == MAP_FAILED) {
+            chr_snapshotFail(error, NSPOSIXErrorDomain, code, path);
+            return nil;
+        }
+        
+        const chr_snapshot_header_t *header = map;
+        size_t capacity = (size - sizeof(chr_snapshot_header_t)) / sizeof(chr_snapshot_record_t);
+        if (header->magic != CHRScheduleSnapshotMagic ||
+            header->version != CHRScheduleSnapshotVersion ||
+            header->count > capacity) {
+            munmap(map, size);
+            chr_snapshotFail(error, NSCocoaErrorDomain, NSFileReadCorruptFileError, path);
+            return nil;
+        }
+        _map = map;
+        _size = size;
+        _records = (const chr_snapshot_record_t *)(header + 1);
+        _count = (NSUInteger)header->count;
+        _date = [NSDate dateWithTimeIntervalSince1970:(NSTimeInterval)header->time / NSEC_PER_SEC];
+    }
+    return self;
+}
+
++ (CHRScheduleSnapshot *)snapshotWithContentsOfFile:(NSString *)path error:(NSError **)error
+{
+    return [[CHRScheduleSnapshot alloc]initWithContentsOfFile:path error:error];
+}
+
+#pragma mark Restoring Timers
+
+- (NSUInteger)restoreTimers:(NSArray *)timers
+{
+    NSUInteger count = MIN(timers.count, _count);
+    int64_t now = chr_wallNow();
+    chr_counter_t restored = 0;
+    chr_counter_t *total = &restored;
+    chr_snapshotApply(count, ^(NSUInteger index) {
+        if ([self restoreTimer:timers[index] record:&_records[index] now:now]) {
+            atomic_fetch_add_explicit(total, 1, memory_order_relaxed);
+        }
+    });
+    return chr_counter_load(&restored);
+}
+
+- (BOOL)restoreTimer:(id<CHRRepeatingTimer>)timer atIndex:(NSUInteger)index
+{
+    if (index >= _count) {
+        return NO;
+    }
+    return [self restoreTimer:timer record:&_records[index] now:chr_wallNow()];
+}
+
+#pragma mark Private
+
+/**
+ Restores a timer from the given record, if the timer is stopped and matches
+ the record.
+ */
+- (BOOL)restoreTimer:(id<CHRRepeatingTimer>)timer record:(const chr_snapshot_record_t *)record now:(int64_t)now
+{
+    uint32_t kind = chr_snapshotKind(timer);
+    if (!kind || !(record->flags & kind) || !timer.isValid) {
+        return NO;
+    }
+    BOOL running = (record->flags & CHRScheduleRecordFlagRunning) != 0;
+    return [(id<CHRScheduleSnapshotting>)timer restoreInvocations:(NSUInteger)record->invocations
+                                                             delay:chr_snapshotDelay(record->deadline, record->interval, now)
+                                                          interval:record->interval
+                                                           running:running];
+}
+
+@end
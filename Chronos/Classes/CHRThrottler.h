@@ -0,0 +1,160 @@
+//
+//  CHRThrottler.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - CHRThrottler Interface
+
+/**
+ The CHRThrottler class limits a stream of signals to at most one execution of a
+ block per interval, however often the signals arrive.
+ 
+ A throttler owns a single dispatch source for its whole lifetime and re-arms
+ it at most once per interval, so signaling is lock-free and does not allocate.
+ It is suitable for rate limiting work driven by noisy events, such as progress
+ updates or UI refreshes.
+ */
+@interface CHRThrottler : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Throttler
+// -----
+
+#pragma mark Creating a Throttler
+
+/**
+ Initializes a CHRThrottler object.
+ 
+ The execution block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool.
+ 
+ @param     interval
+            The minimum time between two executions, in seconds.
+ @param     executionBlock
+            The block to execute.
+ @return    The newly initialized CHRThrottler object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(dispatch_block_t)executionBlock;
+
+/**
+ Initializes a CHRThrottler object.
+ 
+ @param     interval
+            The minimum time between two executions, in seconds.
+ @param     executionBlock
+            The block to execute.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @return    The newly initialized CHRThrottler object.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(dispatch_block_t)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRThrottler object.
+ 
+ @param     interval
+            The minimum time between two executions, in seconds.
+ @param     executionBlock
+            The block to execute.
+ @return    The newly created CHRThrottler object.
+ */
++ (CHRThrottler *)throttlerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(dispatch_block_t)executionBlock;
+
+/**
+ Creates and initializes a new CHRThrottler object.
+ 
+ @param     interval
+            The minimum time between two executions, in seconds.
+ @param     executionBlock
+            The block to execute.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @return    The newly created CHRThrottler object.
+ */
++ (CHRThrottler *)throttlerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(dispatch_block_t)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue;
+
+// -----
+// @name Using a Throttler
+// -----
+
+#pragma mark Using a Throttler
+
+/**
+ Records an event. Safe to call from any thread.
+ */
+- (void)signal;
+
+/**
+ Permanently cancels the throttler. Pending executions are dropped and later
+ signals are ignored.
+ */
+- (void)cancel;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The minimum time between two executions, in seconds.
+ */
+@property (readonly) NSTimeInterval interval;
+
+/**
+ YES, if a signal received while the throttler is idle executes the block
+ immediately. Defaults to YES. Set this property before the first signal.
+ */
+@property (nonatomic, getter=isLeading) BOOL leading;
+
+/**
+ YES, if signals received during an interval execute the block once that
+ interval ends. Defaults to YES. Set this property before the first signal.
+ */
+@property (nonatomic, getter=isTrailing) BOOL trailing;
+
+/**
+ The queue that executes the execution block.
+ */
+@property (readonly) dispatch_queue_t executionQueue;
+
+/**
+ YES, if the throttler has not been canceled.
+ */
+@property (atomic, readonly, getter=isValid) BOOL valid;
+
+@end
@@ -0,0 +1,186 @@
+//
+//  CHRThrottler.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRThrottler.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRTimerInternal.h"
+
+
+#pragma mark - CHRThrottler Class Extension
+
+@interface CHRThrottler () {
+    atomic_bool         _pending;       // a signal has not been executed yet
+    atomic_bool         _armed;         // an interval is in progress and owns the source
+    atomic_bool         _canceled;
+}
+
+@property (readonly) dispatch_source_t timer;
+@property (readonly) dispatch_block_t executionBlock;
+
+@end
+
+
+#pragma mark - CHRThrottler Implementation
+
+@implementation CHRThrottler
+
+- (void)dealloc
+{
+    [self cancel];
+}
+
+#pragma mark Creating a Throttler
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(dispatch_block_t)executionBlock
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
+    return [self initWithInterval:interval
+                   executionBlock:executionBlock
+                   executionQueue:executionQueue];
+}
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                  executionBlock:(dispatch_block_t)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+{
+    if (self = [super init]) {
+        _executionQueue = executionQueue;
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _executionQueue);
+        if (!_timer) {
+            NSLog(@"%@", @"Failed to create dispatch source for throttler.");
+            return nil;
+        }
+        _interval = interval;
+        _executionBlock = [executionBlock copy];
+        _leading = YES;
+        _trailing = YES;
+        __weak CHRThrottler *weak = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weak fire];
+        });
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_timer);
+    }
+    return self;
+}
+
++ (CHRThrottler *)throttlerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(dispatch_block_t)executionBlock
+{
+    return [[CHRThrottler alloc]initWithInterval:interval
+                                  executionBlock:executionBlock];
+}
+
++ (CHRThrottler *)throttlerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(dispatch_block_t)executionBlock
+                         executionQueue:(dispatch_queue_t)executionQueue
+{
+    return [[CHRThrottler alloc]initWithInterval:interval
+                                  executionBlock:executionBlock
+                                  executionQueue:executionQueue];
+}
+
+#pragma mark Using a Throttler
+
+- (void)signal
+{
+    if (atomic_load_explicit(&_canceled, memory_order_relaxed)) {
+        return;
+    }
+    // Sequentially consistent with the check of _pending in -fire, so either the
+    // handler sees this signal or this call sees the throttler idle.
+    atomic_store(&_pending, true);
+    if (!atomic_load(&_armed)) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&_armed, &expected, true)) {
+            [self beginInterval];
+        }
+    }
+}
+
+- (void)cancel
+{
+    bool expected = false;
+    if (atomic_compare_exchange_strong(&_canceled, &expected, true)) {
+        dispatch_source_cancel(_timer);
+    }
+}
+
+#pragma mark Private
+
+/**
+ Starts an interval. Called by whichever thread moved the throttler from idle
+ to armed, which then owns the source until the interval ends.
+ */
+- (void)beginInterval
+{
+    if (_leading && atomic_exchange(&_pending, false)) {
+        dispatch_async(_executionQueue, _executionBlock);
+    }
+    [self arm];
+}
+
+- (void)arm
+{
+    dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, chr_nanoseconds(_interval)), DISPATCH_TIME_FOREVER, chr_leeway(_interval));
+}
+
+/**
+ Runs on the execution queue when an interval ends. Signals received during the
+ interval execute the block and start the next interval, otherwise the
+ throttler goes idle.
+ */
+- (void)fire
+{
+    if (atomic_load_explicit(&_canceled, memory_order_relaxed)) {
+        return;
+    }
+    if (atomic_exchange(&_pending, false) && _trailing) {
+        _executionBlock();
+        [self arm];
+        return;
+    }
+    
+    atomic_store(&_armed, false);
+    if (atomic_load(&_pending)) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&_armed, &expected, true)) {
+            [self beginInterval];
+        }
+    }
+}
+
+#pragma mark Getters
+
+- (BOOL)isValid
+{
+    return !atomic_load(&_canceled);
+}
+
+@end
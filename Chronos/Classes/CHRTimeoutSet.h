@@ -0,0 +1,178 @@
+//
+//  CHRTimeoutSet.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - Type Definitions
+
+/**
+ Identifies a timeout added to a CHRTimeoutSet. Tokens are never reused while
+ the timeout they identify is pending, and CHRTimeoutTokenNone is never
+ returned for a pending timeout.
+ */
+typedef uint64_t CHRTimeoutToken;
+
+static const CHRTimeoutToken CHRTimeoutTokenNone = 0;
+
+
+#pragma mark - CHRTimeoutSet Interface
+
+/**
+ The CHRTimeoutSet class manages large numbers of one-shot deadlines, such as
+ per-request timeouts, that are usually canceled before they expire.
+ 
+ Adding and canceling a timeout takes constant time and does not create a
+ dispatch source or, for function timeouts, allocate memory. Timeouts are kept
+ in a hashed timing wheel driven by a single internal timer source, which only
+ wakes up while the set holds at least one pending timeout. Canceling a timeout
+ returns its storage to the set immediately.
+ 
+ Expirations are rounded up to the resolution of the set.
+ */
+@interface CHRTimeoutSet : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Timeout Set
+// -----
+
+#pragma mark Creating a Timeout Set
+
+/**
+ Initializes a CHRTimeoutSet object.
+ 
+ Handlers will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool.
+ 
+ @param     resolution
+            The duration of a single tick of the set, in seconds.
+ @return    The newly initialized CHRTimeoutSet object.
+ */
+- (instancetype)initWithResolution:(NSTimeInterval)resolution;
+
+/**
+ Initializes a CHRTimeoutSet object.
+ 
+ @param     resolution
+            The duration of a single tick of the set, in seconds.
+ @param     executionQueue
+            The queue that should execute the handlers of expired timeouts.
+ @return    The newly initialized CHRTimeoutSet object.
+ */
+- (instancetype)initWithResolution:(NSTimeInterval)resolution
+                    executionQueue:(dispatch_queue_t)executionQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRTimeoutSet object.
+ 
+ @param     resolution
+            The duration of a single tick of the set, in seconds.
+ @return    The newly created CHRTimeoutSet object.
+ */
++ (CHRTimeoutSet *)timeoutSetWithResolution:(NSTimeInterval)resolution;
+
+/**
+ Creates and initializes a new CHRTimeoutSet object.
+ 
+ @param     resolution
+            The duration of a single tick of the set, in seconds.
+ @param     executionQueue
+            The queue that should execute the handlers of expired timeouts.
+ @return    The newly created CHRTimeoutSet object.
+ */
++ (CHRTimeoutSet *)timeoutSetWithResolution:(NSTimeInterval)resolution
+                             executionQueue:(dispatch_queue_t)executionQueue;
+
+// -----
+// @name Managing Timeouts
+// -----
+
+#pragma mark Managing Timeouts
+
+/**
+ Adds a one-shot timeout.
+ 
+ @param     timeout
+            The time after which the handler is executed, in seconds.
+ @param     handler
+            The block to execute when the timeout expires.
+ @return    A token that can be used to cancel the timeout.
+ */
+- (CHRTimeoutToken)addTimeout:(NSTimeInterval)timeout handler:(dispatch_block_t)handler;
+
+/**
+ Adds a one-shot timeout that calls a function when it expires. Unlike
+ addTimeout:handler:, this does not copy a block.
+ 
+ @param     timeout
+            The time after which the function is called, in seconds.
+ @param     function
+            The function to call when the timeout expires.
+ @param     context
+            The argument passed to the function. The set does not retain or
+            free the context.
+ @return    A token that can be used to cancel the timeout.
+ */
+- (CHRTimeoutToken)addTimeout:(NSTimeInterval)timeout
+                     function:(dispatch_function_t)function
+                      context:(void *)context;
+
+/**
+ Cancels a pending timeout.
+ 
+ @param     token
+            The token returned when the timeout was added.
+ @return    YES, if the timeout was pending and will not execute. NO, if it has
+            already expired or been canceled.
+ */
+- (BOOL)cancelTimeout:(CHRTimeoutToken)token;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The duration of a single tick of the receiver, in seconds.
+ */
+@property (readonly) NSTimeInterval resolution;
+
+/**
+ The queue that executes the handlers of expired timeouts.
+ */
+@property (readonly) dispatch_queue_t executionQueue;
+
+/**
+ The number of timeouts that are pending on the receiver.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+@end
@@ -0,0 +1,333 @@
+//
+//  CHRTimeoutSet.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimeoutSet.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRTimerInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - Constants and Functions
+
+static NSString * const CHRTimeoutSetQueueNamePrefix = @"com.chronus.CHRTimeoutSet";
+
+#define CHR_TIMEOUT_SLOTS       4096
+#define CHR_TIMEOUT_SLOT_MASK   (CHR_TIMEOUT_SLOTS - 1)
+#define CHR_TIMEOUT_NIL         UINT32_MAX
+
+typedef struct chr_timeout_entry_s *chr_timeout_entry_t;
+
+struct chr_timeout_entry_s {
+    uint64_t            deadline;   // absolute tick
+    dispatch_function_t function;
+    void                *context;
+    uint32_t            next;       // next entry in the slot or free list
+    uint32_t            prev;       // previous entry in the slot, CHR_TIMEOUT_NIL at the head
+    uint32_t            generation;
+    bool                pending;
+    bool                ownsContext;    // context is a retained dispatch_block_t
+};
+
+static void chr_timeoutInvokeBlock(void *context) {
+    dispatch_block_t handler = CFBridgingRelease(context);
+    handler();
+}
+
+static inline CHRTimeoutToken chr_timeoutToken(uint32_t index, uint32_t generation) {
+    return ((uint64_t)generation << 32) | (index + 1);
+}
+
+
+#pragma mark - CHRTimeoutSet Class Extension
+
+@interface CHRTimeoutSet () {
+    pthread_mutex_t     _lock;
+    uint64_t            _tick;          // nanoseconds per tick
+    uint64_t            _origin;        // chr_now() at tick 0
+    uint64_t            _current;       // last processed tick
+    chr_timeout_entry_t _entries;
+    uint32_t            _capacity;
+    uint32_t            _free;          // head of the free list
+    uint32_t            _slots[CHR_TIMEOUT_SLOTS];
+    NSUInteger          _count;
+    bool                _ticking;
+}
+
+@property (readonly) dispatch_queue_t   queue;
+@property (readonly) dispatch_source_t  timer;
+
+@end
+
+
+#pragma mark - CHRTimeoutSet Implementation
+
+@implementation CHRTimeoutSet
+
+- (void)dealloc
+{
+    if (!_ticking) {
+        dispatch_resume(_timer);
+    }
+    dispatch_source_cancel(_timer);
+    for (uint32_t i = 0; i < _capacity; ++i) {
+        if (_entries[i].pending && _entries[i].ownsContext) {
+            CFRelease(_entries[i].context);
+        }
+    }
+    free(_entries);
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Timeout Set
+
+- (instancetype)initWithResolution:(NSTimeInterval)resolution
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
+    return [self initWithResolution:resolution executionQueue:executionQueue];
+}
+
+- (instancetype)initWithResolution:(NSTimeInterval)resolution
+                    executionQueue:(dispatch_queue_t)executionQueue
+{
+    if (self = [super init]) {
+        NSString *queueName = [NSString stringWithFormat:@"%@.%p", CHRTimeoutSetQueueNamePrefix, self];
+        _queue = dispatch_queue_create([queueName UTF8String], DISPATCH_QUEUE_SERIAL);
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+        if (!_timer) {
+            NSLog(@"%@", @"Failed to create dispatch source for timeout set.");
+            return nil;
+        }
+        pthread_mutex_init(&_lock, NULL);
+        _executionQueue = executionQueue;
+        _resolution = resolution;
+        _tick = MAX(chr_nanoseconds(resolution), 1);
+        _origin = chr_now();
+        _free = CHR_TIMEOUT_NIL;
+        memset(_slots, 0xff, sizeof(_slots));
+        __weak CHRTimeoutSet *weak = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weak advance];
+        });
+    }
+    return self;
+}
+
++ (CHRTimeoutSet *)timeoutSetWithResolution:(NSTimeInterval)resolution
+{
+    return [[CHRTimeoutSet alloc]initWithResolution:resolution];
+}
+
++ (CHRTimeoutSet *)timeoutSetWithResolution:(NSTimeInterval)resolution
+                             executionQueue:(dispatch_queue_t)executionQueue
+{
+    return [[CHRTimeoutSet alloc]initWithResolution:resolution executionQueue:executionQueue];
+}
+
+#pragma mark Managing Timeouts
+
+- (CHRTimeoutToken)addTimeout:(NSTimeInterval)timeout handler:(dispatch_block_t)handler
+{
+    void *context = (__bridge_retained void *)[handler copy];
+    return [self addTimeout:timeout function:chr_timeoutInvokeBlock context:context ownsContext:YES];
+}
+
+- (CHRTimeoutToken)addTimeout:(NSTimeInterval)timeout
+                     function:(dispatch_function_t)function
+                      context:(void *)context
+{
+    return [self addTimeout:timeout function:function context:context ownsContext:NO];
+}
+
+- (BOOL)cancelTimeout:(CHRTimeoutToken)token
+{
+    uint32_t index = (uint32_t)(token & UINT32_MAX) - 1;
+    uint32_t generation = (uint32_t)(token >> 32);
+    void *released = NULL;
+    
+    pthread_mutex_lock(&_lock);
+    BOOL canceled = (token != CHRTimeoutTokenNone &&
+                     index < _capacity &&
+                     _entries[index].generation == generation &&
+                     _entries[index].pending);
+    if (canceled) {
+        if (_entries[index].ownsContext) {
+            released = _entries[index].context;
+        }
+        [self unlinkEntry:index];
+        [self releaseEntry:index];
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    if (released) {
+        CFRelease(released);
+    }
+    return canceled;
+}
+
+#pragma mark Private
+
+- (CHRTimeoutToken)addTimeout:(NSTimeInterval)timeout
+                     function:(dispatch_function_t)function
+                      context:(void *)context
+                  ownsContext:(BOOL)ownsContext
+{
+    uint64_t delay = chr_nanoseconds(MAX(timeout, 0));
+    
+    pthread_mutex_lock(&_lock);
+    uint64_t now = chr_now() - _origin;
+    if (_count == 0) {
+        _current = now / _tick;
+    }
+    uint32_t index = [self allocateEntry];
+    chr_timeout_entry_t entry = &_entries[index];
+    entry->deadline = MAX((now + delay + _tick - 1) / _tick, _current + 1);
+    entry->function = function;
+    entry->context = context;
+    entry->ownsContext = ownsContext;
+    entry->pending = true;
+    
+    uint32_t *slot = &_slots[entry->deadline & CHR_TIMEOUT_SLOT_MASK];
+    entry->next = *slot;
+    entry->prev = CHR_TIMEOUT_NIL;
+    if (*slot != CHR_TIMEOUT_NIL) {
+        _entries[*slot].prev = index;
+    }
+    *slot = index;
+    if (_count++ == 0 && !_ticking) {
+        _ticking = true;
+        dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, _tick), _tick, chr_leeway(_resolution));
+        dispatch_resume(_timer);
+    }
+    CHRTimeoutToken token = chr_timeoutToken(index, entry->generation);
+    pthread_mutex_unlock(&_lock);
+    return token;
+}
+
+/**
+ Returns the index of an unused entry, growing the entry storage if necessary.
+ Must be called with the lock held.
+ */
+- (uint32_t)allocateEntry
+{
+    if (_free == CHR_TIMEOUT_NIL) {
+        uint32_t capacity = MAX(_capacity * 2, 64);
+        _entries = realloc(_entries, capacity * sizeof(struct chr_timeout_entry_s));
+        memset(_entries + _capacity, 0, (capacity - _capacity) * sizeof(struct chr_timeout_entry_s));
+        for (uint32_t i = capacity; i > _capacity; --i) {
+            _entries[i - 1].next = _free;
+            _free = i - 1;
+        }
+        _capacity = capacity;
+    }
+    uint32_t index = _free;
+    _free = _entries[index].next;
+    return index;
+}
+
+/**
+ Unlinks a pending entry from its slot. Must be called with the lock held.
+ */
+- (void)unlinkEntry:(uint32_t)index
+{
+    chr_timeout_entry_t entry = &_entries[index];
+    if (entry->prev == CHR_TIMEOUT_NIL) {
+        _slots[entry->deadline & CHR_TIMEOUT_SLOT_MASK] = entry->next;
+    } else {
+        _entries[entry->prev].next = entry->next;
+    }
+    if (entry->next != CHR_TIMEOUT_NIL) {
+        _entries[entry->next].prev = entry->prev;
+    }
+}
+
+/**
+ Returns an unlinked entry to the free list, invalidating any token that refers
+ to it. Must be called with the lock held.
+ */
+- (void)releaseEntry:(uint32_t)index
+{
+    chr_timeout_entry_t entry = &_entries[index];
+    entry->pending = false;
+    entry->context = NULL;
+    entry->generation++;
+    entry->next = _free;
+    _free = index;
+    _count--;
+}
+
+/**
+ Fires the entries of the given slot whose deadline is at or before the given
+ tick. Entries due in a later rotation of the wheel are left in place. Must be
+ called with the lock held.
+ */
+- (void)expireSlot:(uint32_t)slot through:(uint64_t)tick
+{
+    uint32_t index = _slots[slot];
+    while (index != CHR_TIMEOUT_NIL) {
+        chr_timeout_entry_t entry = &_entries[index];
+        uint32_t next = entry->next;
+        if (entry->deadline <= tick) {
+            dispatch_async_f(_executionQueue, entry->context, entry->function);
+            [self unlinkEntry:index];
+            [self releaseEntry:index];
+        }
+        index = next;
+    }
+}
+
+/**
+ Processes every tick that has elapsed since the last call. Runs on the set's
+ queue.
+ */
+- (void)advance
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t target = (chr_now() - _origin) / _tick;
+    uint64_t steps = (target > _current)? MIN(target - _current, CHR_TIMEOUT_SLOTS) : 0;
+    for (uint64_t step = 1; step <= steps; ++step) {
+        [self expireSlot:(_current + step) & CHR_TIMEOUT_SLOT_MASK through:target];
+    }
+    _current = MAX(_current, target);
+    if (_count == 0 && _ticking) {
+        _ticking = false;
+        dispatch_suspend(_timer);
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark Getters
+
+- (NSUInteger)count
+{
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _count;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+@end
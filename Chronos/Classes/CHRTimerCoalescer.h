@@ -0,0 +1,97 @@
+//
+//  CHRTimerCoalescer.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRTimerScheduler.h"
+
+
+#pragma mark - CHRTimerCoalescer Interface
+
+/**
+ The CHRTimerCoalescer class batches the firings of many timers into as few
+ wakeups as their leeways allow.
+ 
+ Every timer driven by a coalescer may fire anywhere between its deadline and
+ its deadline plus its leeway. The coalescer drives a single dispatch source
+ that wakes up at the earliest end of those windows and fires, in one pass,
+ every timer whose deadline has passed by then. Timers whose windows overlap
+ therefore share a wakeup.
+ 
+ To opt a timer in, pass a coalescer as the scheduler of a CHRDispatchTimer or
+ CHRVariableTimer.
+ */
+@interface CHRTimerCoalescer : NSObject <CHRTimerScheduler>
+
+// -----
+// @name Creating a Timer Coalescer
+// -----
+
+#pragma mark Creating a Timer Coalescer
+
+/**
+ Initializes a CHRTimerCoalescer object.
+ 
+ @return    The newly initialized CHRTimerCoalescer object.
+ */
+- (instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRTimerCoalescer object.
+ 
+ @return    The newly created CHRTimerCoalescer object.
+ */
++ (CHRTimerCoalescer *)coalescer;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The number of timers currently armed on the receiver.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ The number of times the receiver's dispatch source has woken up.
+ */
+@property (atomic, readonly) uint64_t wakeups;
+
+/**
+ The number of timer firings the receiver has dispatched.
+ */
+@property (atomic, readonly) uint64_t firings;
+
+/**
+ The number of wakeups saved by coalescing, i.e. the number of firings that did
+ not need a wakeup of their own.
+ */
+@property (atomic, readonly) uint64_t savedWakeups;
+
+@end
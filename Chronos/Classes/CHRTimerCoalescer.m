@@ -0,0 +1,358 @@
+//
+//  CHRTimerCoalescer.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimerCoalescer.h"
+#import "CHRTimerInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - Constants and Functions
+
+static NSString * const CHRTimerCoalescerQueueNamePrefix = @"com.chronus.CHRTimerCoalescer";
+
+/**
+ Each armed entry is kept in two binary heaps: one ordered by the start of its
+ firing window (its deadline) and one ordered by the end of its window (its
+ deadline plus leeway).
+ */
+typedef NS_ENUM(int, CHRCoalescerHeap) {
+    CHRCoalescerHeapStart   = 0,
+    CHRCoalescerHeapEnd     = 1
+};
+
+static const size_t CHRCoalescerNotFound = SIZE_MAX;
+
+typedef struct chr_coalescer_entry_s *chr_coalescer_entry_t;
+
+struct chr_coalescer_entry_s {
+    uint64_t    deadline;   // chr_now() nanoseconds
+    uint64_t    leeway;
+    uint64_t    interval;   // 0 for a single firing
+    size_t      index[2];   // positions in the heaps, CHRCoalescerNotFound while disarmed
+    void        *queue;     // retained dispatch_queue_t
+    void        *handler;   // retained dispatch_block_t
+};
+
+static inline uint64_t chr_coalescer_key(chr_coalescer_entry_t entry, CHRCoalescerHeap heap) {
+    return (heap == CHRCoalescerHeapStart)? entry->deadline : entry->deadline + entry->leeway;
+}
+
+
+#pragma mark - CHRTimerCoalescer Class Extension
+
+@interface CHRTimerCoalescer () {
+    pthread_mutex_t         _lock;
+    chr_coalescer_entry_t   *_heaps[2];
+    size_t                  _count;
+    size_t                  _capacity;
+    uint64_t                _wakeupTime;    // chr_now() the source is set for, 0 while parked
+    uint64_t                _wakeups;
+    uint64_t                _firings;
+}
+
+@property (readonly) dispatch_queue_t   queue;
+@property (readonly) dispatch_source_t  timer;
+
+@end
+
+
+#pragma mark - CHRTimerCoalescer Implementation
+
+@implementation CHRTimerCoalescer
+
+- (void)dealloc
+{
+    dispatch_source_cancel(_timer);
+    free(_heaps[CHRCoalescerHeapStart]);
+    free(_heaps[CHRCoalescerHeapEnd]);
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Timer Coalescer
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        NSString *queueName = [NSString stringWithFormat:@"%@.%p", CHRTimerCoalescerQueueNamePrefix, self];
+        _queue = dispatch_queue_create([queueName UTF8String], DISPATCH_QUEUE_SERIAL);
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+        if (!_timer) {
+            NSLog(@"%@", @"Failed to create dispatch source for timer coalescer.");
+            return nil;
+        }
+        pthread_mutex_init(&_lock, NULL);
+        __weak CHRTimerCoalescer *weak = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weak wakeup];
+        });
+        // The source stays resumed for the lifetime of the coalescer and is
+        // parked at DISPATCH_TIME_FOREVER while no entry is armed.
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_timer);
+    }
+    return self;
+}
+
++ (CHRTimerCoalescer *)coalescer
+{
+    return [[CHRTimerCoalescer alloc]init];
+}
+
+#pragma mark Managing Entries
+
+- (CHRTimerSchedulerEntry)createEntryWithQueue:(dispatch_queue_t)queue handler:(dispatch_block_t)handler
+{
+    chr_coalescer_entry_t entry = calloc(1, sizeof(struct chr_coalescer_entry_s));
+    entry->index[CHRCoalescerHeapStart] = CHRCoalescerNotFound;
+    entry->index[CHRCoalescerHeapEnd] = CHRCoalescerNotFound;
+    entry->queue = (__bridge_retained void *)queue;
+    entry->handler = (__bridge_retained void *)[handler copy];
+    return entry;
+}
+
+- (void)armEntry:(CHRTimerSchedulerEntry)handle
+           delay:(uint64_t)delay
+        interval:(uint64_t)interval
+          leeway:(uint64_t)leeway
+{
+    chr_coalescer_entry_t entry = handle;
+    pthread_mutex_lock(&_lock);
+    BOOL wasFirst = NO;
+    if (entry->index[CHRCoalescerHeapStart] != CHRCoalescerNotFound) {
+        wasFirst = [self isFirst:entry];
+        [self removeEntry:entry];
+    }
+    entry->deadline = chr_now() + delay;
+    entry->interval = interval;
+    entry->leeway = leeway;
+    [self insertEntry:entry];
+    if (wasFirst || [self isFirst:entry]) {
+        [self rearm];
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)disarmEntry:(CHRTimerSchedulerEntry)handle
+{
+    chr_coalescer_entry_t entry = handle;
+    pthread_mutex_lock(&_lock);
+    if (entry->index[CHRCoalescerHeapStart] != CHRCoalescerNotFound) {
+        BOOL wasFirst = [self isFirst:entry];
+        [self removeEntry:entry];
+        if (wasFirst) {
+            [self rearm];
+        }
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)destroyEntry:(CHRTimerSchedulerEntry)handle
+{
+    chr_coalescer_entry_t entry = handle;
+    [self disarmEntry:entry];
+    CFBridgingRelease(entry->queue);
+    CFBridgingRelease(entry->handler);
+    free(entry);
+}
+
+#pragma mark Private
+
+- (void)swap:(size_t)a with:(size_t)b heap:(CHRCoalescerHeap)heap
+{
+    chr_coalescer_entry_t *entries = _heaps[heap];
+    chr_coalescer_entry_t entry = entries[a];
+    entries[a] = entries[b];
+    entries[b] = entry;
+    entries[a]->index[heap] = a;
+    entries[b]->index[heap] = b;
+}
+
+- (void)siftUp:(size_t)index heap:(CHRCoalescerHeap)heap
+{
+    chr_coalescer_entry_t *entries = _heaps[heap];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (chr_coalescer_key(entries[parent], heap) <= chr_coalescer_key(entries[index], heap)) {
+            break;
+        }
+        [self swap:index with:parent heap:heap];
+        index = parent;
+    }
+}
+
+- (void)siftDown:(size_t)index heap:(CHRCoalescerHeap)heap
+{
+    chr_coalescer_entry_t *entries = _heaps[heap];
+    while (YES) {
+        size_t smallest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        if (left < _count && chr_coalescer_key(entries[left], heap) < chr_coalescer_key(entries[smallest], heap)) {
+            smallest = left;
+        }
+        if (right < _count && chr_coalescer_key(entries[right], heap) < chr_coalescer_key(entries[smallest], heap)) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        [self swap:index with:smallest heap:heap];
+        index = smallest;
+    }
+}
+
+/**
+ Adds the entry to both heaps. Must be called with the lock held.
+ */
+- (void)insertEntry:(chr_coalescer_entry_t)entry
+{
+    if (_count == _capacity) {
+        _capacity = MAX(2 * _capacity, 16);
+        _heaps[CHRCoalescerHeapStart] = realloc(_heaps[CHRCoalescerHeapStart], _capacity * sizeof(chr_coalescer_entry_t));
+        _heaps[CHRCoalescerHeapEnd] = realloc(_heaps[CHRCoalescerHeapEnd], _capacity * sizeof(chr_coalescer_entry_t));
+    }
+    size_t index = _count++;
+    for (int heap = CHRCoalescerHeapStart; heap <= CHRCoalescerHeapEnd; ++heap) {
+        _heaps[heap][index] = entry;
+        entry->index[heap] = index;
+        [self siftUp:index heap:heap];
+    }
+}
+
+/**
+ Removes the entry from both heaps. Must be called with the lock held.
+ */
+- (void)removeEntry:(chr_coalescer_entry_t)entry
+{
+    size_t last = --_count;
+    for (int heap = CHRCoalescerHeapStart; heap <= CHRCoalescerHeapEnd; ++heap) {
+        size_t index = entry->index[heap];
+        entry->index[heap] = CHRCoalescerNotFound;
+        if (index == last) {
+            continue;
+        }
+        _heaps[heap][index] = _heaps[heap][last];
+        _heaps[heap][index]->index[heap] = index;
+        [self siftUp:index heap:heap];
+        [self siftDown:_heaps[heap][index]->index[heap] heap:heap];
+    }
+}
+
+/**
+ YES if the entry determines when the dispatch source fires next.
+ */
+- (BOOL)isFirst:(chr_coalescer_entry_t)entry
+{
+    return entry->index[CHRCoalescerHeapStart] == 0 || entry->index[CHRCoalescerHeapEnd] == 0;
+}
+
+/**
+ Points the dispatch source at the earliest window end, the latest time at
+ which the earliest timer may fire. Every timer whose window has started by
+ then fires in the same wakeup. Waking up any earlier, e.g. at the earliest
+ deadline, would leave timers with later deadlines in overlapping windows for
+ another wakeup. Must be called with the lock held.
+ */
+- (void)rearm
+{
+    if (_count == 0) {
+        _wakeupTime = 0;
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        return;
+    }
+    uint64_t now = chr_now();
+    uint64_t end = chr_coalescer_key(_heaps[CHRCoalescerHeapEnd][0], CHRCoalescerHeapEnd);
+    uint64_t delay = (end > now)? end - now : 0;
+    _wakeupTime = now + delay;
+    dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, delay), DISPATCH_TIME_FOREVER, 0);
+}
+
+/**
+ Fires every entry whose deadline is no later than the wakeup time the source
+ was set for. Runs on the coalescer's queue.
+ */
+- (void)wakeup
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t now = chr_now();
+    // The source and chr_now() may disagree by a few ticks, never wake up twice for that.
+    uint64_t bound = MAX(now, _wakeupTime);
+    uint64_t firings = 0;
+    while (_count > 0 && _heaps[CHRCoalescerHeapStart][0]->deadline <= bound) {
+        chr_coalescer_entry_t entry = _heaps[CHRCoalescerHeapStart][0];
+        [self removeEntry:entry];
+        if (entry->interval) {
+            entry->deadline += ((bound - entry->deadline) / entry->interval + 1) * entry->interval;
+            [self insertEntry:entry];
+        }
+        dispatch_async((__bridge dispatch_queue_t)entry->queue, (__bridge dispatch_block_t)entry->handler);
+        firings++;
+    }
+    if (firings) {
+        _wakeups++;
+        _firings += firings;
+    }
+    [self rearm];
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark Getters
+
+- (NSUInteger)count
+{
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _count;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+- (uint64_t)wakeups
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t wakeups = _wakeups;
+    pthread_mutex_unlock(&_lock);
+    return wakeups;
+}
+
+- (uint64_t)firings
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t firings = _firings;
+    pthread_mutex_unlock(&_lock);
+    return firings;
+}
+
+- (uint64_t)savedWakeups
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t savedWakeups = _firings - _wakeups;
+    pthread_mutex_unlock(&_lock);
+    return savedWakeups;
+}
+
+@end
@@ -0,0 +1,202 @@
+//
+//  CHRTimerFunctions.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - Type Definitions
+
+/**
+ An opaque reference to a repeating timer created with chr_timer_create.
+ */
+typedef struct chr_timer_s *chr_timer_t;
+
+/**
+ The function to call every time a chr_timer_t fires.
+ 
+ @param     context
+            The context pointer the timer was created with.
+ @param     invocation
+            The invocation number of the first elapsed period. The first
+            invocation is 0.
+ @param     periods
+            The number of periods that elapsed since the previous call. Greater
+            than 1 when the queue fell behind and the system coalesced firings.
+ */
+typedef void (*chr_timer_function_t)(void *context, NSUInteger invocation, NSUInteger periods);
+
+
+#pragma mark - Timer Functions
+
+/**
+ The chr_timer functions are a C interface to a repeating timer with a static
+ interval. The timer calls a function with a plain context pointer instead of
+ a block, so a firing performs no Objective-C messaging, no weak reference
+ loads and no allocations. CHRDispatchTimer is built on top of these functions.
+ 
+ The caller owns the context and must keep it alive until the timer's
+ finalizer runs, or until the timer is canceled and no firing can be in
+ flight. Functions are called serially, so the invocation count needs no
+ synchronization.
+ */
+
+// -----
+// @name Creating a Timer
+// -----
+
+#pragma mark Creating a Timer
+
+/**
+ Creates a timer with the default leeway of 5% of its interval.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     queue
+            The queue that should call the function.
+ @param     context
+            The pointer to pass to the function.
+ @param     function
+            The function to call at the given interval.
+ @return    The newly created timer, or NULL if it failed to initialize.
+ */
+FOUNDATION_EXPORT chr_timer_t chr_timer_create(NSTimeInterval interval,
+                                               dispatch_queue_t queue,
+                                               void *context,
+                                               chr_timer_function_t function);
+
+/**
+ Creates a timer with the given leeway.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     leeway
+            The amount of time the system may defer the timer, in nanoseconds.
+ @param     strict
+            YES, to create the timer with DISPATCH_TIMER_STRICT where available.
+ @param     queue
+            The queue that should call the function.
+ @param     context
+            The pointer to pass to the function.
+ @param     function
+            The function to call at the given interval.
+ @return    The newly created timer, or NULL if it failed to initialize.
+ */
+FOUNDATION_EXPORT chr_timer_t chr_timer_create_with_leeway(NSTimeInterval interval,
+                                                           uint64_t leeway,
+                                                           BOOL strict,
+                                                           dispatch_queue_t queue,
+                                                           void *context,
+                                                           chr_timer_function_t function);
+
+/**
+ Sets the function to call with the timer's context once the timer has been
+ canceled and will never call its function again. Must be set before the
+ timer is canceled.
+ 
+ @param     timer
+            The timer.
+ @param     finalizer
+            The function to call with the context, or NULL.
+ */
+FOUNDATION_EXPORT void chr_timer_set_finalizer_f(chr_timer_t timer, dispatch_function_t finalizer);
+
+// -----
+// @name Using a Timer
+// -----
+
+#pragma mark Using a Timer
+
+/**
+ Starts the timer. Does nothing if the timer is already running.
+ 
+ @param     timer
+            The timer.
+ @param     now
+            YES, if the function should be called immediately.
+ */
+FOUNDATION_EXPORT void chr_timer_start(chr_timer_t timer, BOOL now);
+
+/**
+ Starts the timer with its first call due after the given delay. Later calls
+ follow at the timer's interval. Does nothing if the timer is already running.
+ 
+ @param     timer
+            The timer.
+ @param     delay
+            The delay before the first call, in seconds.
+ */
+FOUNDATION_EXPORT void chr_timer_start_after(chr_timer_t timer, NSTimeInterval delay);
+
+/**
+ Pauses the timer. Does nothing if the timer is not running.
+ 
+ @param     timer
+            The timer.
+ */
+FOUNDATION_EXPORT void chr_timer_pause(chr_timer_t timer);
+
+/**
+ Permanently cancels the timer. The timer is freed once cancellation completes
+ and must not be used after this call.
+ 
+ @param     timer
+            The timer.
+ */
+FOUNDATION_EXPORT void chr_timer_cancel(chr_timer_t timer);
+
+/**
+ Changes the interval and leeway of a paused timer and clears its invocation
+ count, so that the timer and its dispatch source can be reused instead of
+ being canceled and created again. Does nothing if the timer is running.
+ 
+ @param     timer
+            The timer.
+ @param     interval
+            The new interval of the timer, in seconds.
+ @param     leeway
+            The new leeway of the timer, in nanoseconds.
+ @return    YES, if the timer was paused and has been reset.
+ */
+FOUNDATION_EXPORT BOOL chr_timer_reset(chr_timer_t timer, NSTimeInterval interval, uint64_t leeway);
+
+/**
+ Returns YES if the timer is running.
+ 
+ @param     timer
+            The timer.
+ */
+FOUNDATION_EXPORT BOOL chr_timer_is_running(chr_timer_t timer);
+
+/**
+ Returns the number of periods that have elapsed while the timer was running,
+ including periods that were coalesced into a single call.
+ 
+ @param     timer
+            The timer.
+ */
+FOUNDATION_EXPORT NSUInteger chr_timer_invocations(chr_timer_t timer);
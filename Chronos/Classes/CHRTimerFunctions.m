@@ -0,0 +1,163 @@
+//
+//  CHRTimerFunctions.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimerFunctions.h"
+#import "CHRTimerInternal.h"
+
+
+#pragma mark - Constants and Functions
+
+struct chr_timer_s {
+    void                    *source;        // retained dispatch_source_t
+    void                    *context;
+    chr_timer_function_t    function;
+    dispatch_function_t     finalizer;
+    NSTimeInterval          interval;
+    uint64_t                leeway;
+    chr_state_t             state;
+    chr_counter_t           invocations;
+};
+
+/**
+ The event handler of every timer source. Handlers of a source never run
+ concurrently, so the invocation count has a single writer. The source's data is
+ the number of firings coalesced since the last call.
+ */
+static void chr_timer_fire(void *context) {
+    chr_timer_t timer = context;
+    NSUInteger periods = MAX(dispatch_source_get_data((__bridge dispatch_source_t)timer->source), 1);
+    NSUInteger invocation = chr_counter_load(&timer->invocations);
+    atomic_store_explicit(&timer->invocations, invocation + periods, memory_order_relaxed);
+    timer->function(timer->context, invocation, periods);
+}
+
+/**
+ The cancel handler of every timer source. Runs after the last firing.
+ */
+static void chr_timer_finalize(void *context) {
+    chr_timer_t timer = context;
+    if (timer->finalizer) {
+        timer->finalizer(timer->context);
+    }
+    CFBridgingRelease(timer->source);
+    free(timer);
+}
+
+
+#pragma mark - Timer Functions
+
+#pragma mark Creating a Timer
+
+chr_timer_t chr_timer_create(NSTimeInterval interval,
+                             dispatch_queue_t queue,
+                             void *context,
+                             chr_timer_function_t function) {
+    return chr_timer_create_with_leeway(interval, chr_leeway(interval), NO, queue, context, function);
+}
+
+chr_timer_t chr_timer_create_with_leeway(NSTimeInterval interval,
+                                         uint64_t leeway,
+                                         BOOL strict,
+                                         dispatch_queue_t queue,
+                                         void *context,
+                                         chr_timer_function_t function) {
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, (strict)? CHR_TIMER_STRICT : 0, queue);
+    if (!source) {
+        return NULL;
+    }
+    chr_timer_t timer = calloc(1, sizeof(struct chr_timer_s));
+    timer->source = (__bridge_retained void *)source;
+    timer->context = context;
+    timer->function = function;
+    timer->interval = interval;
+    timer->leeway = leeway;
+    atomic_init(&timer->state, CHRTimerStateStopped);
+    atomic_init(&timer->invocations, 0);
+    dispatch_set_context(source, timer);
+    dispatch_source_set_event_handler_f(source, chr_timer_fire);
+    dispatch_source_set_cancel_handler_f(source, chr_timer_finalize);
+    return timer;
+}
+
+void chr_timer_set_finalizer_f(chr_timer_t timer, dispatch_function_t finalizer) {
+    timer->finalizer = finalizer;
+}
+
+#pragma mark Using a Timer
+
+void chr_timer_start(chr_timer_t timer, BOOL now) {
+    chr_timer_start_after(timer, (now)? 0.0 : timer->interval);
+}
+
+void chr_timer_start_after(chr_timer_t timer, NSTimeInterval delay) {
+    if (chr_state_begin(&timer->state, CHR_STATE_MASK(CHRTimerStateStopped)) == CHRTimerStateStopped) {
+        dispatch_source_t source = (__bridge dispatch_source_t)timer->source;
+        dispatch_source_set_timer(source, dispatch_time(DISPATCH_TIME_NOW, chr_nanoseconds(delay)), timer->interval * NSEC_PER_SEC, timer->leeway);
+        dispatch_resume(source);
+        chr_state_end(&timer->state, CHRTimerStateRunning);
+    }
+}
+
+void chr_timer_pause(chr_timer_t timer) {
+    if (chr_state_begin(&timer->state, CHR_STATE_MASK(CHRTimerStateRunning)) == CHRTimerStateRunning) {
+        dispatch_suspend((__bridge dispatch_source_t)timer->source);
+        chr_state_end(&timer->state, CHRTimerStateStopped);
+    }
+}
+
+void chr_timer_cancel(chr_timer_t timer) {
+    int32_t mask = CHR_STATE_MASK(CHRTimerStateStopped) | CHR_STATE_MASK(CHRTimerStateRunning);
+    CHRTimerState previous = chr_state_begin(&timer->state, mask);
+    if (previous != CHRTimerStateTransitioning) {
+        dispatch_source_t source = (__bridge dispatch_source_t)timer->source;
+        if (previous == CHRTimerStateStopped) {
+            dispatch_resume(source);
+        }
+        chr_state_end(&timer->state, CHRTimerStateInvalid);
+        dispatch_source_cancel(source);
+    }
+}
+
+BOOL chr_timer_reset(chr_timer_t timer, NSTimeInterval interval, uint64_t leeway) {
+    if (chr_state_begin(&timer->state, CHR_STATE_MASK(CHRTimerStateStopped)) != CHRTimerStateStopped) {
+        return NO;
+    }
+    timer->interval = interval;
+    timer->leeway = leeway;
+    atomic_store_explicit(&timer->invocations, 0, memory_order_relaxed);
+    chr_state_end(&timer->state, CHRTimerStateStopped);
+    return YES;
+}
+
+BOOL chr_timer_is_running(chr_timer_t timer) {
+    return chr_state_load(&timer->state) == CHRTimerStateRunning;
+}
+
+NSUInteger chr_timer_invocations(chr_timer_t timer) {
+    return chr_counter_load(&timer->invocations);
+}
@@ -0,0 +1,181 @@
+//
+//  CHRTimerGroup.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+
+
+#pragma mark - CHRTimerGroup Interface
+
+/**
+ The CHRTimerGroup class owns a set of timers and starts, pauses, cancels and
+ drains them in bulk, e.g. to quiesce a node before shutting it down.
+ 
+ Timers created by a group execute on the group's own pool of serial queues,
+ and their execution blocks pass through a gate shared by the whole group.
+ Pausing the group first closes the gate with a single atomic store, so no
+ execution block starts from that point on, then pauses every timer's source.
+ Draining waits until every execution block that passed the gate before it
+ closed has returned. Starting, pausing and canceling touch every timer, but do
+ so in parallel.
+ */
+@interface CHRTimerGroup : NSObject
+
+// -----
+// @name Creating a Timer Group
+// -----
+
+#pragma mark Creating a Timer Group
+
+/**
+ Initializes a CHRTimerGroup object whose queues target the default priority
+ global queue.
+ 
+ @return    The newly initialized CHRTimerGroup object.
+ */
+- (instancetype)init;
+
+/**
+ Initializes a CHRTimerGroup object.
+ 
+ @param     targetQueue
+            The queue targeted by every execution queue of the group.
+ @return    The newly initialized CHRTimerGroup object.
+ */
+- (instancetype)initWithTargetQueue:(dispatch_queue_t)targetQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRTimerGroup object whose queues target the
+ default priority global queue.
+ 
+ @return    The newly created CHRTimerGroup object.
+ */
++ (CHRTimerGroup *)group;
+
+/**
+ Creates and initializes a new CHRTimerGroup object.
+ 
+ @param     targetQueue
+            The queue targeted by every execution queue of the group.
+ @return    The newly created CHRTimerGroup object.
+ */
++ (CHRTimerGroup *)groupWithTargetQueue:(dispatch_queue_t)targetQueue;
+
+// -----
+// @name Creating Timers
+// -----
+
+#pragma mark Creating Timers
+
+/**
+ Creates a stopped CHRDispatchTimer object owned by the receiver.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @return    The newly created CHRDispatchTimer object.
+ */
+- (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock;
+
+/**
+ Creates a stopped CHRVariableTimer object owned by the receiver.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @return    The newly created CHRVariableTimer object.
+ */
+- (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                                 executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock;
+
+// -----
+// @name Using a Timer Group
+// -----
+
+#pragma mark Using a Timer Group
+
+/**
+ Opens the gate and starts every timer of the receiver that is not running.
+ 
+ @param     now
+            YES if the timers should fire immediately.
+ */
+- (void)startAll:(BOOL)now;
+
+/**
+ Closes the gate, so no execution block of the receiver's timers starts until
+ startAll: is called, then pauses every timer of the receiver. Returns without
+ waiting for the execution blocks in flight; call drain to wait for them.
+ */
+- (void)pauseAll;
+
+/**
+ Closes the gate, cancels every timer of the receiver and removes them from the
+ receiver.
+ */
+- (void)cancelAll;
+
+/**
+ Blocks until every execution block in flight has returned. Call pauseAll or
+ cancelAll first, otherwise new executions may begin before this method
+ returns. Calling this method from an execution block of the receiver
+ deadlocks, since it waits for that very block to return.
+ */
+- (void)drain;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The timers owned by the receiver.
+ */
+@property (atomic, readonly) NSArray *timers;
+
+/**
+ The number of timers owned by the receiver.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ The number of execution blocks currently running.
+ */
+@property (atomic, readonly) NSUInteger executing;
+
+/**
+ YES, if the receiver's gate is closed.
+ */
+@property (atomic, readonly, getter=isPaused) BOOL paused;
+
+@end
@@ -0,0 +1,267 @@
+//
+//  CHRTimerGroup.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimerGroup.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRTimerInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - Constants and Functions
+
+static const NSUInteger CHRTimerGroupQueuesPerProcessor = 4;
+
+/**
+ The number of timers each iteration of a bulk operation handles, large enough
+ to amortize the cost of dispatching the iteration.
+ */
+static const NSUInteger CHRTimerGroupApplyStride = 1024;
+
+
+#pragma mark - CHRTimerGroup Class Extension
+
+@interface CHRTimerGroup () {
+    pthread_mutex_t     _lock;          // guards _timers and _drained
+    pthread_cond_t      _drained;
+    NSMutableArray      *_timers;
+    chr_counter_t       _executing;
+    chr_counter_t       _drainers;
+    atomic_bool         _paused;
+}
+
+@property (readonly) CHRExecutionQueuePool *pool;
+
+@end
+
+
+#pragma mark - CHRTimerGroup Implementation
+
+@implementation CHRTimerGroup
+
+- (void)dealloc
+{
+    [self cancelAll];
+    pthread_cond_destroy(&_drained);
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Timer Group
+
+- (instancetype)init
+{
+    return [self initWithTargetQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+}
+
+- (instancetype)initWithTargetQueue:(dispatch_queue_t)targetQueue
+{
+    if (self = [super init]) {
+        NSUInteger processorCount = [[NSProcessInfo processInfo] activeProcessorCount];
+        _pool = [[CHRExecutionQueuePool alloc]initWithQueueCount:CHRTimerGroupQueuesPerProcessor * processorCount
+                                                      targetQueue:targetQueue];
+        _timers = [NSMutableArray array];
+        pthread_mutex_init(&_lock, NULL);
+        pthread_cond_init(&_drained, NULL);
+    }
+    return self;
+}
+
++ (CHRTimerGroup *)group
+{
+    return [[CHRTimerGroup alloc]init];
+}
+
++ (CHRTimerGroup *)groupWithTargetQueue:(dispatch_queue_t)targetQueue
+{
+    return [[CHRTimerGroup alloc]initWithTargetQueue:targetQueue];
+}
+
+#pragma mark Creating Timers
+
+- (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+{
+    CHRDispatchTimer *timer = [CHRDispatchTimer alloc];
+    timer = [timer initWithInterval:interval
+                     executionBlock:[self gatedBlock:executionBlock]
+                     executionQueue:[_pool queueForObject:timer]];
+    [self addTimer:timer];
+    return timer;
+}
+
+- (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                                 executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+{
+    CHRVariableTimer *timer = [CHRVariableTimer alloc];
+    timer = [timer initWithIntervalProvider:intervalProvider
+                             executionBlock:[self gatedBlock:executionBlock]
+                             executionQueue:[_pool queueForObject:timer]];
+    [self addTimer:timer];
+    return timer;
+}
+
+#pragma mark Using a Timer Group
+
+- (void)startAll:(BOOL)now
+{
+    atomic_store(&_paused, false);
+    [self applyToTimers:self.timers block:^(id<CHRTimer> timer) {
+        if (timer.isValid && !timer.isRunning) {
+            [timer start:now];
+        }
+    }];
+}
+
+- (void)pauseAll
+{
+    atomic_store(&_paused, true);
+    [self applyToTimers:self.timers block:^(id<CHRTimer> timer) {
+        [timer pause];
+    }];
+}
+
+- (void)cancelAll
+{
+    atomic_store(&_paused, true);
+    pthread_mutex_lock(&_lock);
+    NSArray *timers = _timers;
+    _timers = [NSMutableArray array];
+    pthread_mutex_unlock(&_lock);
+    [self applyToTimers:timers block:^(id<CHRTimer> timer) {
+        [timer cancel];
+    }];
+}
+
+- (void)drain
+{
+    atomic_fetch_add(&_drainers, 1);
+    pthread_mutex_lock(&_lock);
+    while (atomic_load(&_executing) > 0) {
+        pthread_cond_wait(&_drained, &_lock);
+    }
+    pthread_mutex_unlock(&_lock);
+    atomic_fetch_sub(&_drainers, 1);
+}
+
+#pragma mark Private
+
+- (void)addTimer:(id<CHRTimer>)timer
+{
+    if (timer) {
+        pthread_mutex_lock(&_lock);
+        [_timers addObject:timer];
+        pthread_mutex_unlock(&_lock);
+    }
+}
+
+/**
+ Wraps an execution block in the group's gate. The block holds the group weakly,
+ since the group owns the timer that owns the block.
+ */
+- (CHRRepeatingTimerExecutionBlock)gatedBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+{
+    executionBlock = [executionBlock copy];
+    __weak CHRTimerGroup *weak = self;
+    return ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        CHRTimerGroup *group = weak;
+        if (group && [group enter]) {
+            executionBlock(timer, invocation);
+            [group leave];
+        }
+    };
+}
+
+/**
+ Passes the gate, or returns NO if it is closed.
+ */
+- (BOOL)enter
+{
+    // Sequentially consistent with the store in -pauseAll and the load in -drain,
+    // so either a drain waits for this execution or this execution sees the
+    // closed gate.
+    atomic_fetch_add(&_executing, 1);
+    if (atomic_load(&_paused)) {
+        [self leave];
+        return NO;
+    }
+    return YES;
+}
+
+- (void)leave
+{
+    if (atomic_fetch_sub(&_executing, 1) == 1 && atomic_load(&_drainers) > 0) {
+        pthread_mutex_lock(&_lock);
+        pthread_cond_broadcast(&_drained);
+        pthread_mutex_unlock(&_lock);
+    }
+}
+
+/**
+ Applies the block to every timer, spreading strides of timers over the
+ processors.
+ */
+- (void)applyToTimers:(NSArray *)timers block:(void (^)(id<CHRTimer> timer))block
+{
+    NSUInteger count = timers.count;
+    size_t strides = (count + CHRTimerGroupApplyStride - 1) / CHRTimerGroupApplyStride;
+    dispatch_apply(strides, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t stride) {
+        NSUInteger end = MIN((stride + 1) * CHRTimerGroupApplyStride, count);
+        for (NSUInteger i = stride * CHRTimerGroupApplyStride; i < end; ++i) {
+            block(timers[i]);
+        }
+    });
+}
+
+#pragma mark Getters
+
+- (NSArray *)timers
+{
+    pthread_mutex_lock(&_lock);
+    NSArray *timers = [_timers copy];
+    pthread_mutex_unlock(&_lock);
+    return timers;
+}
+
+- (NSUInteger)count
+{
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _timers.count;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)executing
+{
+    return atomic_load(&_executing);
+}
+
+- (BOOL)isPaused
+{
+    return atomic_load(&_paused);
+}
+
+@end
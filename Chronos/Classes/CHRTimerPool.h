@@ -0,0 +1,170 @@
+//
+//  CHRTimerPool.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRDispatchTimer.h"
+
+
+#pragma mark - CHRTimerPool Interface
+
+/**
+ The CHRTimerPool class recycles CHRDispatchTimer objects, along with their
+ dispatch sources, for workloads that create and discard short-lived timers at
+ a high rate.
+ 
+ A timer taken from a pool is paused and behaves like a newly created timer.
+ Once it is no longer needed it should be handed back with recycleTimer:
+ instead of being canceled; the pool pauses it, waits for any firing already
+ in flight on the execution queue, and keeps it for a later request. The pool
+ keeps at most capacity idle timers and cancels the rest.
+ 
+ Every timer of a pool executes on the pool's execution queue, which must be a
+ serial queue or a concurrent queue created by the application.
+ */
+@interface CHRTimerPool : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Timer Pool
+// -----
+
+#pragma mark Creating a Timer Pool
+
+/**
+ Initializes a CHRTimerPool object.
+ 
+ The timers of the pool execute on a serial queue taken from the shared
+ CHRExecutionQueuePool.
+ 
+ @param     capacity
+            The largest number of idle timers kept by the pool.
+ @return    The newly initialized CHRTimerPool object.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/**
+ Initializes a CHRTimerPool object.
+ 
+ @param     capacity
+            The largest number of idle timers kept by the pool.
+ @param     executionQueue
+            The queue that executes the execution blocks of the pool's timers.
+ @return    The newly initialized CHRTimerPool object.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+                  executionQueue:(dispatch_queue_t)executionQueue NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRTimerPool object.
+ 
+ @param     capacity
+            The largest number of idle timers kept by the pool.
+ @return    The newly created CHRTimerPool object.
+ */
++ (CHRTimerPool *)poolWithCapacity:(NSUInteger)capacity;
+
+/**
+ Creates and initializes a new CHRTimerPool object.
+ 
+ @param     capacity
+            The largest number of idle timers kept by the pool.
+ @param     executionQueue
+            The queue that executes the execution blocks of the pool's timers.
+ @return    The newly created CHRTimerPool object.
+ */
++ (CHRTimerPool *)poolWithCapacity:(NSUInteger)capacity
+                    executionQueue:(dispatch_queue_t)executionQueue;
+
+// -----
+// @name Using a Timer Pool
+// -----
+
+#pragma mark Using a Timer Pool
+
+/**
+ Returns a paused timer, recycled from the pool if one is idle and created
+ otherwise.
+ 
+ @param     interval
+            The execution interval, in seconds.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @return    A paused CHRDispatchTimer object, or nil if no timer could be
+            created.
+ */
+- (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock;
+
+/**
+ Hands a timer back to the pool. The timer must not be used by the caller
+ after this call. Timers that did not come from the pool, or that have already
+ been canceled, are canceled instead of being kept.
+ 
+ @param     timer
+            The timer to recycle.
+ */
+- (void)recycleTimer:(CHRDispatchTimer *)timer;
+
+/**
+ Cancels every idle timer held by the pool.
+ */
+- (void)drain;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The largest number of idle timers kept by the receiver.
+ */
+@property (readonly) NSUInteger capacity;
+
+/**
+ The queue that executes the execution blocks of the receiver's timers.
+ */
+@property (readonly) dispatch_queue_t executionQueue;
+
+/**
+ The number of idle timers currently held by the receiver.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ The number of timers handed out that were recycled.
+ */
+@property (atomic, readonly) NSUInteger hits;
+
+/**
+ The number of timers handed out that had to be created.
+ */
+@property (atomic, readonly) NSUInteger misses;
+
+@end
@@ -0,0 +1,185 @@
+//
+//  CHRTimerPool.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimerPool.h"
+#import "CHRDispatchTimerInternal.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRTimerInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - CHRTimerPool Class Extension
+
+@interface CHRTimerPool () {
+    pthread_mutex_t     _lock;
+    chr_counter_t       _hits;
+    chr_counter_t       _misses;
+}
+
+@property (readonly) NSMutableArray *timers;
+
+@end
+
+
+#pragma mark - CHRTimerPool Implementation
+
+@implementation CHRTimerPool
+
+- (void)dealloc
+{
+    [self drain];
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Timer Pool
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
+    return [self initWithCapacity:capacity executionQueue:executionQueue];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+                  executionQueue:(dispatch_queue_t)executionQueue
+{
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _capacity = capacity;
+        _executionQueue = executionQueue;
+        _timers = [NSMutableArray arrayWithCapacity:capacity];
+        atomic_init(&_hits, 0);
+        atomic_init(&_misses, 0);
+    }
+    return self;
+}
+
++ (CHRTimerPool *)poolWithCapacity:(NSUInteger)capacity
+{
+    return [[CHRTimerPool alloc]initWithCapacity:capacity];
+}
+
++ (CHRTimerPool *)poolWithCapacity:(NSUInteger)capacity
+                    executionQueue:(dispatch_queue_t)executionQueue
+{
+    return [[CHRTimerPool alloc]initWithCapacity:capacity executionQueue:executionQueue];
+}
+
+#pragma mark Using a Timer Pool
+
+- (CHRDispatchTimer *)timerWithInterval:(NSTimeInterval)interval
+                         executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+{
+    pthread_mutex_lock(&_lock);
+    CHRDispatchTimer *timer = [_timers lastObject];
+    if (timer) {
+        [_timers removeLastObject];
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    if (timer && [timer resetWithInterval:interval executionBlock:executionBlock]) {
+        atomic_fetch_add_explicit(&_hits, 1, memory_order_relaxed);
+        return timer;
+    }
+    [timer cancel];
+    atomic_fetch_add_explicit(&_misses, 1, memory_order_relaxed);
+    return [CHRDispatchTimer timerWithInterval:interval
+                                executionBlock:executionBlock
+                                executionQueue:_executionQueue];
+}
+
+- (void)recycleTimer:(CHRDispatchTimer *)timer
+{
+    if (!timer.isValid) {
+        return;
+    }
+    if (timer.scheduler || timer.executionQueue != _executionQueue) {
+        [timer cancel];
+        return;
+    }
+    [timer pause];
+    // The barrier runs after any firing that was already in flight, so the
+    // timer's next owner never sees a call to the previous execution block.
+    dispatch_barrier_async(_executionQueue, ^{
+        [self keepTimer:timer];
+    });
+}
+
+- (void)drain
+{
+    pthread_mutex_lock(&_lock);
+    NSArray *timers = [_timers copy];
+    [_timers removeAllObjects];
+    pthread_mutex_unlock(&_lock);
+    
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+}
+
+#pragma mark Private
+
+- (void)keepTimer:(CHRDispatchTimer *)timer
+{
+    if (![timer resetWithInterval:timer.interval executionBlock:nil]) {
+        // The timer was started again after being recycled.
+        [timer cancel];
+        return;
+    }
+    pthread_mutex_lock(&_lock);
+    BOOL kept = (_timers.count < _capacity);
+    if (kept) {
+        [_timers addObject:timer];
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    if (!kept) {
+        [timer cancel];
+    }
+}
+
+#pragma mark Getters
+
+- (NSUInteger)count
+{
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _timers.count;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)hits
+{
+    return chr_counter_load(&_hits);
+}
+
+- (NSUInteger)misses
+{
+    return chr_counter_load(&_misses);
+}
+
+@end
@@ -0,0 +1,179 @@
+//
+//  CHRTimerRegistry.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - CHRTimerSnapshot Interface
+
+/**
+ The state of a single live timer at the moment a snapshot was taken.
+ */
+@interface CHRTimerSnapshot : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ The class of the timer.
+ */
+@property (readonly) Class timerClass;
+
+/**
+ The timer's interval, in seconds. For a variable timer, the most recent
+ interval it was armed with.
+ */
+@property (readonly) NSTimeInterval interval;
+
+/**
+ YES, if the timer was running.
+ */
+@property (readonly, getter=isRunning) BOOL running;
+
+/**
+ YES, if the timer had not been canceled.
+ */
+@property (readonly, getter=isValid) BOOL valid;
+
+/**
+ The number of times the timer's execution block ran.
+ */
+@property (readonly) uint64_t invocations;
+
+/**
+ The total time the timer's execution block spent running, in seconds.
+ */
+@property (readonly) NSTimeInterval executionTime;
+
+/**
+ The queue the timer's execution block runs on.
+ */
+@property (readonly) dispatch_queue_t executionQueue;
+
+@end
+
+
+#pragma mark - CHRQueueLoad Interface
+
+/**
+ The load every live timer sharing an execution queue put on that queue, at
+ the moment a snapshot was taken.
+ */
+@interface CHRQueueLoad : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ The execution queue.
+ */
+@property (readonly) dispatch_queue_t executionQueue;
+
+/**
+ The label of the execution queue, or an empty string if it has none.
+ */
+@property (readonly, copy) NSString *label;
+
+/**
+ The number of live timers executing on the queue.
+ */
+@property (readonly) NSUInteger timers;
+
+/**
+ The number of execution blocks the queue's timers ran.
+ */
+@property (readonly) uint64_t invocations;
+
+/**
+ The total time the queue's timers spent in their execution blocks, in
+ seconds.
+ */
+@property (readonly) NSTimeInterval executionTime;
+
+@end
+
+
+#pragma mark - CHRTimerRegistry Interface
+
+/**
+ The CHRTimerRegistry class keeps an optional process-wide list of live
+ CHRDispatchTimer and CHRVariableTimer objects, for answering how many timers
+ are alive, where they fire and how much time their execution blocks take.
+ 
+ Timers created while the registry is enabled register themselves and stay
+ registered until they are deallocated; the registry does not retain them.
+ Registration and removal take one of several sharded locks, and a registered
+ timer accounts for each execution with two clock reads and two relaxed atomic
+ additions. Snapshots never pause or block a timer.
+ */
+@interface CHRTimerRegistry : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Controlling the Registry
+// -----
+
+#pragma mark Controlling the Registry
+
+/**
+ Enables or disables registration of newly created timers. Timers already
+ registered stay registered.
+ 
+ @param     enabled
+            YES, to register timers created from now on.
+ */
++ (void)setEnabled:(BOOL)enabled;
+
+/**
+ Returns whether newly created timers are registered.
+ 
+ @return    YES, if the registry is enabled.
+ */
++ (BOOL)isEnabled;
+
+// -----
+// @name Taking Snapshots
+// -----
+
+#pragma mark Taking Snapshots
+
+/**
+ Returns the state of every registered timer.
+ 
+ @return    An array of CHRTimerSnapshot objects, in no particular order.
+ */
++ (NSArray *)timerSnapshots;
+
+/**
+ Returns the load of every execution queue with registered timers.
+ 
+ @return    An array of CHRQueueLoad objects, ordered by decreasing execution
+            time.
+ */
++ (NSArray *)queueLoads;
+
+@end
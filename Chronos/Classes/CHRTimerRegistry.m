@@ -0,0 +1,221 @@
+//
+//  CHRTimerRegistry.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimerRegistry.h"
+#import "CHRTimerRegistryInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - Constants and Functions
+
+#define CHR_REGISTRY_SHARDS     16
+
+struct chr_registry_shard_s {
+    pthread_mutex_t         lock;
+    chr_registry_record_t   head;
+} __attribute__((aligned(64)));
+
+static atomic_bool chr_registry_enabled;
+static struct chr_registry_shard_s chr_registry_shards[CHR_REGISTRY_SHARDS] = {
+    [0 ... CHR_REGISTRY_SHARDS - 1] = { PTHREAD_MUTEX_INITIALIZER, NULL }
+};
+
+static struct chr_registry_shard_s * chr_registry_shard(chr_registry_record_t record) {
+    return &chr_registry_shards[((uintptr_t)record >> 6) % CHR_REGISTRY_SHARDS];
+}
+
+chr_registry_record_t chr_registry_register(Class timerClass, dispatch_queue_t queue, NSTimeInterval interval) {
+    if (!atomic_load_explicit(&chr_registry_enabled, memory_order_relaxed)) {
+        return NULL;
+    }
+    chr_registry_record_t record = calloc(1, sizeof(struct chr_registry_record_s));
+    record->timerClass = (__bridge void *)timerClass;
+    record->queue = (__bridge_retained void *)queue;
+    atomic_init(&record->interval, chr_nanoseconds(interval));
+    atomic_init(&record->state, CHRTimerStateStopped);
+    
+    struct chr_registry_shard_s *shard = chr_registry_shard(record);
+    pthread_mutex_lock(&shard->lock);
+    record->next = shard->head;
+    if (record->next) {
+        record->next->prev = record;
+    }
+    shard->head = record;
+    pthread_mutex_unlock(&shard->lock);
+    return record;
+}
+
+void chr_registry_unregister(chr_registry_record_t record) {
+    if (!record) {
+        return;
+    }
+    struct chr_registry_shard_s *shard = chr_registry_shard(record);
+    pthread_mutex_lock(&shard->lock);
+    if (record->prev) {
+        record->prev->next = record->next;
+    } else {
+        shard->head = record->next;
+    }
+    if (record->next) {
+        record->next->prev = record->prev;
+    }
+    pthread_mutex_unlock(&shard->lock);
+    CFBridgingRelease(record->queue);
+    free(record);
+}
+
+
+#pragma mark - CHRTimerSnapshot Class Extension
+
+@interface CHRTimerSnapshot ()
+
+@property (readwrite) Class timerClass;
+@property (readwrite) NSTimeInterval interval;
+@property (readwrite, getter=isRunning) BOOL running;
+@property (readwrite, getter=isValid) BOOL valid;
+@property (readwrite) uint64_t invocations;
+@property (readwrite) NSTimeInterval executionTime;
+@property (readwrite) dispatch_queue_t executionQueue;
+
+@end
+
+
+#pragma mark - CHRTimerSnapshot Implementation
+
+@implementation CHRTimerSnapshot
+
+- (instancetype)initWithRecord:(chr_registry_record_t)record
+{
+    if (self = [super init]) {
+        CHRTimerState state = atomic_load_explicit(&record->state, memory_order_relaxed);
+        _timerClass = (__bridge Class)record->timerClass;
+        _interval = atomic_load_explicit(&record->interval, memory_order_relaxed) / (NSTimeInterval)NSEC_PER_SEC;
+        _running = (state == CHRTimerStateRunning);
+        _valid = (state != CHRTimerStateInvalid);
+        _invocations = atomic_load_explicit(&record->invocations, memory_order_relaxed);
+        _executionTime = atomic_load_explicit(&record->executionTime, memory_order_relaxed) / (NSTimeInterval)NSEC_PER_SEC;
+        _executionQueue = (__bridge dispatch_queue_t)record->queue;
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; timerClass = %@; interval = %f; running = %d; invocations = %llu; executionTime = %f>",
+            [self class], self, _timerClass, _interval, _running, _invocations, _executionTime];
+}
+
+@end
+
+
+#pragma mark - CHRQueueLoad Class Extension
+
+@interface CHRQueueLoad ()
+
+@property (readwrite) dispatch_queue_t executionQueue;
+@property (readwrite, copy) NSString *label;
+@property (readwrite) NSUInteger timers;
+@property (readwrite) uint64_t invocations;
+@property (readwrite) NSTimeInterval executionTime;
+
+@end
+
+
+#pragma mark - CHRQueueLoad Implementation
+
+@implementation CHRQueueLoad
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue
+{
+    if (self = [super init]) {
+        _executionQueue = queue;
+        const char *label = dispatch_queue_get_label(queue);
+        _label = (label)? @(label) : @"";
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; label = %@; timers = %lu; invocations = %llu; executionTime = %f>",
+            [self class], self, _label, (unsigned long)_timers, _invocations, _executionTime];
+}
+
+@end
+
+
+#pragma mark - CHRTimerRegistry Implementation
+
+@implementation CHRTimerRegistry
+
+#pragma mark Controlling the Registry
+
++ (void)setEnabled:(BOOL)enabled
+{
+    atomic_store(&chr_registry_enabled, (bool)enabled);
+}
+
++ (BOOL)isEnabled
+{
+    return atomic_load(&chr_registry_enabled);
+}
+
+#pragma mark Taking Snapshots
+
++ (NSArray *)timerSnapshots
+{
+    NSMutableArray *snapshots = [NSMutableArray array];
+    for (NSUInteger i = 0; i < CHR_REGISTRY_SHARDS; ++i) {
+        struct chr_registry_shard_s *shard = &chr_registry_shards[i];
+        pthread_mutex_lock(&shard->lock);
+        for (chr_registry_record_t record = shard->head; record; record = record->next) {
+            [snapshots addObject:[[CHRTimerSnapshot alloc]initWithRecord:record]];
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return snapshots;
+}
+
++ (NSArray *)queueLoads
+{
+    NSMapTable *loads = [NSMapTable strongToStrongObjectsMapTable];
+    for (CHRTimerSnapshot *snapshot in [self timerSnapshots]) {
+        CHRQueueLoad *load = [loads objectForKey:snapshot.executionQueue];
+        if (!load) {
+            load = [[CHRQueueLoad alloc]initWithQueue:snapshot.executionQueue];
+            [loads setObject:load forKey:snapshot.executionQueue];
+        }
+        load.timers += 1;
+        load.invocations += snapshot.invocations;
+        load.executionTime += snapshot.executionTime;
+    }
+    NSSortDescriptor *descriptor = [NSSortDescriptor sortDescriptorWithKey:@"executionTime" ascending:NO];
+    return [[[loads objectEnumerator] allObjects] sortedArrayUsingDescriptors:@[descriptor]];
+}
+
+@end
@@ -0,0 +1,126 @@
+//
+//  CHRTimerStatistics.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - CHRTimerStatistics Interface
+
+/**
+ The CHRTimerStatistics class records how late a repeating timer fires and how
+ long its execution block takes to run.
+ 
+ Both measurements are kept in fixed-size log-linear histograms, each bucket
+ covering 1/8th of a power of two, so every reported percentile is within 12.5%
+ of the recorded value. Recording is lock-free and never allocates, so a timer
+ may record every firing. Reading may run concurrently with recording, in
+ which case a read can miss the firings that are being recorded.
+ 
+ Statistics are opt-in. Assign a CHRTimerStatistics object to the statistics
+ property of a repeating timer before starting it.
+ */
+@interface CHRTimerStatistics : NSObject
+
+// -----
+// @name Creating Timer Statistics
+// -----
+
+#pragma mark Creating Timer Statistics
+
+/**
+ Initializes an empty CHRTimerStatistics object.
+ 
+ @return    The newly initialized CHRTimerStatistics object.
+ */
+- (instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes an empty CHRTimerStatistics object.
+ 
+ @return    The newly created CHRTimerStatistics object.
+ */
++ (CHRTimerStatistics *)statistics;
+
+// -----
+// @name Reading Timer Statistics
+// -----
+
+#pragma mark Reading Timer Statistics
+
+/**
+ Returns the lateness below which the given percentage of firings fell.
+ 
+ @param     percentile
+            The percentile, between 0 and 100, e.g. 99.9.
+ @return    The lateness, in seconds, or 0 if nothing was recorded.
+ */
+- (NSTimeInterval)latenessAtPercentile:(double)percentile;
+
+/**
+ Returns the execution duration below which the given percentage of firings
+ fell.
+ 
+ @param     percentile
+            The percentile, between 0 and 100, e.g. 99.9.
+ @return    The duration, in seconds, or 0 if nothing was recorded.
+ */
+- (NSTimeInterval)durationAtPercentile:(double)percentile;
+
+/**
+ Discards everything recorded so far.
+ */
+- (void)reset;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The number of times the timer's execution block ran.
+ */
+@property (atomic, readonly) uint64_t fires;
+
+/**
+ The number of firings that were skipped because the timer fell behind by more
+ than one interval.
+ */
+@property (atomic, readonly) uint64_t skips;
+
+/**
+ The largest lateness recorded, in seconds.
+ */
+@property (atomic, readonly) NSTimeInterval maximumLateness;
+
+/**
+ The longest execution duration recorded, in seconds.
+ */
+@property (atomic, readonly) NSTimeInterval maximumDuration;
+
+@end
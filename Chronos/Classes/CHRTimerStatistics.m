@@ -0,0 +1,204 @@
+//
+//  CHRTimerStatistics.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimerStatisticsInternal.h"
+#import <stdatomic.h>
+
+
+#pragma mark - Constants and Functions
+
+#define CHR_HISTOGRAM_SUB_BITS      3
+#define CHR_HISTOGRAM_SUB_BUCKETS   (1 << CHR_HISTOGRAM_SUB_BITS)
+#define CHR_HISTOGRAM_BUCKETS       ((64 - CHR_HISTOGRAM_SUB_BITS + 1) * CHR_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct chr_histogram_s {
+    _Atomic(uint64_t)   buckets[CHR_HISTOGRAM_BUCKETS];
+    _Atomic(uint64_t)   maximum;
+} chr_histogram_t;
+
+/**
+ Maps a value to its bucket. Values below CHR_HISTOGRAM_SUB_BUCKETS get a bucket
+ each, larger values share CHR_HISTOGRAM_SUB_BUCKETS buckets per power of two.
+ */
+static inline int chr_histogram_index(uint64_t value) {
+    if (value < CHR_HISTOGRAM_SUB_BUCKETS) {
+        return (int)value;
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    int shift = exponent - CHR_HISTOGRAM_SUB_BITS;
+    return ((shift + 1) << CHR_HISTOGRAM_SUB_BITS) + (int)((value >> shift) & (CHR_HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/**
+ Returns the largest value that maps to the given bucket.
+ */
+static inline uint64_t chr_histogram_value(int index) {
+    if (index < CHR_HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    int shift = (index >> CHR_HISTOGRAM_SUB_BITS) - 1;
+    uint64_t lowest = (uint64_t)(CHR_HISTOGRAM_SUB_BUCKETS + (index & (CHR_HISTOGRAM_SUB_BUCKETS - 1))) << shift;
+    return lowest + ((1ULL << shift) - 1);
+}
+
+static inline void chr_histogram_record(chr_histogram_t *histogram, uint64_t value) {
+    atomic_fetch_add_explicit(&histogram->buckets[chr_histogram_index(value)], 1, memory_order_relaxed);
+    uint64_t maximum = atomic_load_explicit(&histogram->maximum, memory_order_relaxed);
+    while (value > maximum &&
+           !atomic_compare_exchange_weak_explicit(&histogram->maximum, &maximum, value,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+        // maximum was reloaded by the failed exchange
+    }
+}
+
+static inline void chr_histogram_reset(chr_histogram_t *histogram) {
+    for (int i = 0; i < CHR_HISTOGRAM_BUCKETS; ++i) {
+        atomic_store_explicit(&histogram->buckets[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&histogram->maximum, 0, memory_order_relaxed);
+}
+
+static inline NSTimeInterval chr_histogram_percentile(chr_histogram_t *histogram, double percentile) {
+    uint64_t counts[CHR_HISTOGRAM_BUCKETS];
+    uint64_t total = 0;
+    for (int i = 0; i < CHR_HISTOGRAM_BUCKETS; ++i) {
+        counts[i] = atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed);
+        total += counts[i];
+    }
+    uint64_t maximum = atomic_load_explicit(&histogram->maximum, memory_order_relaxed);
+    if (total == 0) {
+        return 0.0;
+    }
+    uint64_t rank = MAX((uint64_t)ceil(MIN(MAX(percentile, 0.0), 100.0) / 100.0 * total), 1);
+    for (int i = 0; i < CHR_HISTOGRAM_BUCKETS; ++i) {
+        if (rank <= counts[i]) {
+            return (NSTimeInterval)MIN(chr_histogram_value(i), maximum) / NSEC_PER_SEC;
+        }
+        rank -= counts[i];
+    }
+    return (NSTimeInterval)maximum / NSEC_PER_SEC;
+}
+
+
+#pragma mark - CHRTimerStatistics Class Extension
+
+@interface CHRTimerStatistics () {
+    _Atomic(uint64_t)   _fires;
+    _Atomic(uint64_t)   _skips;
+    chr_histogram_t     _lateness;
+    chr_histogram_t     _duration;
+}
+
+@end
+
+
+#pragma mark - CHRTimerStatistics Implementation
+
+@implementation CHRTimerStatistics
+
+#pragma mark Creating Timer Statistics
+
+- (instancetype)init
+{
+    return [super init];
+}
+
++ (CHRTimerStatistics *)statistics
+{
+    return [[CHRTimerStatistics alloc]init];
+}
+
+#pragma mark Reading Timer Statistics
+
+- (NSTimeInterval)latenessAtPercentile:(double)percentile
+{
+    return chr_histogram_percentile(&_lateness, percentile);
+}
+
+- (NSTimeInterval)durationAtPercentile:(double)percentile
+{
+    return chr_histogram_percentile(&_duration, percentile);
+}
+
+- (void)reset
+{
+    chr_histogram_reset(&_lateness);
+    chr_histogram_reset(&_duration);
+    atomic_store_explicit(&_fires, 0, memory_order_relaxed);
+    atomic_store_explicit(&_skips, 0, memory_order_relaxed);
+}
+
+#pragma mark Recording
+
+- (void)recordLateness:(uint64_t)lateness duration:(uint64_t)duration skipped:(uint64_t)skipped
+{
+    chr_histogram_record(&_lateness, lateness);
+    chr_histogram_record(&_duration, duration);
+    if (skipped) {
+        atomic_fetch_add_explicit(&_skips, skipped, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&_fires, 1, memory_order_relaxed);
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; fires = %llu; skips = %llu; "
+            @"lateness p50/p99/p999/max = %.3f/%.3f/%.3f/%.3f ms; "
+            @"duration p50/p99/p999/max = %.3f/%.3f/%.3f/%.3f ms>",
+            [self class], self, self.fires, self.skips,
+            [self latenessAtPercentile:50.0] * 1000.0, [self latenessAtPercentile:99.0] * 1000.0,
+            [self latenessAtPercentile:99.9] * 1000.0, self.maximumLateness * 1000.0,
+            [self durationAtPercentile:50.0] * 1000.0, [self durationAtPercentile:99.0] * 1000.0,
+            [self durationAtPercentile:99.9] * 1000.0, self.maximumDuration * 1000.0];
+}
+
+#pragma mark Getters
+
+- (uint64_t)fires
+{
+    return atomic_load_explicit(&_fires, memory_order_relaxed);
+}
+
+- (uint64_t)skips
+{
+    return atomic_load_explicit(&_skips, memory_order_relaxed);
+}
+
+- (NSTimeInterval)maximumLateness
+{
+    return (NSTimeInterval)atomic_load_explicit(&_lateness.maximum, memory_order_relaxed) / NSEC_PER_SEC;
+}
+
+- (NSTimeInterval)maximumDuration
+{
+    return (NSTimeInterval)atomic_load_explicit(&_duration.maximum, memory_order_relaxed) / NSEC_PER_SEC;
+}
+
+@end
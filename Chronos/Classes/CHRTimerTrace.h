@@ -0,0 +1,128 @@
+//
+//  CHRTimerTrace.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - Type Definitions
+
+/**
+ The kinds of timer events recorded while tracing is enabled.
+ */
+typedef NS_ENUM(NSInteger, CHRTimerTraceEvent) {
+    /** The timer's next firing was programmed. */
+    CHRTimerTraceEventArm           = 0,
+    /** The timer's source or scheduler fired. */
+    CHRTimerTraceEventFire          = 1,
+    /** An execution block started running. */
+    CHRTimerTraceEventExecuteBegin  = 2,
+    /** An execution block returned, or an asynchronous one completed. */
+    CHRTimerTraceEventExecuteEnd    = 3,
+    /** The timer was paused. */
+    CHRTimerTraceEventPause         = 4,
+    /** A previously started timer was started again. */
+    CHRTimerTraceEventResume        = 5,
+    /** The timer was canceled. */
+    CHRTimerTraceEventCancel        = 6
+};
+
+
+#pragma mark - CHRTimerTrace Interface
+
+/**
+ The CHRTimerTrace class controls an opt-in trace of what every
+ CHRDispatchTimer and CHRVariableTimer is doing, for diagnosing latency spikes.
+ 
+ While tracing is enabled, timers record their arm, fire, execution, pause,
+ resume and cancel events with a monotonic timestamp into a lock-free ring
+ buffer owned by the recording thread. Each thread keeps its most recent 4096
+ events. While tracing is disabled, a firing costs a single branch.
+ 
+ The recorded events can be exported in the Chrome trace event format and
+ opened in chrome://tracing or Perfetto. Executions are exported as async
+ slices keyed by timer and invocation, since asynchronous executions may
+ complete on another thread.
+ */
+@interface CHRTimerTrace : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Controlling the Trace
+// -----
+
+#pragma mark Controlling the Trace
+
+/**
+ Enables or disables tracing for every timer in the process. Events already
+ recorded are kept.
+ 
+ @param     enabled
+            YES, to start recording events.
+ */
++ (void)setEnabled:(BOOL)enabled;
+
+/**
+ Returns whether tracing is enabled.
+ 
+ @return    YES, if timers are recording events.
+ */
++ (BOOL)isEnabled;
+
+/**
+ Discards every event recorded so far.
+ */
++ (void)clear;
+
+// -----
+// @name Exporting the Trace
+// -----
+
+#pragma mark Exporting the Trace
+
+/**
+ Returns the recorded events as a Chrome trace event JSON document.
+ 
+ Events recorded while the export runs may or may not be included.
+ 
+ @return    The UTF-8 encoded JSON document.
+ */
++ (NSData *)chromeTraceData;
+
+/**
+ Writes the recorded events to a file as a Chrome trace event JSON document.
+ 
+ @param     path
+            The path of the file to write.
+ @param     error
+            On failure, the error that occurred. May be NULL.
+ @return    YES, if the file was written.
+ */
++ (BOOL)writeChromeTraceToFile:(NSString *)path error:(NSError **)error;
+
+@end
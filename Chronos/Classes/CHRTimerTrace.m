@@ -0,0 +1,228 @@
+//
+//  CHRTimerTrace.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimerTrace.h"
+#import "CHRTimerInternal.h"
+#import "CHRTimerTraceInternal.h"
+#import <pthread.h>
+#import <unistd.h>
+
+
+#pragma mark - Constants and Functions
+
+#define CHR_TRACE_CAPACITY      4096
+#define CHR_TRACE_MASK          (CHR_TRACE_CAPACITY - 1)
+
+atomic_bool chr_trace_enabled = false;
+
+struct chr_trace_event_s {
+    uint64_t            timestamp;  // chr_now()
+    uint64_t            thread;
+    uintptr_t           timer;
+    uint64_t            invocation;
+    int32_t             type;
+};
+
+typedef struct chr_trace_buffer_s *chr_trace_buffer_t;
+
+/**
+ A ring buffer written by a single thread. Buffers are never freed; a buffer
+ whose thread exited is handed to the next thread that starts tracing.
+ */
+struct chr_trace_buffer_s {
+    chr_trace_buffer_t  next;       // immutable once published
+    atomic_bool         owned;
+    _Atomic(uint64_t)   head;       // number of events ever written
+    _Atomic(uint64_t)   base;       // events before this one were cleared
+    struct chr_trace_event_s events[CHR_TRACE_CAPACITY];
+};
+
+static _Atomic(chr_trace_buffer_t) chr_trace_buffers;
+
+static void chr_trace_retire(void *buffer) {
+    atomic_store_explicit(&((chr_trace_buffer_t)buffer)->owned, false, memory_order_release);
+}
+
+static pthread_key_t chr_trace_key(void) {
+    static pthread_key_t key;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pthread_key_create(&key, chr_trace_retire);
+    });
+    return key;
+}
+
+static uint64_t chr_trace_thread(void) {
+#if __APPLE__
+    uint64_t thread = 0;
+    pthread_threadid_np(NULL, &thread);
+    return thread;
+#else
+    return (uint64_t)(uintptr_t)pthread_self();
+#endif
+}
+
+/**
+ Returns the calling thread's buffer, claiming a retired one or publishing a
+ new one the first time the thread records an event.
+ */
+static chr_trace_buffer_t chr_trace_buffer(void) {
+    pthread_key_t key = chr_trace_key();
+    chr_trace_buffer_t buffer = pthread_getspecific(key);
+    if (buffer) {
+        return buffer;
+    }
+    for (buffer = atomic_load(&chr_trace_buffers); buffer; buffer = buffer->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&buffer->owned, &expected, true)) {
+            pthread_setspecific(key, buffer);
+            return buffer;
+        }
+    }
+    buffer = calloc(1, sizeof(struct chr_trace_buffer_s));
+    atomic_init(&buffer->owned, true);
+    buffer->next = atomic_load(&chr_trace_buffers);
+    while (!atomic_compare_exchange_weak(&chr_trace_buffers, &buffer->next, buffer)) {
+        // buffer->next was reloaded, try again
+    }
+    pthread_setspecific(key, buffer);
+    return buffer;
+}
+
+void chr_trace_record(CHRTimerTraceEvent event, const void *timer, NSUInteger invocation) {
+    chr_trace_buffer_t buffer = chr_trace_buffer();
+    uint64_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    struct chr_trace_event_s *entry = &buffer->events[head & CHR_TRACE_MASK];
+    entry->timestamp = chr_now();
+    entry->thread = chr_trace_thread();
+    entry->timer = (uintptr_t)timer;
+    entry->invocation = invocation;
+    entry->type = (int32_t)event;
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+}
+
+static NSString * chr_trace_name(int32_t type) {
+    switch (type) {
+        case CHRTimerTraceEventArm:
+            return @"arm";
+        case CHRTimerTraceEventFire:
+            return @"fire";
+        case CHRTimerTraceEventExecuteBegin:
+        case CHRTimerTraceEventExecuteEnd:
+            return @"execute";
+        case CHRTimerTraceEventPause:
+            return @"pause";
+        case CHRTimerTraceEventResume:
+            return @"resume";
+        case CHRTimerTraceEventCancel:
+            return @"cancel";
+        default:
+            return @"unknown";
+    }
+}
+
+/**
+ Converts a recorded event into a Chrome trace event.
+ */
+static NSDictionary * chr_trace_json(const struct chr_trace_event_s *event, NSNumber *pid) {
+    NSString *timer = [NSString stringWithFormat:@"0x%lx", (unsigned long)event->timer];
+    NSMutableDictionary *json = [@{@"name": chr_trace_name(event->type),
+                                   @"cat": @"timer",
+                                   @"ts": @(event->timestamp / 1000.0),
+                                   @"pid": pid,
+                                   @"tid": @(event->thread),
+                                   @"args": @{@"timer": timer, @"invocation": @(event->invocation)}} mutableCopy];
+    if (event->type == CHRTimerTraceEventExecuteBegin || event->type == CHRTimerTraceEventExecuteEnd) {
+        json[@"ph"] = (event->type == CHRTimerTraceEventExecuteBegin)? @"b" : @"e";
+        json[@"id"] = [NSString stringWithFormat:@"%@:%llu", timer, (unsigned long long)event->invocation];
+    } else {
+        json[@"ph"] = @"i";
+        json[@"s"] = @"t";
+    }
+    return json;
+}
+
+
+#pragma mark - CHRTimerTrace Implementation
+
+@implementation CHRTimerTrace
+
+#pragma mark Controlling the Trace
+
++ (void)setEnabled:(BOOL)enabled
+{
+    atomic_store(&chr_trace_enabled, (bool)enabled);
+}
+
++ (BOOL)isEnabled
+{
+    return atomic_load(&chr_trace_enabled);
+}
+
++ (void)clear
+{
+    for (chr_trace_buffer_t buffer = atomic_load(&chr_trace_buffers); buffer; buffer = buffer->next) {
+        atomic_store(&buffer->base, atomic_load(&buffer->head));
+    }
+}
+
+#pragma mark Exporting the Trace
+
++ (NSData *)chromeTraceData
+{
+    NSNumber *pid = @(getpid());
+    NSMutableArray *events = [NSMutableArray array];
+    struct chr_trace_event_s *copy = malloc(sizeof(struct chr_trace_event_s) * CHR_TRACE_CAPACITY);
+    for (chr_trace_buffer_t buffer = atomic_load(&chr_trace_buffers); buffer; buffer = buffer->next) {
+        uint64_t head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+        uint64_t first = MAX(atomic_load(&buffer->base), (head > CHR_TRACE_CAPACITY)? head - CHR_TRACE_CAPACITY : 0);
+        for (uint64_t i = first; i < head; ++i) {
+            copy[i - first] = buffer->events[i & CHR_TRACE_MASK];
+        }
+        // The owning thread may have overwritten the oldest events while they were
+        // copied. The fence orders the copy before the re-read of the head, and the
+        // slot of event `after` may be mid-write, so it invalidates one event more.
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+        uint64_t valid = (after + 1 > CHR_TRACE_CAPACITY)? after + 1 - CHR_TRACE_CAPACITY : 0;
+        for (uint64_t i = MAX(first, valid); i < head; ++i) {
+            [events addObject:chr_trace_json(&copy[i - first], pid)];
+        }
+    }
+    free(copy);
+    return [NSJSONSerialization dataWithJSONObject:@{@"traceEvents": events, @"displayTimeUnit": @"ms"}
+                                           options:0
+                                             error:NULL];
+}
+
++ (BOOL)writeChromeTraceToFile:(NSString *)path error:(NSError **)error
+{
+    return [[self chromeTraceData] writeToFile:path options:NSDataWritingAtomic error:error];
+}
+
+@end
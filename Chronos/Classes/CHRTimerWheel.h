@@ -0,0 +1,95 @@
+//
+//  CHRTimerWheel.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRTimerScheduler.h"
+
+
+#pragma mark - CHRTimerWheel Interface
+
+/**
+ The CHRTimerWheel class multiplexes many logical timers onto a single Grand
+ Central Dispatch timer source using a hierarchical timing wheel.
+
+ Timers registered with a wheel are armed and canceled in constant time and
+ their firing times are rounded up to the wheel's resolution, which makes a
+ wheel well suited to large numbers of coarse timers such as per-connection
+ keepalives. The underlying timer source only wakes up while at least one timer
+ on the wheel is armed.
+
+ To drive a timer from a wheel, pass the wheel as the scheduler of a
+ CHRDispatchTimer or CHRVariableTimer. The leeway requested by a timer is
+ ignored; the resolution of the wheel bounds how late a timer may fire.
+ */
+@interface CHRTimerWheel : NSObject <CHRTimerScheduler>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -----
+// @name Creating a Timer Wheel
+// -----
+
+#pragma mark Creating a Timer Wheel
+
+/**
+ Initializes a CHRTimerWheel object.
+
+ @param     resolution
+            The duration of a single tick of the wheel, in seconds. Timers
+            registered with the wheel fire on tick boundaries.
+ @return    The newly initialized CHRTimerWheel object.
+ */
+- (instancetype)initWithResolution:(NSTimeInterval)resolution NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRTimerWheel object.
+
+ @param     resolution
+            The duration of a single tick of the wheel, in seconds. Timers
+            registered with the wheel fire on tick boundaries.
+ @return    The newly created CHRTimerWheel object.
+ */
++ (CHRTimerWheel *)wheelWithResolution:(NSTimeInterval)resolution;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The duration of a single tick of the receiver, in seconds.
+ */
+@property (readonly) NSTimeInterval resolution;
+
+/**
+ The number of timers currently armed on the receiver.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+@end
@@ -0,0 +1,320 @@
+//
+//  CHRTimerWheel.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRTimerWheel.h"
+#import "CHRTimerInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - Constants and Functions
+
+static NSString * const CHRTimerWheelQueueNamePrefix = @"com.chronus.CHRTimerWheel";
+
+#define CHR_WHEEL_LEVELS        6
+#define CHR_WHEEL_SLOT_BITS     6
+#define CHR_WHEEL_SLOTS         (1 << CHR_WHEEL_SLOT_BITS)
+#define CHR_WHEEL_SLOT_MASK     (CHR_WHEEL_SLOTS - 1)
+#define CHR_WHEEL_MAX_DELTA     ((1ULL << (CHR_WHEEL_LEVELS * CHR_WHEEL_SLOT_BITS)) - 1)
+
+typedef struct chr_wheel_entry_s *chr_wheel_entry_t;
+
+struct chr_wheel_entry_s {
+    chr_wheel_entry_t   next;
+    chr_wheel_entry_t   *pprev;     // NULL while the entry is disarmed
+    uint64_t            deadline;   // absolute tick
+    uint64_t            period;     // ticks, 0 for a single firing
+    void                *queue;     // retained dispatch_queue_t
+    void                *handler;   // retained dispatch_block_t
+};
+
+static inline void chr_wheel_link(chr_wheel_entry_t *head, chr_wheel_entry_t entry) {
+    entry->next = *head;
+    if (entry->next) {
+        entry->next->pprev = &entry->next;
+    }
+    *head = entry;
+    entry->pprev = head;
+}
+
+static inline void chr_wheel_unlink(chr_wheel_entry_t entry) {
+    *entry->pprev = entry->next;
+    if (entry->next) {
+        entry->next->pprev = entry->pprev;
+    }
+    entry->next = NULL;
+    entry->pprev = NULL;
+}
+
+
+#pragma mark - CHRTimerWheel Class Extension
+
+@interface CHRTimerWheel () {
+    pthread_mutex_t     _lock;
+    uint64_t            _tick;          // nanoseconds per tick
+    uint64_t            _origin;        // chr_now() at tick 0
+    uint64_t            _current;       // last processed tick
+    uint64_t            _masks[CHR_WHEEL_LEVELS];
+    chr_wheel_entry_t   _slots[CHR_WHEEL_LEVELS][CHR_WHEEL_SLOTS];
+    NSUInteger          _count;
+    bool                _ticking;
+}
+
+@property (readonly) dispatch_queue_t   queue;
+@property (readonly) dispatch_source_t  timer;
+
+@end
+
+
+#pragma mark - CHRTimerWheel Implementation
+
+@implementation CHRTimerWheel
+
+- (void)dealloc
+{
+    if (!_ticking) {
+        dispatch_resume(_timer);
+    }
+    dispatch_source_cancel(_timer);
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Timer Wheel
+
+- (instancetype)initWithResolution:(NSTimeInterval)resolution
+{
+    if (self = [super init]) {
+        NSString *queueName = [NSString stringWithFormat:@"%@.%p", CHRTimerWheelQueueNamePrefix, self];
+        _queue = dispatch_queue_create([queueName UTF8String], DISPATCH_QUEUE_SERIAL);
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+        if (!_timer) {
+            NSLog(@"%@", @"Failed to create dispatch source for timer wheel.");
+            return nil;
+        }
+        pthread_mutex_init(&_lock, NULL);
+        _resolution = resolution;
+        _tick = MAX(chr_nanoseconds(resolution), 1);
+        _origin = chr_now();
+        __weak CHRTimerWheel *weak = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weak advance];
+        });
+    }
+    return self;
+}
+
++ (CHRTimerWheel *)wheelWithResolution:(NSTimeInterval)resolution
+{
+    return [[CHRTimerWheel alloc]initWithResolution:resolution];
+}
+
+#pragma mark Managing Entries
+
+- (CHRTimerSchedulerEntry)createEntryWithQueue:(dispatch_queue_t)queue handler:(dispatch_block_t)handler
+{
+    chr_wheel_entry_t entry = calloc(1, sizeof(struct chr_wheel_entry_s));
+    entry->queue = (__bridge_retained void *)queue;
+    entry->handler = (__bridge_retained void *)[handler copy];
+    return entry;
+}
+
+- (void)armEntry:(CHRTimerSchedulerEntry)handle
+           delay:(uint64_t)delay
+        interval:(uint64_t)interval
+          leeway:(uint64_t)leeway
+{
+    chr_wheel_entry_t entry = handle;
+    pthread_mutex_lock(&_lock);
+    if (entry->pprev) {
+        [self removeEntry:entry];
+    }
+    if (_count == 0) {
+        _current = (chr_now() - _origin) / _tick;
+    }
+    uint64_t deadline = (chr_now() - _origin + delay + _tick - 1) / _tick;
+    entry->deadline = MAX(deadline, _current + 1);
+    entry->period = (interval)? MAX((interval + _tick - 1) / _tick, 1) : 0;
+    [self insertEntry:entry];
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)disarmEntry:(CHRTimerSchedulerEntry)handle
+{
+    chr_wheel_entry_t entry = handle;
+    pthread_mutex_lock(&_lock);
+    if (entry->pprev) {
+        [self removeEntry:entry];
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)destroyEntry:(CHRTimerSchedulerEntry)handle
+{
+    chr_wheel_entry_t entry = handle;
+    [self disarmEntry:entry];
+    CFBridgingRelease(entry->queue);
+    CFBridgingRelease(entry->handler);
+    free(entry);
+}
+
+#pragma mark Private
+
+/**
+ Links the entry into the slot matching its deadline. Must be called with the
+ lock held.
+ */
+- (void)insertEntry:(chr_wheel_entry_t)entry
+{
+    uint64_t delta = (entry->deadline > _current)? MIN(entry->deadline - _current, CHR_WHEEL_MAX_DELTA) : 0;
+    uint64_t expires = _current + delta;
+    int level = 0;
+    while (delta >= CHR_WHEEL_SLOTS && level < CHR_WHEEL_LEVELS - 1) {
+        delta >>= CHR_WHEEL_SLOT_BITS;
+        level++;
+    }
+    int slot = (expires >> (level * CHR_WHEEL_SLOT_BITS)) & CHR_WHEEL_SLOT_MASK;
+    chr_wheel_link(&_slots[level][slot], entry);
+    _masks[level] |= (1ULL << slot);
+    if (_count++ == 0 && !_ticking) {
+        _ticking = true;
+        dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, _tick), _tick, chr_leeway(_resolution));
+        dispatch_resume(_timer);
+    }
+}
+
+/**
+ Unlinks an armed entry. Must be called with the lock held.
+ */
+- (void)removeEntry:(chr_wheel_entry_t)entry
+{
+    chr_wheel_unlink(entry);
+    _count--;
+}
+
+/**
+ Detaches every entry in the given slot, marking each one disarmed, and returns
+ them as a list chained through their next pointers. Must be called with the
+ lock held.
+ */
+- (chr_wheel_entry_t)detachSlot:(int)slot level:(int)level
+{
+    chr_wheel_entry_t list = _slots[level][slot];
+    _slots[level][slot] = NULL;
+    _masks[level] &= ~(1ULL << slot);
+    for (chr_wheel_entry_t entry = list; entry; entry = entry->next) {
+        entry->pprev = NULL;
+        _count--;
+    }
+    return list;
+}
+
+/**
+ Moves the entries of the higher level slots that cover the current tick down
+ the hierarchy. Must be called with the lock held.
+ */
+- (void)cascade
+{
+    int top = 0;
+    while (top < CHR_WHEEL_LEVELS - 1 &&
+           ((_current >> ((top + 1) * CHR_WHEEL_SLOT_BITS)) << ((top + 1) * CHR_WHEEL_SLOT_BITS)) == _current) {
+        top++;
+    }
+    for (int level = top; level > 0; level--) {
+        int slot = (_current >> (level * CHR_WHEEL_SLOT_BITS)) & CHR_WHEEL_SLOT_MASK;
+        chr_wheel_entry_t entry = [self detachSlot:slot level:level];
+        while (entry) {
+            chr_wheel_entry_t next = entry->next;
+            [self insertEntry:entry];
+            entry = next;
+        }
+    }
+}
+
+/**
+ Fires every entry in the level 0 slot of the current tick. Must be called with
+ the lock held.
+ */
+- (void)expire
+{
+    int slot = _current & CHR_WHEEL_SLOT_MASK;
+    chr_wheel_entry_t entry = [self detachSlot:slot level:0];
+    while (entry) {
+        chr_wheel_entry_t next = entry->next;
+        if (entry->period) {
+            entry->deadline += entry->period;
+            if (entry->deadline <= _current) {
+                entry->deadline = _current + entry->period;
+            }
+            [self insertEntry:entry];
+        }
+        dispatch_async((__bridge dispatch_queue_t)entry->queue, (__bridge dispatch_block_t)entry->handler);
+        entry = next;
+    }
+}
+
+/**
+ Processes every tick that has elapsed since the last call. Runs on the wheel's
+ queue.
+ */
+- (void)advance
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t target = (chr_now() - _origin) / _tick;
+    while (_current < target && _count > 0) {
+        if (_masks[0] == 0) {
+            // Nothing can expire before the next cascade, skip ahead to it.
+            uint64_t boundary = _current | CHR_WHEEL_SLOT_MASK;
+            if (boundary >= target) {
+                _current = target;
+                break;
+            }
+            _current = boundary;
+        }
+        _current++;
+        if ((_current & CHR_WHEEL_SLOT_MASK) == 0) {
+            [self cascade];
+        }
+        [self expire];
+    }
+    if (_count == 0 && _ticking) {
+        _ticking = false;
+        dispatch_suspend(_timer);
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark Getters
+
+- (NSUInteger)count
+{
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _count;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+@end
@@ -28,7 +28,9 @@
 
 @import Foundation;
 #import "CHRRepeatingTimer.h"
-#import <libkern/OSAtomic.h>
+#import "CHRTimerScheduler.h"
+#import "CHRLeewayPolicy.h"
+#import "CHRExecutionQueuePool.h"
 
 
 #pragma mark - Forward Declarations
@@ -46,6 +48,56 @@
  */
 typedef NSTimeInterval (^CHRVariableTimerIntervalProvider)(__weak CHRVariableTimer *timer, NSUInteger nextInvocation);
 
+/**
+ The block that supplies the intervals of several upcoming firings at once.
+ 
+ @param     timer
+            The timer requesting intervals.
+ @param     nextInvocation
+            The invocation whose interval should be written to intervals[0].
+ @param     intervals
+            The buffer to fill with consecutive intervals, in seconds.
+ @param     count
+            The capacity of the buffer.
+ @return    The number of intervals written, at least 1 and at most count.
+ */
+typedef NSUInteger (^CHRVariableTimerBatchIntervalProvider)(__weak CHRVariableTimer *timer,
+                                                            NSUInteger nextInvocation,
+                                                            NSTimeInterval *intervals,
+                                                            NSUInteger count);
+
+/**
+ The block to execute every time an asynchronous timer fires. The next firing
+ is not scheduled until the completion block has been called.
+ 
+ @param     timer
+            The timer that fired.
+ @param     invocation
+            The current invocation number. The first invocation is 0.
+ @param     completion
+            The block to call, from any thread, once the work started by this
+            invocation has finished. Calls after the first are ignored.
+ */
+typedef void (^CHRVariableTimerAsyncExecutionBlock)(__weak CHRVariableTimer *timer,
+                                                    NSUInteger invocation,
+                                                    dispatch_block_t completion);
+
+/**
+ Determines what a timer using absolute deadlines does when its next deadline
+ has already passed, typically because the execution block ran long.
+ */
+typedef NS_ENUM(NSInteger, CHRMissedDeadlinePolicy) {
+    /** Fires immediately and keeps the deadline chain, so later firings
+     catch up with the schedule. */
+    CHRMissedDeadlinePolicyFireImmediately  = 0,
+    /** Advances the deadline by whole intervals to the first one in the
+     future, dropping the missed firings. */
+    CHRMissedDeadlinePolicySkip             = 1,
+    /** Fires immediately and restarts the deadline chain from the current
+     time. */
+    CHRMissedDeadlinePolicyRebase           = 2
+};
+
 
 #pragma mark - CHRVariableTimer Interface
 
@@ -70,7 +122,8 @@ typedef NSTimeInterval (^CHRVariableTimerIntervalProvider)(__weak CHRVariableTim
 /**
  Initializes a CHRVariableTimer object.
  
- The execution block will be executed on the default execution queue.
+ The execution block will be executed on the default execution queue, a serial
+ queue taken from the shared CHRExecutionQueuePool.
  
  @param     intervalProvider
             The block that provides intervals for timer firing.
@@ -81,6 +134,25 @@ typedef NSTimeInterval (^CHRVariableTimerIntervalProvider)(__weak CHRVariableTim
 - (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
                           executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock;
 
+/**
+ Initializes a CHRVariableTimer object.
+ 
+ The execution block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool of the given priority class, so it is never queued
+ behind the execution blocks of timers in other classes.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     priority
+            The priority class of the timer.
+ @return    The newly initialized CHRVariableTimer object.
+ */
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                          executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                                priority:(CHRTimerPriority)priority;
+
 /**
  Initializes a CHRVariableTimer object.
  
@@ -112,13 +184,55 @@ typedef NSTimeInterval (^CHRVariableTimerIntervalProvider)(__weak CHRVariableTim
 - (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
                   executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
                   executionQueue:(dispatch_queue_t)executionQueue
+                    failureBlock:(CHRTimerInitFailureBlock)failureBlock;
+
+/**
+ Initializes a CHRVariableTimer object.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @param     leewayPolicy
+            The policy that determines how much the timer may be deferred.
+ @param     failureBlock
+            The block to execute if the timer fails to initialize.
+ @return    The newly initialized CHRVariableTimer object.
+ */
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+                    leewayPolicy:(CHRLeewayPolicy *)leewayPolicy
                     failureBlock:(CHRTimerInitFailureBlock)failureBlock
                         NS_DESIGNATED_INITIALIZER;
 
+/**
+ Initializes a CHRVariableTimer object that is driven by a scheduler instead of
+ its own dispatch source.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @param     scheduler
+            The scheduler that drives the timer, such as a CHRTimerWheel.
+ @return    The newly initialized CHRVariableTimer object.
+ */
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                  executionQueue:(dispatch_queue_t)executionQueue
+                       scheduler:(id<CHRTimerScheduler>)scheduler
+                        NS_DESIGNATED_INITIALIZER;
+
 /**
  Creates a CHRVariableTimer object.
  
- The execution block will be executed on the default execution queue.
+ The execution block will be executed on the default execution queue, a serial
+ queue taken from the shared CHRExecutionQueuePool.
  
  @param     intervalProvider
             The block that provides intervals for timer firing.
@@ -129,6 +243,25 @@ typedef NSTimeInterval (^CHRVariableTimerIntervalProvider)(__weak CHRVariableTim
 + (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
                                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock;
 
+/**
+ Creates a CHRVariableTimer object.
+ 
+ The execution block will be executed on a serial queue taken from the shared
+ CHRExecutionQueuePool of the given priority class, so it is never queued
+ behind the execution blocks of timers in other classes.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     priority
+            The priority class of the timer.
+ @return    The newly initialized CHRVariableTimer object.
+ */
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                                 executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                                       priority:(CHRTimerPriority)priority;
+
 /**
  Creates a CHRVariableTimer object.
  
@@ -162,6 +295,115 @@ typedef NSTimeInterval (^CHRVariableTimerIntervalProvider)(__weak CHRVariableTim
                                  executionQueue:(dispatch_queue_t)executionQueue
                                    failureBlock:(CHRTimerInitFailureBlock)failureBlock;
 
+/**
+ Creates a CHRVariableTimer object.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @param     leewayPolicy
+            The policy that determines how much the timer may be deferred.
+ @param     failureBlock
+            The block to execute if the timer fails to initialize.
+ @return    The newly initialized CHRVariableTimer object.
+ */
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                                 executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                                 executionQueue:(dispatch_queue_t)executionQueue
+                                   leewayPolicy:(CHRLeewayPolicy *)leewayPolicy
+                                   failureBlock:(CHRTimerInitFailureBlock)failureBlock;
+
+/**
+ Creates a CHRVariableTimer object that is driven by a scheduler instead of its
+ own dispatch source.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     executionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the executionBlock.
+ @param     scheduler
+            The scheduler that drives the timer, such as a CHRTimerWheel.
+ @return    The newly initialized CHRVariableTimer object.
+ */
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                                 executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                                 executionQueue:(dispatch_queue_t)executionQueue
+                                      scheduler:(id<CHRTimerScheduler>)scheduler;
+
+// -----
+// @name Creating an Asynchronous Variable Timer
+// -----
+
+#pragma mark Creating an Asynchronous Variable Timer
+
+/**
+ Initializes a CHRVariableTimer object whose execution block starts
+ asynchronous work. The interval to the next firing is requested, and the
+ timer armed, only once the execution block's completion has been called, so
+ the work of two invocations never overlaps and no queue thread waits for it.
+ 
+ The execution block will be executed on the default execution queue, a serial
+ queue taken from the shared CHRExecutionQueuePool.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     asyncExecutionBlock
+            The block to execute at the given interval.
+ @return    The newly initialized CHRVariableTimer object.
+ */
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                     asyncExecutionBlock:(CHRVariableTimerAsyncExecutionBlock)asyncExecutionBlock;
+
+/**
+ Initializes a CHRVariableTimer object whose execution block starts
+ asynchronous work.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     asyncExecutionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the asyncExecutionBlock.
+ @return    The newly initialized CHRVariableTimer object.
+ */
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                     asyncExecutionBlock:(CHRVariableTimerAsyncExecutionBlock)asyncExecutionBlock
+                          executionQueue:(dispatch_queue_t)executionQueue;
+
+/**
+ Creates a CHRVariableTimer object whose execution block starts asynchronous
+ work.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     asyncExecutionBlock
+            The block to execute at the given interval.
+ @return    The newly initialized CHRVariableTimer object.
+ */
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                            asyncExecutionBlock:(CHRVariableTimerAsyncExecutionBlock)asyncExecutionBlock;
+
+/**
+ Creates a CHRVariableTimer object whose execution block starts asynchronous
+ work.
+ 
+ @param     intervalProvider
+            The block that provides intervals for timer firing.
+ @param     asyncExecutionBlock
+            The block to execute at the given interval.
+ @param     executionQueue
+            The queue that should execute the asyncExecutionBlock.
+ @return    The newly initialized CHRVariableTimer object.
+ */
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                            asyncExecutionBlock:(CHRVariableTimerAsyncExecutionBlock)asyncExecutionBlock
+                                 executionQueue:(dispatch_queue_t)executionQueue;
+
 // -----
 // @name Properties
 // -----
@@ -173,4 +415,83 @@ typedef NSTimeInterval (^CHRVariableTimerIntervalProvider)(__weak CHRVariableTim
  */
 @property (readonly, copy) CHRVariableTimerIntervalProvider intervalProvider;
 
+/**
+ The receiver's asynchronous execution block, or nil if the receiver was
+ created with a synchronous execution block. The invocations of an
+ asynchronous timer never overlap, so its overlap policy is ignored.
+ */
+@property (readonly, copy) CHRVariableTimerAsyncExecutionBlock asyncExecutionBlock;
+
+/**
+ The longest time, in seconds, an asynchronous timer waits for the completion
+ of an invocation before scheduling the next firing anyway. Defaults to 0,
+ which means the timer waits indefinitely. Set this property before starting
+ the timer.
+ */
+@property (nonatomic) NSTimeInterval completionTimeout;
+
+/**
+ The number of invocations whose completion did not arrive within the
+ completion timeout.
+ */
+@property (atomic, readonly) NSUInteger timedOutCompletions;
+
+/**
+ The policy that determines how much the receiver's firings may be deferred.
+ Timers driven by a scheduler use the default policy.
+ */
+@property (readonly) CHRLeewayPolicy *leewayPolicy;
+
+/**
+ The scheduler that drives the receiver, or nil if the receiver owns its own
+ dispatch source.
+ */
+@property (readonly) id<CHRTimerScheduler> scheduler;
+
+/**
+ The priority class whose shared pool provided the receiver's execution queue.
+ Timers created with an execution queue report CHRTimerPriorityDefault.
+ */
+@property (readonly) CHRTimerPriority priority;
+
+/**
+ NO, the default, if each interval is measured from the moment the execution
+ block returns. YES, if each interval is added to the previous deadline, so
+ that slow execution blocks do not push back later firings. Set this property
+ before starting the timer.
+ */
+@property (nonatomic) BOOL usesAbsoluteDeadlines;
+
+/**
+ What the receiver does when an absolute deadline has already passed. Defaults
+ to CHRMissedDeadlinePolicyFireImmediately.
+ */
+@property (nonatomic) CHRMissedDeadlinePolicy missedDeadlinePolicy;
+
+// -----
+// @name Batching Intervals
+// -----
+
+#pragma mark Batching Intervals
+
+/**
+ Creates an interval provider that requests intervals from the given batch
+ provider several at a time and hands them out one by one, so the batch
+ provider is called once per batchSize firings.
+ 
+ The returned provider is safe to call from several threads at once; calls to
+ the batch provider are serialized. It may be shared between timers, but each
+ timer asking for an invocation outside the cached batch replaces that batch,
+ so timers sharing one provider defeat the batching. Create one provider per
+ timer.
+ 
+ @param     batchSize
+            The number of intervals to request at once.
+ @param     batchProvider
+            The block that supplies the intervals.
+ @return    An interval provider for use with a CHRVariableTimer.
+ */
++ (CHRVariableTimerIntervalProvider)intervalProviderWithBatchSize:(NSUInteger)batchSize
+                                                     batchProvider:(CHRVariableTimerBatchIntervalProvider)batchProvider;
+
 @end
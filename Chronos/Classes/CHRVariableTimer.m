@@ -27,26 +27,51 @@
 #pragma mark - Imports
 
 #import "CHRVariableTimer.h"
+#import "CHRExecutionGate.h"
+#import "CHRExecutionQueuePool.h"
+#import "CHRScheduleSnapshotInternal.h"
 #import "CHRTimerInternal.h"
+#import "CHRTimerRegistryInternal.h"
+#import "CHRTimerStatisticsInternal.h"
+#import "CHRTimerTraceInternal.h"
+#import <pthread.h>
 
 
-#pragma mark - Constants and Functions
+#pragma mark - Type Definitions
 
-static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus.CHRVariableTimer";
+/**
+ The state of a batched interval provider. The provider may be called from the
+ execution queue, a completion thread and the thread starting the timer at
+ once, so the cached batch is guarded by a lock.
+ */
+typedef struct chr_interval_batch_s {
+    pthread_mutex_t     lock;
+    NSUInteger          first;
+    NSUInteger          count;
+    NSTimeInterval      intervals[];
+} *chr_interval_batch_t;
 
 
 #pragma mark CHRVariableTimer Class Extension
 
 @interface CHRVariableTimer () {
-    volatile int32_t    _running;
-    volatile int32_t    _valid;
-    volatile NSUInteger _nextInvocation;
-    volatile NSUInteger _lastInvocation;
-    volatile bool       _executionBlockDidSetTimer;
-    volatile bool       _executing;
+    chr_state_t         _state;
+    chr_counter_t       _nextInvocation;
+    chr_counter_t       _lastInvocation;
+    chr_counter_t       _skippedInvocations;
+    chr_counter_t       _awaitingInvocation;    // invocation + 1 whose completion is awaited, or 0
+    chr_counter_t       _timedOutCompletions;
+    atomic_bool         _executionBlockDidSetTimer;
+    atomic_bool         _executing;
+    CHRTimerSchedulerEntry _entry;
+    _Atomic(uint64_t)   _deadline;
+    uint64_t            _armedInterval;         // nanoseconds leading up to _deadline
+    chr_registry_record_t _record;
+    BOOL                _schedulerClock;
 }
 
 @property (readonly) dispatch_source_t timer;
+@property (nonatomic) CHRExecutionGate *gate;
 
 @end
 
@@ -56,10 +81,16 @@ static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus
 @implementation CHRVariableTimer
 @synthesize executionBlock = _executionBlock;
 @synthesize executionQueue = _executionQueue;
+@synthesize statistics = _statistics;
+@synthesize overlapPolicy = _overlapPolicy;
+@synthesize maximumConcurrentExecutions = _maximumConcurrentExecutions;
+@synthesize maximumPendingExecutions = _maximumPendingExecutions;
+@synthesize skipBlock = _skipBlock;
 
 - (void)dealloc
 {
     [self cancel];
+    chr_registry_unregister(_record);
 }
 
 #pragma mark Creating a Variable Timer
@@ -67,13 +98,25 @@ static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus
 - (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
                           executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
 {
-    NSString *executionQueueName = [NSString stringWithFormat:@"%@.%p", CHRVariableTimerExecutionQueueNamePrefix, self];
-    dispatch_queue_t executionQueue = dispatch_queue_create([executionQueueName UTF8String], DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
     return [self initWithIntervalProvider:intervalProvider
                            executionBlock:executionBlock
                            executionQueue:executionQueue];
 }
 
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                          executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                                priority:(CHRTimerPriority)priority
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPoolForPriority:priority] queueForObject:self];
+    if (self = [self initWithIntervalProvider:intervalProvider
+                               executionBlock:executionBlock
+                               executionQueue:executionQueue]) {
+        _priority = priority;
+    }
+    return self;
+}
+
 - (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
                           executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
                           executionQueue:(dispatch_queue_t)executionQueue
@@ -88,10 +131,26 @@ static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus
                           executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
                           executionQueue:(dispatch_queue_t)executionQueue
                             failureBlock:(CHRTimerInitFailureBlock)failureBlock
+{
+    return [self initWithIntervalProvider:intervalProvider
+                           executionBlock:executionBlock
+                           executionQueue:executionQueue
+                             leewayPolicy:[CHRLeewayPolicy defaultPolicy]
+                             failureBlock:failureBlock];
+}
+
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                          executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                          executionQueue:(dispatch_queue_t)executionQueue
+                            leewayPolicy:(CHRLeewayPolicy *)leewayPolicy
+                            failureBlock:(CHRTimerInitFailureBlock)failureBlock
 {
     if (self = [super init]) {
         _executionQueue = executionQueue;
-        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _executionQueue);
+        _priority = CHRTimerPriorityDefault;
+        _leewayPolicy = leewayPolicy ?: [CHRLeewayPolicy defaultPolicy];
+        unsigned long mask = (_leewayPolicy.isStrict)? CHR_TIMER_STRICT : 0;
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, mask, _executionQueue);
         if (!_timer) {
             if (failureBlock) {
                 failureBlock();
@@ -100,23 +159,35 @@ static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus
             }
             return nil;
         }
-        _valid = CHRTimerStateValid;
+        atomic_init(&_state, CHRTimerStateStopped);
         _executionBlock = [executionBlock copy];
         _intervalProvider = [intervalProvider copy];
-        __weak CHRVariableTimer *weak = self;
-        dispatch_source_set_event_handler(_timer, ^{
-            CHRVariableTimer *strong = weak;
-            if (strong) {
-                strong->_executing = true;
-                strong->_nextInvocation = strong->_lastInvocation + 1;
-                strong->_executionBlock(weak, strong->_lastInvocation++);
-                strong->_executing = false;
-                if (!strong->_executionBlockDidSetTimer) {
-                    [strong schedule];
-                }
-                strong->_executionBlockDidSetTimer = false;
-            }
-        });
+        _maximumConcurrentExecutions = 1;
+        _maximumPendingExecutions = 1;
+        dispatch_source_set_event_handler(_timer, [self eventHandler]);
+        _record = chr_registry_register([self class], _executionQueue, 0.0);
+    }
+    return self;
+}
+
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                          executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                          executionQueue:(dispatch_queue_t)executionQueue
+                               scheduler:(id<CHRTimerScheduler>)scheduler
+{
+    if (self = [super init]) {
+        _executionQueue = executionQueue;
+        _priority = CHRTimerPriorityDefault;
+        _scheduler = scheduler;
+        _schedulerClock = [scheduler respondsToSelector:@selector(currentTime)];
+        _leewayPolicy = [CHRLeewayPolicy defaultPolicy];
+        atomic_init(&_state, CHRTimerStateStopped);
+        _executionBlock = [executionBlock copy];
+        _intervalProvider = [intervalProvider copy];
+        _maximumConcurrentExecutions = 1;
+        _maximumPendingExecutions = 1;
+        _entry = [_scheduler createEntryWithQueue:_executionQueue handler:[self eventHandler]];
+        _record = chr_registry_register([self class], _executionQueue, 0.0);
     }
     return self;
 }
@@ -128,6 +199,15 @@ static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus
                                               executionBlock:executionBlock];
 }
 
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                                 executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                                       priority:(CHRTimerPriority)priority
+{
+    return [[CHRVariableTimer alloc]initWithIntervalProvider:intervalProvider
+                                              executionBlock:executionBlock
+                                                    priority:priority];
+}
+
 + (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
                                  executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
                                  executionQueue:(dispatch_queue_t)executionQueue
@@ -148,40 +228,182 @@ static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus
                                                 failureBlock:failureBlock];
 }
 
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                                 executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                                 executionQueue:(dispatch_queue_t)executionQueue
+                                   leewayPolicy:(CHRLeewayPolicy *)leewayPolicy
+                                   failureBlock:(CHRTimerInitFailureBlock)failureBlock
+{
+    return [[CHRVariableTimer alloc]initWithIntervalProvider:intervalProvider
+                                              executionBlock:executionBlock
+                                              executionQueue:executionQueue
+                                                leewayPolicy:leewayPolicy
+                                                failureBlock:failureBlock];
+}
+
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                                 executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock
+                                 executionQueue:(dispatch_queue_t)executionQueue
+                                      scheduler:(id<CHRTimerScheduler>)scheduler
+{
+    return [[CHRVariableTimer alloc]initWithIntervalProvider:intervalProvider
+                                              executionBlock:executionBlock
+                                              executionQueue:executionQueue
+                                                   scheduler:scheduler];
+}
+
+#pragma mark Creating an Asynchronous Variable Timer
+
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                     asyncExecutionBlock:(CHRVariableTimerAsyncExecutionBlock)asyncExecutionBlock
+{
+    dispatch_queue_t executionQueue = [[CHRExecutionQueuePool sharedPool] queueForObject:self];
+    return [self initWithIntervalProvider:intervalProvider
+                      asyncExecutionBlock:asyncExecutionBlock
+                           executionQueue:executionQueue];
+}
+
+- (instancetype)initWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                     asyncExecutionBlock:(CHRVariableTimerAsyncExecutionBlock)asyncExecutionBlock
+                          executionQueue:(dispatch_queue_t)executionQueue
+{
+    asyncExecutionBlock = [asyncExecutionBlock copy];
+    CHRRepeatingTimerExecutionBlock executionBlock = ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        asyncExecutionBlock((CHRVariableTimer *)timer, invocation, ^{});
+    };
+    if (self = [self initWithIntervalProvider:intervalProvider
+                               executionBlock:executionBlock
+                               executionQueue:executionQueue]) {
+        _asyncExecutionBlock = asyncExecutionBlock;
+    }
+    return self;
+}
+
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                            asyncExecutionBlock:(CHRVariableTimerAsyncExecutionBlock)asyncExecutionBlock
+{
+    return [[CHRVariableTimer alloc]initWithIntervalProvider:intervalProvider
+                                         asyncExecutionBlock:asyncExecutionBlock];
+}
+
++ (CHRVariableTimer *)timerWithIntervalProvider:(CHRVariableTimerIntervalProvider)intervalProvider
+                            asyncExecutionBlock:(CHRVariableTimerAsyncExecutionBlock)asyncExecutionBlock
+                                 executionQueue:(dispatch_queue_t)executionQueue
+{
+    return [[CHRVariableTimer alloc]initWithIntervalProvider:intervalProvider
+                                         asyncExecutionBlock:asyncExecutionBlock
+                                              executionQueue:executionQueue];
+}
+
+#pragma mark Batching Intervals
+
++ (CHRVariableTimerIntervalProvider)intervalProviderWithBatchSize:(NSUInteger)batchSize
+                                                     batchProvider:(CHRVariableTimerBatchIntervalProvider)batchProvider
+{
+    batchSize = MAX(batchSize, 1);
+    NSUInteger length = sizeof(struct chr_interval_batch_s) + batchSize * sizeof(NSTimeInterval);
+    chr_interval_batch_t batch = calloc(1, length);
+    pthread_mutex_init(&batch->lock, NULL);
+    // Owns the batch, the provider block keeps it alive.
+    NSData *storage = [[NSData alloc]initWithBytesNoCopy:batch length:length deallocator:^(void *bytes, NSUInteger length) {
+        pthread_mutex_destroy(&((chr_interval_batch_t)bytes)->lock);
+        free(bytes);
+    }];
+    return ^NSTimeInterval(__weak CHRVariableTimer *timer, NSUInteger nextInvocation) {
+        chr_interval_batch_t batch = (chr_interval_batch_t)storage.bytes;
+        pthread_mutex_lock(&batch->lock);
+        if (nextInvocation < batch->first || nextInvocation - batch->first >= batch->count) {
+            batch->first = nextInvocation;
+            batch->count = MIN(MAX(batchProvider(timer, nextInvocation, batch->intervals, batchSize), 1), batchSize);
+        }
+        NSTimeInterval interval = batch->intervals[nextInvocation - batch->first];
+        pthread_mutex_unlock(&batch->lock);
+        return interval;
+    };
+}
+
 #pragma mark Using a Timer
 
 - (void)start:(BOOL)now
 {
     [self validate];
     
-    if (OSAtomicCompareAndSwap32Barrier(CHRTimerStateStopped, CHRTimerStateRunning, &_running)) {
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateStopped)) == CHRTimerStateStopped) {
+        [self prepareToArm];
         if (now) {
-            dispatch_source_set_timer(_timer, DISPATCH_TIME_NOW, DISPATCH_TIME_FOREVER, chr_leeway(0.0));
+            [self setTimerWithInterval:0.0 now:YES chained:NO];
         } else {
-            [self schedule];
+            __weak CHRVariableTimer *weak = self;
+            [self setTimerWithInterval:self.intervalProvider(weak, chr_counter_load(&_nextInvocation)) now:NO chained:NO];
         }
-        _executionBlockDidSetTimer = (_executing) ? true : false;
+        [self resumeArmed];
+        chr_state_end(&_state, CHRTimerStateRunning);
+    }
+}
+
+/**
+ Readies a stopped timer to be armed, rebuilding the overlap gate if the
+ overlap settings changed while the timer was stopped. Executions admitted by a
+ replaced gate still run to completion. Must be called while transitioning from
+ the stopped state.
+ */
+- (void)prepareToArm
+{
+    if (!_asyncExecutionBlock && ![CHRExecutionGate gate:_gate enforcesPolicyOfTimer:self]) {
+        _gate = [CHRExecutionGate gateForTimer:self queue:_executionQueue handler:[self gateHandler]];
+    }
+    atomic_store_explicit(&_awaitingInvocation, 0, memory_order_relaxed);
+    if (_deadline) {
+        chr_trace(CHRTimerTraceEventResume, (__bridge void *)self, chr_counter_load(&_nextInvocation));
+    }
+}
+
+/**
+ Lets an armed timer fire. Must be called while transitioning from the stopped
+ state, after the timer has been armed.
+ */
+- (void)resumeArmed
+{
+    _executionBlockDidSetTimer = (_executing) ? true : false;
+    if (!_scheduler) {
         dispatch_resume(self.timer);
     }
+    chr_registry_set_state(_record, CHRTimerStateRunning);
 }
 
 - (void)pause
 {
     [self validate];
     
-    if (OSAtomicCompareAndSwap32Barrier(CHRTimerStateRunning, CHRTimerStateStopped, &_running)) {
-        dispatch_suspend(_timer);
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateRunning)) == CHRTimerStateRunning) {
+        chr_trace(CHRTimerTraceEventPause, (__bridge void *)self, chr_counter_load(&_nextInvocation));
+        if (_scheduler) {
+            [_scheduler disarmEntry:_entry];
+        } else {
+            dispatch_suspend(_timer);
+        }
+        chr_registry_set_state(_record, CHRTimerStateStopped);
+        chr_state_end(&_state, CHRTimerStateStopped);
     }
 }
 
 - (void)cancel
 {
-    if (OSAtomicCompareAndSwap32Barrier(CHRTimerStateValid, CHRTimerStateInvalid, &_valid)) {
-        if (_running == CHRTimerStateStopped) {
-            dispatch_resume(_timer);
+    int32_t mask = CHR_STATE_MASK(CHRTimerStateStopped) | CHR_STATE_MASK(CHRTimerStateRunning);
+    CHRTimerState previous = chr_state_begin(&_state, mask);
+    if (previous != CHRTimerStateTransitioning) {
+        chr_trace(CHRTimerTraceEventCancel, (__bridge void *)self, chr_counter_load(&_nextInvocation));
+        if (_scheduler) {
+            [_scheduler destroyEntry:_entry];
+            _entry = NULL;
+        } else {
+            if (previous == CHRTimerStateStopped) {
+                dispatch_resume(_timer);
+            }
+            dispatch_source_cancel(_timer);
         }
-        _running = CHRTimerStateStopped;
-        dispatch_source_cancel(_timer);
+        chr_registry_set_state(_record, CHRTimerStateInvalid);
+        chr_state_end(&_state, CHRTimerStateInvalid);
     }
 }
 
@@ -189,11 +411,206 @@ static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus
 {
     if (self.isValid) {
         __weak CHRVariableTimer *weak = self;
-        NSTimeInterval interval = self.intervalProvider(weak, _nextInvocation);
-        dispatch_source_set_timer(_timer, chr_startTime(interval, NO), interval * NSEC_PER_SEC, chr_leeway(interval));
+        NSTimeInterval interval = self.intervalProvider(weak, chr_counter_load(&_nextInvocation));
+        if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateRunning)) == CHRTimerStateRunning) {
+            // Entries keep firing while armed, so a paused timer must stay disarmed; a
+            // paused source is armed again by start:. The transition also keeps the
+            // deadline from racing with start: and completions arriving on any thread.
+            [self setTimerWithInterval:interval now:NO chained:_usesAbsoluteDeadlines];
+            chr_state_end(&_state, CHRTimerStateRunning);
+        }
+    }
+}
+
+/**
+ Programs the next firing of the underlying source or scheduler entry. A
+ chained firing is due one interval after the previous deadline, any other
+ firing one interval from now.
+ */
+- (void)setTimerWithInterval:(NSTimeInterval)interval now:(BOOL)now chained:(BOOL)chained
+{
+    uint64_t current = [self currentTime];
+    uint64_t nanoseconds = chr_nanoseconds(interval);
+    if (now) {
+        _deadline = current;
+    } else if (chained) {
+        _deadline = [self deadlineFollowing:_deadline interval:nanoseconds now:current];
+    } else {
+        _deadline = current + nanoseconds;
+    }
+    uint64_t delay = (_deadline > current)? _deadline - current : 0;
+    [self armWithInterval:interval delay:delay now:now];
+}
+
+/**
+ Programs the underlying source or scheduler entry to fire after the given
+ delay, in nanoseconds, at the end of the given interval.
+ */
+- (void)armWithInterval:(NSTimeInterval)interval delay:(uint64_t)delay now:(BOOL)now
+{
+    uint64_t nanoseconds = chr_nanoseconds(interval);
+    _armedInterval = nanoseconds;
+    chr_trace(CHRTimerTraceEventArm, (__bridge void *)self, chr_counter_load(&_nextInvocation));
+    chr_registry_set_interval(_record, nanoseconds);
+    
+    if (_scheduler) {
+        [_scheduler armEntry:_entry
+                       delay:delay
+                    interval:0
+                      leeway:[_leewayPolicy leewayForInterval:interval]];
+    } else if (now) {
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_NOW, DISPATCH_TIME_FOREVER, [_leewayPolicy leewayForInterval:0.0]);
+    } else {
+        dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, delay), nanoseconds, [_leewayPolicy leewayForInterval:interval]);
+    }
+}
+
+/**
+ Returns the deadline one interval after the given one, applying the missed
+ deadline policy if that is not in the future.
+ */
+- (uint64_t)deadlineFollowing:(uint64_t)deadline interval:(uint64_t)interval now:(uint64_t)now
+{
+    uint64_t next = deadline + interval;
+    if (next > now) {
+        return next;
+    }
+    switch (_missedDeadlinePolicy) {
+        case CHRMissedDeadlinePolicySkip:
+            return (interval)? next + ((now - next) / interval + 1) * interval : now;
+        case CHRMissedDeadlinePolicyRebase:
+            return now;
+        case CHRMissedDeadlinePolicyFireImmediately:
+        default:
+            return next;
+    }
+}
+
+- (dispatch_block_t)eventHandler
+{
+    __weak CHRVariableTimer *weak = self;
+    return ^{
+        CHRVariableTimer *strong = weak;
+        if (strong) {
+            strong->_executing = true;
+            // Scheduler entries and async completions can overlap handlers, count atomically.
+            NSUInteger invocation = atomic_fetch_add_explicit(&strong->_lastInvocation, 1, memory_order_relaxed);
+            atomic_store_explicit(&strong->_nextInvocation, invocation + 1, memory_order_relaxed);
+            chr_trace(CHRTimerTraceEventFire, (__bridge void *)strong, invocation);
+            CHRTimerStatistics *statistics = strong->_statistics;
+            if (statistics) {
+                uint64_t start = [strong currentTime];
+                uint64_t lateness = (start > strong->_deadline)? start - strong->_deadline : 0;
+                [strong executeInvocation:invocation];
+                [statistics recordLateness:lateness duration:[strong currentTime] - start skipped:0];
+            } else {
+                [strong executeInvocation:invocation];
+            }
+            strong->_executing = false;
+            if (strong->_asyncExecutionBlock) {
+                if (strong->_executionBlockDidSetTimer) {
+                    // The block restarted the timer, its completion must not schedule again.
+                    atomic_store(&strong->_awaitingInvocation, 0);
+                }
+            } else if (!strong->_executionBlockDidSetTimer) {
+                [strong schedule];
+            }
+            strong->_executionBlockDidSetTimer = false;
+        }
+    };
+}
+
+/**
+ Runs the execution block for the given invocation, or submits it to the gate
+ enforcing the overlap policy. A submitted execution does not hold back the
+ next firing.
+ */
+- (void)executeInvocation:(NSUInteger)invocation
+{
+    CHRExecutionGate *gate = _gate;
+    if (_asyncExecutionBlock) {
+        [self executeAsyncInvocation:invocation];
+    } else if (!gate) {
+        chr_trace(CHRTimerTraceEventExecuteBegin, (__bridge void *)self, invocation);
+        uint64_t start = chr_registry_begin(_record);
+        _executionBlock(self, invocation);
+        chr_registry_end(_record, start);
+        chr_trace(CHRTimerTraceEventExecuteEnd, (__bridge void *)self, invocation);
+    } else if (![gate submitInvocation:invocation periods:1]) {
+        atomic_fetch_add_explicit(&_skippedInvocations, 1, memory_order_relaxed);
+        CHRRepeatingTimerExecutionBlock skipBlock = _skipBlock;
+        if (skipBlock) {
+            skipBlock(self, invocation);
+        }
     }
 }
 
+/**
+ Runs the asynchronous execution block for the given invocation. The source
+ stays disarmed until the invocation completes or its completion times out.
+ */
+- (void)executeAsyncInvocation:(NSUInteger)invocation
+{
+    if (!_scheduler) {
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+    }
+    atomic_store(&_awaitingInvocation, invocation + 1);
+    __weak CHRVariableTimer *weak = self;
+    if (_completionTimeout > 0.0) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, chr_nanoseconds(_completionTimeout)), _executionQueue, ^{
+            [weak completeInvocation:invocation timedOut:YES];
+        });
+    }
+    chr_trace(CHRTimerTraceEventExecuteBegin, (__bridge void *)self, invocation);
+    uint64_t start = chr_registry_begin(_record);
+    _asyncExecutionBlock(weak, invocation, ^{
+        [weak completeInvocation:invocation timedOut:NO];
+    });
+    chr_registry_end(_record, start);
+}
+
+/**
+ Schedules the next firing the first time an invocation completes or times
+ out. Later calls for the same invocation are ignored.
+ */
+- (void)completeInvocation:(NSUInteger)invocation timedOut:(BOOL)timedOut
+{
+    NSUInteger expected = invocation + 1;
+    if (!atomic_compare_exchange_strong(&_awaitingInvocation, &expected, 0)) {
+        return;
+    }
+    chr_trace(CHRTimerTraceEventExecuteEnd, (__bridge void *)self, invocation);
+    if (timedOut) {
+        atomic_fetch_add_explicit(&_timedOutCompletions, 1, memory_order_relaxed);
+    }
+    [self schedule];
+}
+
+- (CHRExecutionGateHandler)gateHandler
+{
+    __weak CHRVariableTimer *weak = self;
+    CHRRepeatingTimerExecutionBlock executionBlock = _executionBlock;
+    return ^(NSUInteger invocation, NSUInteger periods) {
+        CHRVariableTimer *strong = weak;
+        if (strong) {
+            chr_trace(CHRTimerTraceEventExecuteBegin, (__bridge void *)strong, invocation);
+            uint64_t start = chr_registry_begin(strong->_record);
+            executionBlock(strong, invocation);
+            chr_registry_end(strong->_record, start);
+            chr_trace(CHRTimerTraceEventExecuteEnd, (__bridge void *)strong, invocation);
+        }
+    };
+}
+
+/**
+ Returns the current time of the clock the timer's deadlines are measured on,
+ in nanoseconds.
+ */
+- (uint64_t)currentTime
+{
+    return (_schedulerClock)? [_scheduler currentTime] : chr_now();
+}
+
 - (void)validate
 {
     if (!self.isValid) {
@@ -203,21 +620,70 @@ static NSString * const CHRVariableTimerExecutionQueueNamePrefix = @"com.chronus
     }
 }
 
+#pragma mark Snapshots
+
+- (BOOL)getScheduleDelay:(int64_t *)delay
+                interval:(uint64_t *)interval
+             invocations:(NSUInteger *)invocations
+{
+    int32_t mask = CHR_STATE_MASK(CHRTimerStateStopped) | CHR_STATE_MASK(CHRTimerStateRunning);
+    CHRTimerState state = chr_state_begin(&_state, mask);
+    *invocations = chr_counter_load(&_nextInvocation);
+    *interval = (state != CHRTimerStateTransitioning)? _armedInterval : 0;
+    *delay = (state == CHRTimerStateRunning)? (int64_t)(_deadline - [self currentTime]) : 0;
+    if (state != CHRTimerStateTransitioning) {
+        chr_state_end(&_state, state);
+    }
+    return state == CHRTimerStateRunning;
+}
+
+- (BOOL)restoreInvocations:(NSUInteger)invocations
+                     delay:(uint64_t)delay
+                  interval:(uint64_t)interval
+                   running:(BOOL)running
+{
+    [self validate];
+    
+    if (chr_state_begin(&_state, CHR_STATE_MASK(CHRTimerStateStopped)) != CHRTimerStateStopped) {
+        return NO;
+    }
+    atomic_store_explicit(&_lastInvocation, invocations, memory_order_relaxed);
+    atomic_store_explicit(&_nextInvocation, invocations, memory_order_relaxed);
+    if (running) {
+        [self prepareToArm];
+        _deadline = [self currentTime] + delay;
+        [self armWithInterval:(NSTimeInterval)interval / NSEC_PER_SEC delay:delay now:NO];
+        [self resumeArmed];
+    }
+    chr_state_end(&_state, (running)? CHRTimerStateRunning : CHRTimerStateStopped);
+    return YES;
+}
+
 #pragma mark Getters
 
 - (BOOL)isRunning
 {
-    return _running == CHRTimerStateRunning;
+    return chr_state_load(&_state) == CHRTimerStateRunning;
 }
 
 - (BOOL)isValid
 {
-    return _valid == CHRTimerStateValid;
+    return chr_state_load(&_state) != CHRTimerStateInvalid;
 }
 
 - (NSUInteger)invocations
 {
-    return _lastInvocation;
+    return chr_counter_load(&_lastInvocation);
+}
+
+- (NSUInteger)skippedInvocations
+{
+    return chr_counter_load(&_skippedInvocations);
+}
+
+- (NSUInteger)timedOutCompletions
+{
+    return chr_counter_load(&_timedOutCompletions);
 }
 
 @end
@@ -0,0 +1,126 @@
+//
+//  CHRVirtualClock.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRTimerScheduler.h"
+
+
+#pragma mark - CHRVirtualClock Interface
+
+/**
+ The CHRVirtualClock class is a scheduler whose time only moves when it is
+ told to, for testing and simulating timers deterministically and far faster
+ than real time.
+ 
+ Pass a virtual clock as the scheduler of a CHRDispatchTimer or
+ CHRVariableTimer. The timer then measures its deadlines on the clock, and
+ advancing the clock fires every entry that comes due, in deadline order,
+ synchronously on the thread that advances it. Entries due at the same time
+ fire in the order they were armed. Leeway is ignored and no real time passes
+ unless an execution block calls elapse:.
+ 
+ The execution queue of a timer driven by a virtual clock is not used for
+ firings, except by an overlap policy or an asynchronous completion timeout.
+ */
+@interface CHRVirtualClock : NSObject <CHRTimerScheduler>
+
+// -----
+// @name Creating a Virtual Clock
+// -----
+
+#pragma mark Creating a Virtual Clock
+
+/**
+ Initializes a CHRVirtualClock object whose time starts at 0.
+ 
+ @return    The newly initialized CHRVirtualClock object.
+ */
+- (instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/**
+ Creates and initializes a new CHRVirtualClock object whose time starts at 0.
+ 
+ @return    The newly created CHRVirtualClock object.
+ */
++ (CHRVirtualClock *)clock;
+
+// -----
+// @name Advancing Time
+// -----
+
+#pragma mark Advancing Time
+
+/**
+ Moves the clock forward, firing every entry that comes due on the way.
+ 
+ @param     interval
+            The amount of time to advance the clock by, in seconds.
+ @return    The number of entries fired.
+ */
+- (NSUInteger)advanceBy:(NSTimeInterval)interval;
+
+/**
+ Moves the clock forward to the earliest deadline of an armed entry and fires
+ every entry due at that time.
+ 
+ @return    The number of entries fired, 0 if no entry is armed.
+ */
+- (NSUInteger)advanceToNextDeadline;
+
+/**
+ Moves the clock forward without firing anything, as if the calling execution
+ block had run for the given duration. Entries that become due fire late, once
+ the advance in progress resumes or the clock is next advanced.
+ 
+ @param     duration
+            The amount of time that passes, in seconds.
+ */
+- (void)elapse:(NSTimeInterval)duration;
+
+// -----
+// @name Properties
+// -----
+
+#pragma mark Properties
+
+/**
+ The time elapsed on the receiver since it was created, in seconds.
+ */
+@property (atomic, readonly) NSTimeInterval now;
+
+/**
+ The number of entries currently armed on the receiver.
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ The number of times the receiver has fired an entry.
+ */
+@property (atomic, readonly) uint64_t firings;
+
+@end
@@ -0,0 +1,303 @@
+//
+//  CHRVirtualClock.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRVirtualClock.h"
+#import "CHRTimerInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - Constants and Functions
+
+typedef struct chr_clock_entry_s *chr_clock_entry_t;
+
+struct chr_clock_entry_s {
+    uint64_t            deadline;   // nanoseconds on the clock
+    uint64_t            period;     // nanoseconds, 0 for a single firing
+    uint64_t            sequence;   // arming order, breaks deadline ties
+    NSUInteger          index;      // position in the heap, NSNotFound while disarmed
+    void                *handler;   // retained dispatch_block_t
+};
+
+static inline bool chr_clock_precedes(chr_clock_entry_t a, chr_clock_entry_t b) {
+    return (a->deadline != b->deadline)? a->deadline < b->deadline : a->sequence < b->sequence;
+}
+
+
+#pragma mark - CHRVirtualClock Class Extension
+
+@interface CHRVirtualClock () {
+    pthread_mutex_t     _lock;
+    uint64_t            _now;
+    uint64_t            _sequence;
+    uint64_t            _firings;
+    chr_clock_entry_t   *_heap;
+    NSUInteger          _count;
+    NSUInteger          _capacity;
+}
+
+@end
+
+
+#pragma mark - CHRVirtualClock Implementation
+
+@implementation CHRVirtualClock
+
+- (void)dealloc
+{
+    free(_heap);
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Creating a Virtual Clock
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+    }
+    return self;
+}
+
++ (CHRVirtualClock *)clock
+{
+    return [[CHRVirtualClock alloc]init];
+}
+
+#pragma mark Managing Entries
+
+- (CHRTimerSchedulerEntry)createEntryWithQueue:(dispatch_queue_t)queue handler:(dispatch_block_t)handler
+{
+    chr_clock_entry_t entry = calloc(1, sizeof(struct chr_clock_entry_s));
+    entry->index = NSNotFound;
+    entry->handler = (__bridge_retained void *)[handler copy];
+    return entry;
+}
+
+- (void)armEntry:(CHRTimerSchedulerEntry)handle
+           delay:(uint64_t)delay
+        interval:(uint64_t)interval
+          leeway:(uint64_t)leeway
+{
+    chr_clock_entry_t entry = handle;
+    pthread_mutex_lock(&_lock);
+    if (entry->index != NSNotFound) {
+        [self removeEntry:entry];
+    }
+    entry->deadline = _now + delay;
+    entry->period = interval;
+    [self insertEntry:entry];
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)disarmEntry:(CHRTimerSchedulerEntry)handle
+{
+    chr_clock_entry_t entry = handle;
+    pthread_mutex_lock(&_lock);
+    if (entry->index != NSNotFound) {
+        [self removeEntry:entry];
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)destroyEntry:(CHRTimerSchedulerEntry)handle
+{
+    chr_clock_entry_t entry = handle;
+    [self disarmEntry:entry];
+    CFBridgingRelease(entry->handler);
+    free(entry);
+}
+
+#pragma mark Measuring Time
+
+- (uint64_t)currentTime
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t now = _now;
+    pthread_mutex_unlock(&_lock);
+    return now;
+}
+
+#pragma mark Advancing Time
+
+- (NSUInteger)advanceBy:(NSTimeInterval)interval
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t target = _now + chr_nanoseconds(interval);
+    pthread_mutex_unlock(&_lock);
+    return [self fireUntil:target];
+}
+
+- (NSUInteger)advanceToNextDeadline
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t target = (_count)? MAX(_heap[0]->deadline, _now) : _now;
+    BOOL armed = (_count > 0);
+    pthread_mutex_unlock(&_lock);
+    return (armed)? [self fireUntil:target] : 0;
+}
+
+- (void)elapse:(NSTimeInterval)duration
+{
+    pthread_mutex_lock(&_lock);
+    _now += chr_nanoseconds(duration);
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark Private
+
+/**
+ Fires every entry due at or before the given time in deadline order, then
+ moves the clock to that time unless an execution block already elapsed past
+ it. Handlers run without the lock held, so they may arm, disarm or destroy
+ entries.
+ */
+- (NSUInteger)fireUntil:(uint64_t)target
+{
+    NSUInteger fired = 0;
+    while (true) {
+        pthread_mutex_lock(&_lock);
+        if (_count == 0 || _heap[0]->deadline > target) {
+            _now = MAX(_now, target);
+            pthread_mutex_unlock(&_lock);
+            break;
+        }
+        chr_clock_entry_t entry = _heap[0];
+        [self removeEntry:entry];
+        _now = MAX(_now, entry->deadline);
+        if (entry->period) {
+            // Like a dispatch source, an entry that fell behind fires once and skips the missed periods.
+            entry->deadline += entry->period;
+            if (entry->deadline <= _now) {
+                entry->deadline = _now + entry->period;
+            }
+            [self insertEntry:entry];
+        }
+        _firings++;
+        dispatch_block_t handler = (__bridge dispatch_block_t)entry->handler;
+        pthread_mutex_unlock(&_lock);
+        
+        handler();
+        fired++;
+    }
+    return fired;
+}
+
+/**
+ Adds an entry to the heap, stamping it with the next arming sequence. Must be
+ called with the lock held.
+ */
+- (void)insertEntry:(chr_clock_entry_t)entry
+{
+    if (_count == _capacity) {
+        _capacity = MAX(_capacity * 2, 16);
+        _heap = realloc(_heap, _capacity * sizeof(chr_clock_entry_t));
+    }
+    entry->sequence = _sequence++;
+    entry->index = _count++;
+    _heap[entry->index] = entry;
+    [self siftUp:entry->index];
+}
+
+/**
+ Removes an armed entry from the heap. Must be called with the lock held.
+ */
+- (void)removeEntry:(chr_clock_entry_t)entry
+{
+    NSUInteger index = entry->index;
+    chr_clock_entry_t last = _heap[--_count];
+    entry->index = NSNotFound;
+    if (last != entry) {
+        _heap[index] = last;
+        last->index = index;
+        [self siftUp:index];
+        [self siftDown:last->index];
+    }
+}
+
+- (void)siftUp:(NSUInteger)index
+{
+    chr_clock_entry_t entry = _heap[index];
+    while (index > 0) {
+        NSUInteger parent = (index - 1) / 2;
+        if (!chr_clock_precedes(entry, _heap[parent])) {
+            break;
+        }
+        _heap[index] = _heap[parent];
+        _heap[index]->index = index;
+        index = parent;
+    }
+    _heap[index] = entry;
+    entry->index = index;
+}
+
+- (void)siftDown:(NSUInteger)index
+{
+    chr_clock_entry_t entry = _heap[index];
+    while (true) {
+        NSUInteger child = 2 * index + 1;
+        if (child >= _count) {
+            break;
+        }
+        if (child + 1 < _count && chr_clock_precedes(_heap[child + 1], _heap[child])) {
+            child++;
+        }
+        if (!chr_clock_precedes(_heap[child], entry)) {
+            break;
+        }
+        _heap[index] = _heap[child];
+        _heap[index]->index = index;
+        index = child;
+    }
+    _heap[index] = entry;
+    entry->index = index;
+}
+
+#pragma mark Getters
+
+- (NSTimeInterval)now
+{
+    return [self currentTime] / (NSTimeInterval)NSEC_PER_SEC;
+}
+
+- (NSUInteger)count
+{
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = _count;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+- (uint64_t)firings
+{
+    pthread_mutex_lock(&_lock);
+    uint64_t firings = _firings;
+    pthread_mutex_unlock(&_lock);
+    return firings;
+}
+
+@end
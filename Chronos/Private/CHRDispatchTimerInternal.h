@@ -0,0 +1,57 @@
+//
+//  CHRDispatchTimerInternal.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#ifndef Chronos_CHRDispatchTimerInternal
+#define Chronos_CHRDispatchTimerInternal
+
+
+#pragma mark - Imports
+
+#import "CHRDispatchTimer.h"
+
+
+#pragma mark - CHRDispatchTimer Recycling
+
+@interface CHRDispatchTimer (Recycling)
+
+/**
+ Returns a paused timer to the state of a newly created one, keeping its
+ dispatch source and execution queue. Timers driven by a scheduler cannot be
+ reset.
+ 
+ @param     interval
+            The new execution interval, in seconds.
+ @param     executionBlock
+            The new execution block, or nil to release the current one while
+            the timer is not in use.
+ @return    YES, if the timer was paused and has been reset.
+ */
+- (BOOL)resetWithInterval:(NSTimeInterval)interval
+           executionBlock:(CHRRepeatingTimerExecutionBlock)executionBlock;
+
+@end
+
+#endif
@@ -0,0 +1,131 @@
+//
+//  CHRExecutionGate.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#ifndef Chronos_CHRExecutionGate
+#define Chronos_CHRExecutionGate
+
+
+#pragma mark - Imports
+
+@import Foundation;
+#import "CHRRepeatingTimer.h"
+
+
+#pragma mark - Type Definitions
+
+/**
+ The block a gate runs for each admitted invocation.
+ 
+ @param     invocation
+            The invocation number of the firing that was admitted.
+ @param     periods
+            The number of periods the firing covers.
+ */
+typedef void (^CHRExecutionGateHandler)(NSUInteger invocation, NSUInteger periods);
+
+
+#pragma mark - CHRExecutionGate Interface
+
+/**
+ The CHRExecutionGate class bounds the number of executions of a timer that
+ are in flight at once. Each firing is submitted to the gate, which either
+ dispatches it to the execution queue, queues it until an earlier execution
+ finishes, or rejects it.
+ 
+ The number of in-flight and queued executions is kept in a single atomic
+ counter, so a firing that is dispatched or rejected never takes a lock.
+ */
+@interface CHRExecutionGate : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Initializes a CHRExecutionGate object.
+ 
+ @param     queue
+            The queue admitted executions are dispatched to.
+ @param     concurrency
+            The largest number of executions in flight at once.
+ @param     pending
+            The largest number of executions queued behind those in flight.
+ @param     handler
+            The block run for each admitted invocation.
+ @return    The newly initialized CHRExecutionGate object.
+ */
+- (instancetype)initWithQueue:(dispatch_queue_t)queue
+                  concurrency:(NSUInteger)concurrency
+                      pending:(NSUInteger)pending
+                      handler:(CHRExecutionGateHandler)handler NS_DESIGNATED_INITIALIZER;
+
+/**
+ Returns a gate enforcing the overlap policy of the given timer, or nil if the
+ policy does not bound its executions.
+ 
+ @param     timer
+            The timer whose overlap policy and limits to use.
+ @param     queue
+            The queue admitted executions are dispatched to.
+ @param     handler
+            The block run for each admitted invocation.
+ @return    The newly created CHRExecutionGate object, or nil.
+ */
++ (CHRExecutionGate *)gateForTimer:(id<CHRRepeatingTimer>)timer
+                             queue:(dispatch_queue_t)queue
+                           handler:(CHRExecutionGateHandler)handler;
+
+/**
+ Returns whether a gate enforces the current overlap policy and limits of the
+ given timer. A nil gate enforces exactly the unbounded policy.
+ 
+ @param     gate
+            The gate to check, or nil.
+ @param     timer
+            The timer whose overlap policy and limits to compare with.
+ @return    YES, if gateForTimer:queue:handler: would create an equivalent gate.
+ */
++ (BOOL)gate:(CHRExecutionGate *)gate enforcesPolicyOfTimer:(id<CHRRepeatingTimer>)timer;
+
+/**
+ Submits a firing to the gate. The period count travels with the invocation,
+ so a queued firing still reports its own count when it finally runs.
+ 
+ @param     invocation
+            The invocation number of the firing.
+ @param     periods
+            The number of periods the firing covers.
+ @return    YES, if the firing was dispatched or queued. NO, if it was
+            rejected because the gate is full.
+ */
+- (BOOL)submitInvocation:(NSUInteger)invocation periods:(NSUInteger)periods;
+
+/**
+ The number of executions currently in flight or queued.
+ */
+@property (atomic, readonly) NSUInteger outstanding;
+
+@end
+
+#endif
@@ -0,0 +1,214 @@
+//
+//  CHRExecutionGate.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+#import "CHRExecutionGate.h"
+#import "CHRTimerInternal.h"
+#import <pthread.h>
+
+
+#pragma mark - Type Definitions
+
+/**
+ A firing waiting for an execution in flight to return.
+ */
+typedef struct chr_gate_firing_s {
+    NSUInteger  invocation;
+    NSUInteger  periods;
+} chr_gate_firing_t;
+
+
+#pragma mark - Constants and Functions
+
+/**
+ Reads the limits the overlap policy of a timer puts on its executions. Returns
+ NO if the policy does not bound them.
+ */
+static BOOL chr_gate_limits(id<CHRRepeatingTimer> timer, NSUInteger *concurrency, NSUInteger *pending) {
+    *concurrency = MAX(timer.maximumConcurrentExecutions, 1);
+    *pending = 0;
+    switch (timer.overlapPolicy) {
+        case CHROverlapPolicySkip:
+            *concurrency = 1;
+            return YES;
+        case CHROverlapPolicyQueue:
+            *pending = timer.maximumPendingExecutions;
+            return YES;
+        case CHROverlapPolicyConcurrent:
+            return YES;
+        case CHROverlapPolicyUnbounded:
+        default:
+            return NO;
+    }
+}
+
+
+#pragma mark - CHRExecutionGate Class Extension
+
+@interface CHRExecutionGate () {
+    chr_counter_t       _outstanding;   // in flight plus queued
+    NSUInteger          _concurrency;
+    NSUInteger          _limit;         // concurrency plus pending
+    pthread_mutex_t     _lock;          // guards the queued invocations
+    chr_gate_firing_t   *_queued;
+    NSUInteger          _head;
+    NSUInteger          _length;
+}
+
+@property (readonly) dispatch_queue_t queue;
+@property (readonly) CHRExecutionGateHandler handler;
+
+@end
+
+
+#pragma mark - CHRExecutionGate Implementation
+
+@implementation CHRExecutionGate
+
+- (void)dealloc
+{
+    free(_queued);
+    pthread_mutex_destroy(&_lock);
+}
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue
+                  concurrency:(NSUInteger)concurrency
+                      pending:(NSUInteger)pending
+                      handler:(CHRExecutionGateHandler)handler
+{
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _queue = queue;
+        _handler = [handler copy];
+        _concurrency = MAX(concurrency, 1);
+        _limit = _concurrency + pending;
+        _queued = (pending)? calloc(pending, sizeof(chr_gate_firing_t)) : NULL;
+        atomic_init(&_outstanding, 0);
+    }
+    return self;
+}
+
++ (CHRExecutionGate *)gateForTimer:(id<CHRRepeatingTimer>)timer
+                             queue:(dispatch_queue_t)queue
+                           handler:(CHRExecutionGateHandler)handler
+{
+    NSUInteger concurrency, pending;
+    if (!chr_gate_limits(timer, &concurrency, &pending)) {
+        return nil;
+    }
+    return [[CHRExecutionGate alloc]initWithQueue:queue
+                                      concurrency:concurrency
+                                          pending:pending
+                                          handler:handler];
+}
+
++ (BOOL)gate:(CHRExecutionGate *)gate enforcesPolicyOfTimer:(id<CHRRepeatingTimer>)timer
+{
+    NSUInteger concurrency, pending;
+    if (!chr_gate_limits(timer, &concurrency, &pending)) {
+        return gate == nil;
+    }
+    return gate && gate->_concurrency == concurrency && gate->_limit == concurrency + pending;
+}
+
+- (BOOL)submitInvocation:(NSUInteger)invocation periods:(NSUInteger)periods
+{
+    NSUInteger outstanding = atomic_load_explicit(&_outstanding, memory_order_relaxed);
+    while (outstanding < _concurrency) {
+        if (atomic_compare_exchange_weak(&_outstanding, &outstanding, outstanding + 1)) {
+            [self dispatchInvocation:invocation periods:periods];
+            return YES;
+        }
+    }
+    if (outstanding >= _limit) {
+        return NO;
+    }
+    
+    // Every execution in flight is taken, queue the invocation. Queueing and
+    // handing a queued invocation over happen under the lock, so the counter
+    // and the queue always agree.
+    pthread_mutex_lock(&_lock);
+    outstanding = atomic_fetch_add(&_outstanding, 1);
+    BOOL admitted = (outstanding < _limit);
+    if (!admitted) {
+        atomic_fetch_sub(&_outstanding, 1);
+    } else if (outstanding >= _concurrency) {
+        _queued[(_head + _length++) % (_limit - _concurrency)] = (chr_gate_firing_t){invocation, periods};
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    if (admitted && outstanding < _concurrency) {
+        // An execution finished since the counter was read.
+        [self dispatchInvocation:invocation periods:periods];
+    }
+    return admitted;
+}
+
+#pragma mark Private
+
+- (void)dispatchInvocation:(NSUInteger)invocation periods:(NSUInteger)periods
+{
+    dispatch_async(_queue, ^{
+        self->_handler(invocation, periods);
+        [self finishInvocation];
+    });
+}
+
+/**
+ Called when an execution returns. If invocations are queued, the slot it held
+ passes to the oldest of them.
+ */
+- (void)finishInvocation
+{
+    if (!_queued) {
+        atomic_fetch_sub(&_outstanding, 1);
+        return;
+    }
+    pthread_mutex_lock(&_lock);
+    BOOL found = (_length > 0);
+    chr_gate_firing_t firing = {0, 0};
+    if (found) {
+        firing = _queued[_head];
+        _head = (_head + 1) % (_limit - _concurrency);
+        _length--;
+    }
+    atomic_fetch_sub(&_outstanding, 1);
+    pthread_mutex_unlock(&_lock);
+    
+    if (found) {
+        [self dispatchInvocation:firing.invocation periods:firing.periods];
+    }
+}
+
+#pragma mark Getters
+
+- (NSUInteger)outstanding
+{
+    return chr_counter_load(&_outstanding);
+}
+
+@end
@@ -0,0 +1,93 @@
+//
+//  CHRScheduleSnapshotInternal.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#ifndef Chronos_CHRScheduleSnapshotInternal
+#define Chronos_CHRScheduleSnapshotInternal
+
+
+#pragma mark - Imports
+
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+
+
+#pragma mark - CHRScheduleSnapshotting Protocol
+
+/**
+ The schedule state a timer exposes to CHRScheduleSnapshot. Times are measured
+ in nanoseconds on the timer's own clock.
+ */
+@protocol CHRScheduleSnapshotting <NSObject>
+
+/**
+ Reads the schedule state of the timer without pausing it.
+ 
+ @param     delay
+            On return, the time left until the next firing, negative if the
+            firing is late, or 0 if the timer is not running.
+ @param     interval
+            On return, the interval leading up to the next firing.
+ @param     invocations
+            On return, the number of invocations so far, which is also the
+            invocation the next firing runs.
+ @return    YES, if the timer is running.
+ */
+- (BOOL)getScheduleDelay:(int64_t *)delay
+                interval:(uint64_t *)interval
+             invocations:(NSUInteger *)invocations;
+
+/**
+ Sets the invocation count of a stopped timer and optionally starts it with its
+ first firing due after the given delay.
+ 
+ @param     invocations
+            The number of invocations to resume counting from.
+ @param     delay
+            The time until the first firing.
+ @param     interval
+            The interval leading up to the first firing. Variable timers arm
+            their source with it; dispatch timers keep their own interval.
+ @param     running
+            YES, to start the timer.
+ @return    YES, if the timer was stopped and has been restored.
+ */
+- (BOOL)restoreInvocations:(NSUInteger)invocations
+                     delay:(uint64_t)delay
+                  interval:(uint64_t)interval
+                   running:(BOOL)running;
+
+@end
+
+
+#pragma mark - Conforming Timers
+
+@interface CHRDispatchTimer (Snapshots) <CHRScheduleSnapshotting>
+@end
+
+@interface CHRVariableTimer (Snapshots) <CHRScheduleSnapshotting>
+@end
+
+#endif
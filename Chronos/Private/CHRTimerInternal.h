@@ -28,32 +28,144 @@
 #define Chronos_CHRTimerInterval
 
 
+#pragma mark - Imports
+
+#include <stdatomic.h>
+#include <sched.h>
+#if __APPLE__
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+
 #pragma mark - Type Definitions
 
+/**
+ The lifecycle of a timer, kept in a single atomic state word. A control
+ operation moves the word to CHRTimerStateTransitioning while it suspends,
+ resumes or cancels the underlying source, so concurrent operations can never
+ unbalance the source's suspend count.
+ */
 typedef NS_ENUM(int32_t, CHRTimerState) {
-    CHRTimerStateStopped    = 0,
-    CHRTimerStateRunning    = 1,
-    CHRTimerStateValid      = 2,
-    CHRTimerStateInvalid    = 3
+    CHRTimerStateStopped        = 0,
+    CHRTimerStateRunning        = 1,
+    CHRTimerStateTransitioning  = 2,
+    CHRTimerStateInvalid        = 3
 };
 
+typedef _Atomic(int32_t) chr_state_t;
+
+typedef _Atomic(NSUInteger) chr_counter_t;
+
 
 #pragma mark - Constants and Functions
 
+/**
+ The dispatch timer source mask requesting strict firing, or 0 where libdispatch
+ does not support it.
+ */
+#ifdef DISPATCH_TIMER_STRICT
+#define CHR_TIMER_STRICT DISPATCH_TIMER_STRICT
+#else
+#define CHR_TIMER_STRICT 0
+#endif
+
 /**
  Computes the leeway for the given interval. Currently set to 5% of the total
- interval time.
+ interval time. Used by schedulers for their own dispatch sources; timers use
+ their CHRLeewayPolicy.
  */
 static inline uint64_t chr_leeway(NSTimeInterval interval) {
     return 0.05 * interval * NSEC_PER_SEC;
 }
 
 /**
- Computes the start time of the timer, given the interval and whether the timer
- should start immediately.
+ Converts the given interval, in seconds, to nanoseconds.
+ */
+static inline uint64_t chr_nanoseconds(NSTimeInterval interval) {
+    return (interval > 0.0)? interval * NSEC_PER_SEC : 0;
+}
+
+/**
+ Returns the current value of a monotonic clock, in nanoseconds. The clock does
+ not advance while the system is asleep, matching DISPATCH_TIME_NOW.
+ */
+static inline uint64_t chr_now(void) {
+#if __APPLE__
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+#endif
+}
+
+/**
+ Returns the mask bit of the given state, for chr_state_begin.
+ */
+#define CHR_STATE_MASK(state) (1 << (state))
+
+/**
+ Begins a transition of the state word if it is in one of the states in mask,
+ waiting for any transition already in progress to end. The caller has
+ exclusive control of the timer until it calls chr_state_end.
+ 
+ Returns the state the transition began from, or CHRTimerStateTransitioning if
+ the state word was in none of the states in mask.
+ */
+static inline CHRTimerState chr_state_begin(chr_state_t *state, int32_t mask) {
+    int32_t current = atomic_load_explicit(state, memory_order_relaxed);
+    for (;;) {
+        if (current == CHRTimerStateTransitioning) {
+            sched_yield();
+            current = atomic_load_explicit(state, memory_order_relaxed);
+        } else if (!(mask & CHR_STATE_MASK(current))) {
+            return CHRTimerStateTransitioning;
+        } else if (atomic_compare_exchange_weak_explicit(state, &current, CHRTimerStateTransitioning,
+                                                         memory_order_acquire, memory_order_relaxed)) {
+            return (CHRTimerState)current;
+        }
+    }
+}
+
+/**
+ Ends a transition begun with chr_state_begin, publishing the new state.
+ */
+static inline void chr_state_end(chr_state_t *state, CHRTimerState next) {
+    atomic_store_explicit(state, next, memory_order_release);
+}
+
+/**
+ Returns the current state.
+ */
+static inline CHRTimerState chr_state_load(chr_state_t *state) {
+    return (CHRTimerState)atomic_load_explicit(state, memory_order_acquire);
+}
+
+/**
+ Increments a counter that only one thread writes at a time and returns its
+ previous value. Avoids the cost of an atomic read-modify-write on the firing
+ path, so it must only be used from the event handler of a timer's own
+ dispatch source, which never runs concurrently with itself. Counters written
+ from scheduler expiries, which may overlap on a concurrent queue, must use
+ atomic_fetch_add_explicit instead.
+ */
+static inline NSUInteger chr_counter_increment(chr_counter_t *counter) {
+    NSUInteger value = atomic_load_explicit(counter, memory_order_relaxed);
+    atomic_store_explicit(counter, value + 1, memory_order_relaxed);
+    return value;
+}
+
+/**
+ Returns the current value of a counter.
  */
-static inline dispatch_time_t chr_startTime(NSTimeInterval interval, BOOL now) {
-    return dispatch_time(DISPATCH_TIME_NOW, (now)? 0 : interval * NSEC_PER_SEC);
+static inline NSUInteger chr_counter_load(chr_counter_t *counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
 }
 
 #endif
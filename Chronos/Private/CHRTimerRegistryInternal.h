@@ -0,0 +1,102 @@
+//
+//  CHRTimerRegistryInternal.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#ifndef Chronos_CHRTimerRegistryInternal
+#define Chronos_CHRTimerRegistryInternal
+
+
+#pragma mark - Imports
+
+#import "CHRTimerRegistry.h"
+#import "CHRTimerInternal.h"
+
+
+#pragma mark - Type Definitions
+
+typedef struct chr_registry_record_s *chr_registry_record_t;
+
+/**
+ The registry's view of a timer. Written by the timer, read by snapshots.
+ */
+struct chr_registry_record_s {
+    chr_registry_record_t   next;
+    chr_registry_record_t   prev;
+    void                    *timerClass;
+    void                    *queue;         // retained dispatch_queue_t
+    _Atomic(uint64_t)       interval;       // nanoseconds
+    _Atomic(int32_t)        state;          // CHRTimerState
+    _Atomic(uint64_t)       invocations;
+    _Atomic(uint64_t)       executionTime;  // nanoseconds
+};
+
+
+#pragma mark - Constants and Functions
+
+/**
+ Registers a timer if the registry is enabled.
+ 
+ @return    The timer's record, or NULL if the registry is disabled.
+ */
+FOUNDATION_EXPORT chr_registry_record_t chr_registry_register(Class timerClass,
+                                                              dispatch_queue_t queue,
+                                                              NSTimeInterval interval);
+
+/**
+ Removes a timer's record from the registry and frees it. Does nothing for a
+ NULL record.
+ */
+FOUNDATION_EXPORT void chr_registry_unregister(chr_registry_record_t record);
+
+static inline void chr_registry_set_state(chr_registry_record_t record, CHRTimerState state) {
+    if (record) {
+        atomic_store_explicit(&record->state, state, memory_order_relaxed);
+    }
+}
+
+static inline void chr_registry_set_interval(chr_registry_record_t record, uint64_t interval) {
+    if (record) {
+        atomic_store_explicit(&record->interval, interval, memory_order_relaxed);
+    }
+}
+
+/**
+ Returns the start time of an execution to pass to chr_registry_end.
+ */
+static inline uint64_t chr_registry_begin(chr_registry_record_t record) {
+    return (record)? chr_now() : 0;
+}
+
+/**
+ Accounts for an execution that started at the given time.
+ */
+static inline void chr_registry_end(chr_registry_record_t record, uint64_t start) {
+    if (record) {
+        atomic_fetch_add_explicit(&record->executionTime, chr_now() - start, memory_order_relaxed);
+        atomic_fetch_add_explicit(&record->invocations, 1, memory_order_relaxed);
+    }
+}
+
+#endif
@@ -0,0 +1,55 @@
+//
+//  CHRTimerStatisticsInternal.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#ifndef Chronos_CHRTimerStatisticsInternal
+#define Chronos_CHRTimerStatisticsInternal
+
+
+#pragma mark - Imports
+
+#import "CHRTimerStatistics.h"
+
+
+#pragma mark - CHRTimerStatistics Recording
+
+@interface CHRTimerStatistics (Recording)
+
+/**
+ Records a single firing of a timer.
+ 
+ @param     lateness
+            The time between the firing's deadline and the execution block
+            starting, in nanoseconds.
+ @param     duration
+            The time the execution block took, in nanoseconds.
+ @param     skipped
+            The number of firings skipped before this one.
+ */
+- (void)recordLateness:(uint64_t)lateness duration:(uint64_t)duration skipped:(uint64_t)skipped;
+
+@end
+
+#endif
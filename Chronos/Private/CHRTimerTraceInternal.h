@@ -0,0 +1,59 @@
+//
+//  CHRTimerTraceInternal.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#ifndef Chronos_CHRTimerTraceInternal
+#define Chronos_CHRTimerTraceInternal
+
+
+#pragma mark - Imports
+
+#import "CHRTimerTrace.h"
+#include <stdatomic.h>
+
+
+#pragma mark - Constants and Functions
+
+/**
+ Whether tracing is enabled. Only read through chr_trace.
+ */
+FOUNDATION_EXPORT atomic_bool chr_trace_enabled;
+
+/**
+ Appends an event to the calling thread's ring buffer.
+ */
+FOUNDATION_EXPORT void chr_trace_record(CHRTimerTraceEvent event, const void *timer, NSUInteger invocation);
+
+/**
+ Records an event for the given timer if tracing is enabled. Costs a single
+ predictable branch while it is not.
+ */
+static inline void chr_trace(CHRTimerTraceEvent event, const void *timer, NSUInteger invocation) {
+    if (__builtin_expect(atomic_load_explicit(&chr_trace_enabled, memory_order_relaxed), 0)) {
+        chr_trace_record(event, timer, invocation);
+    }
+}
+
+#endif
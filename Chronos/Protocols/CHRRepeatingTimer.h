@@ -32,6 +32,7 @@
 #pragma mark - Forward Declarations
 
 @protocol CHRRepeatingTimer;
+@class CHRTimerStatistics;
 
 
 #pragma mark - Type Definitions
@@ -46,6 +47,23 @@
  */
 typedef void (^CHRRepeatingTimerExecutionBlock)(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation);
 
+/**
+ What a timer does when it fires while earlier executions of its execution
+ block have not returned yet.
+ */
+typedef NS_ENUM(NSInteger, CHROverlapPolicy) {
+    /** Runs the execution block for every firing, without any bound. */
+    CHROverlapPolicyUnbounded   = 0,
+    /** Runs up to maximumConcurrentExecutions executions at once and skips
+     firings beyond that. */
+    CHROverlapPolicyConcurrent  = 1,
+    /** Skips firings while an execution is in flight. */
+    CHROverlapPolicySkip        = 2,
+    /** Runs up to maximumConcurrentExecutions executions at once, queues up to
+     maximumPendingExecutions more and skips firings beyond that. */
+    CHROverlapPolicyQueue       = 3
+};
+
 
 #pragma mark - CHRRepeatingTimer Protocol
 
@@ -71,4 +89,49 @@ typedef void (^CHRRepeatingTimerExecutionBlock)(__weak id<CHRRepeatingTimer> tim
  */
 @property (atomic, readonly) NSUInteger invocations;
 
+/**
+ The object recording the lateness and execution duration of the receiver's
+ firings, or nil if none are recorded. Statistics are not recorded by default;
+ set this property before starting the timer to collect them.
+ */
+@property (nonatomic, strong) CHRTimerStatistics *statistics;
+
+/**
+ What the receiver does when it fires while earlier executions are still in
+ flight, which can happen when the execution queue is concurrent. Defaults to
+ CHROverlapPolicyUnbounded. With any other policy the execution block is
+ dispatched asynchronously to the execution queue rather than run by the
+ firing itself. Set this property before the first start. Changes made later
+ take effect the next time the timer starts after being paused.
+ */
+@property (nonatomic) CHROverlapPolicy overlapPolicy;
+
+/**
+ The largest number of executions in flight at once under the
+ CHROverlapPolicyConcurrent and CHROverlapPolicyQueue policies. Defaults to 1.
+ Set this property before the first start. Changes made later take effect the
+ next time the timer starts after being paused.
+ */
+@property (nonatomic) NSUInteger maximumConcurrentExecutions;
+
+/**
+ The largest number of executions waiting for an earlier one to return under
+ the CHROverlapPolicyQueue policy. Defaults to 1. Set this property before the
+ first start. Changes made later take effect the next time the timer starts
+ after being paused.
+ */
+@property (nonatomic) NSUInteger maximumPendingExecutions;
+
+/**
+ The block to execute, on the queue the timer fires on, when a firing is
+ skipped by the overlap policy. Receives the invocation number of the skipped
+ firing. Optional.
+ */
+@property (nonatomic, copy) CHRRepeatingTimerExecutionBlock skipBlock;
+
+/**
+ The number of firings skipped by the overlap policy.
+ */
+@property (atomic, readonly) NSUInteger skippedInvocations;
+
 @end
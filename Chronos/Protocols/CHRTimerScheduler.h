@@ -0,0 +1,124 @@
+//
+//  CHRTimerScheduler.h
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import Foundation;
+
+
+#pragma mark - Type Definitions
+
+/**
+ An opaque handle to a logical timer registered with a CHRTimerScheduler.
+ */
+typedef void *CHRTimerSchedulerEntry;
+
+
+#pragma mark - CHRTimerScheduler Protocol
+
+/**
+ The CHRTimerScheduler protocol declares the methods used by timers that are
+ driven by a shared scheduler, such as a CHRTimerWheel, instead of owning their
+ own dispatch source.
+ 
+ A scheduler entry behaves like a dispatch timer source: it is created disarmed,
+ armed with a delay and an optional repeat interval, and submits its handler to
+ its queue every time it expires. Timers call these methods on your behalf; you
+ only need them to implement a scheduler of your own.
+ */
+@protocol CHRTimerScheduler <NSObject>
+
+// -----
+// @name Managing Entries
+// -----
+
+#pragma mark Managing Entries
+
+/**
+ Creates a disarmed entry.
+ 
+ @param     queue
+            The queue to submit the handler to.
+ @param     handler
+            The block to submit every time the entry expires.
+ @return    The newly created entry.
+ */
+- (CHRTimerSchedulerEntry)createEntryWithQueue:(dispatch_queue_t)queue handler:(dispatch_block_t)handler;
+
+/**
+ Arms or re-arms an entry.
+ 
+ @param     entry
+            The entry to arm.
+ @param     delay
+            The time until the entry first expires, in nanoseconds.
+ @param     interval
+            The time between subsequent expirations, in nanoseconds, or 0 if
+            the entry should only expire once.
+ @param     leeway
+            The amount of time, in nanoseconds, that the scheduler may defer
+            each expiration.
+ */
+- (void)armEntry:(CHRTimerSchedulerEntry)entry
+           delay:(uint64_t)delay
+        interval:(uint64_t)interval
+          leeway:(uint64_t)leeway;
+
+/**
+ Disarms an entry. Disarming an entry that is not armed has no effect.
+ 
+ @param     entry
+            The entry to disarm.
+ */
+- (void)disarmEntry:(CHRTimerSchedulerEntry)entry;
+
+/**
+ Disarms and destroys an entry. The entry must not be used afterwards.
+ 
+ @param     entry
+            The entry to destroy.
+ */
+- (void)destroyEntry:(CHRTimerSchedulerEntry)entry;
+
+// -----
+// @name Measuring Time
+// -----
+
+#pragma mark Measuring Time
+
+@optional
+
+/**
+ Returns the current time of the scheduler's clock. Timers driven by a
+ scheduler that implements this method measure their deadlines, lateness and
+ durations on its clock instead of the system's monotonic clock, which lets a
+ scheduler such as CHRVirtualClock simulate the passage of time.
+ 
+ @return    The current time, in nanoseconds.
+ */
+- (uint64_t)currentTime;
+
+@end
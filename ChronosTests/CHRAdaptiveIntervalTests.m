@@ -0,0 +1,221 @@
+//
+//  CHRAdaptiveIntervalTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRAdaptiveInterval.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSTimeInterval CHRAdaptiveIntervalSimulationDuration = 24 * 3600.0;
+static NSTimeInterval CHRAdaptiveIntervalSimulationPeriod = 600.0;
+static NSTimeInterval CHRAdaptiveIntervalSimulationBurst = 60.0;
+static NSTimeInterval CHRAdaptiveIntervalSimulationArrival = 0.5;
+
+
+#pragma mark - CHRAdaptiveIntervalTests Interface
+
+@interface CHRAdaptiveIntervalTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRAdaptiveIntervalTests Implementation
+
+@implementation CHRAdaptiveIntervalTests
+
+- (void)testExponentialBackoff
+{
+    CHRAdaptiveInterval *backoff = [CHRAdaptiveInterval exponentialBackoffWithMinimumInterval:1.0
+                                                                              maximumInterval:10.0
+                                                                                   multiplier:2.0
+                                                                                       jitter:CHRBackoffJitterNone];
+    XCTAssertEqual(1.0, [backoff nextInterval]);
+    XCTAssertEqual(2.0, [backoff nextInterval]);
+    XCTAssertEqual(4.0, [backoff nextInterval]);
+    XCTAssertEqual(8.0, [backoff nextInterval]);
+    XCTAssertEqual(10.0, [backoff nextInterval]);
+    XCTAssertEqual(10.0, [backoff nextInterval]);
+    
+    [backoff reportWork:YES];
+    XCTAssertEqual(1.0, [backoff nextInterval]);
+    XCTAssertEqual(2.0, [backoff nextInterval]);
+    XCTAssertEqual(2.0, backoff.currentInterval);
+}
+
+- (void)testJitteredBackoffStaysInBounds
+{
+    for (CHRBackoffJitter jitter = CHRBackoffJitterFull; jitter <= CHRBackoffJitterDecorrelated; ++jitter) {
+        CHRAdaptiveInterval *backoff = [CHRAdaptiveInterval exponentialBackoffWithMinimumInterval:0.5
+                                                                                  maximumInterval:30.0
+                                                                                       multiplier:3.0
+                                                                                           jitter:jitter];
+        for (NSUInteger i = 0; i < 1000; ++i) {
+            if (i % 50 == 0) {
+                [backoff reportWork:YES];
+            }
+            NSTimeInterval interval = [backoff nextInterval];
+            XCTAssertGreaterThanOrEqual(interval, 0.5);
+            XCTAssertLessThanOrEqual(interval, 30.0);
+        }
+    }
+}
+
+- (void)testAIMD
+{
+    CHRAdaptiveInterval *aimd = [CHRAdaptiveInterval AIMDWithMinimumInterval:1.0
+                                                             maximumInterval:5.0
+                                                                   increment:1.0
+                                                              decreaseFactor:0.5];
+    XCTAssertEqual(1.0, [aimd nextInterval]);
+    XCTAssertEqual(2.0, [aimd nextInterval]);
+    XCTAssertEqual(3.0, [aimd nextInterval]);
+    XCTAssertEqual(4.0, [aimd nextInterval]);
+    
+    [aimd reportWork:YES];
+    XCTAssertEqual(2.0, [aimd nextInterval]);
+    [aimd reportWork:YES];
+    XCTAssertEqual(1.0, [aimd nextInterval]);
+    [aimd reportWork:YES];
+    XCTAssertEqual(1.0, [aimd nextInterval]);
+}
+
+- (void)testLinearRamp
+{
+    CHRAdaptiveInterval *ramp = [CHRAdaptiveInterval linearRampWithMinimumInterval:1.0
+                                                                   maximumInterval:2.0
+                                                                              step:0.25];
+    XCTAssertEqual(1.0, [ramp nextInterval]);
+    XCTAssertEqual(1.25, [ramp nextInterval]);
+    XCTAssertEqual(1.5, [ramp nextInterval]);
+    
+    [ramp reportWork:YES];
+    XCTAssertEqual(1.0, [ramp nextInterval]);
+    for (NSUInteger i = 0; i < 10; ++i) {
+        [ramp nextInterval];
+    }
+    XCTAssertEqual(2.0, ramp.currentInterval);
+    
+    [ramp reset];
+    XCTAssertEqual(1.0, [ramp nextInterval]);
+}
+
+- (void)testDrivesVariableTimer
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRAdaptiveInterval *backoff = [CHRAdaptiveInterval exponentialBackoffWithMinimumInterval:0.01
+                                                                              maximumInterval:0.04
+                                                                                   multiplier:2.0
+                                                                                       jitter:CHRBackoffJitterNone];
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:backoff.intervalProvider
+                                                           executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                               if (invocation == 3) {
+                                                                   [timer cancel];
+                                                                   dispatch_semaphore_signal(semaphore);
+                                                               }
+                                                           }];
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    
+    XCTAssertEqualWithAccuracy(0.04, backoff.currentInterval, 0.0001);
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkPollsSavedAgainstFixedInterval
+{
+    NSUInteger fixedPolls = 0;
+    NSTimeInterval fixedLatency = [self simulate:nil polls:&fixedPolls];
+    
+    NSDictionary *providers = @{@"backoff": [CHRAdaptiveInterval exponentialBackoffWithMinimumInterval:1.0
+                                                                                        maximumInterval:60.0
+                                                                                             multiplier:2.0
+                                                                                                 jitter:CHRBackoffJitterNone],
+                                @"backoff full jitter": [CHRAdaptiveInterval exponentialBackoffWithMinimumInterval:1.0
+                                                                                                    maximumInterval:60.0
+                                                                                                         multiplier:2.0
+                                                                                                             jitter:CHRBackoffJitterFull],
+                                @"backoff decorrelated jitter": [CHRAdaptiveInterval exponentialBackoffWithMinimumInterval:1.0
+                                                                                                            maximumInterval:60.0
+                                                                                                                 multiplier:3.0
+                                                                                                                     jitter:CHRBackoffJitterDecorrelated],
+                                @"AIMD": [CHRAdaptiveInterval AIMDWithMinimumInterval:1.0
+                                                                      maximumInterval:60.0
+                                                                            increment:2.0
+                                                                       decreaseFactor:0.5],
+                                @"linear ramp": [CHRAdaptiveInterval linearRampWithMinimumInterval:1.0
+                                                                                   maximumInterval:60.0
+                                                                                              step:2.0]};
+    NSLog(@"fixed: %lu polls, %.2f s mean latency", (unsigned long)fixedPolls, fixedLatency);
+    for (NSString *name in providers) {
+        NSUInteger polls = 0;
+        NSTimeInterval latency = [self simulate:providers[name] polls:&polls];
+        NSLog(@"%@: %lu polls (%.1f%% saved), %.2f s mean latency",
+              name,
+              (unsigned long)polls,
+              100.0 * (1.0 - (double)polls / fixedPolls),
+              latency);
+        XCTAssertLessThan(polls, fixedPolls);
+    }
+}
+
+#pragma mark Private
+
+/**
+ Polls a simulated queue that receives a burst of items every period and is
+ idle otherwise, either every minimum interval or as the adaptive interval
+ decides. Returns the mean time an item waited to be polled.
+ */
+- (NSTimeInterval)simulate:(CHRAdaptiveInterval *)adaptive polls:(NSUInteger *)polls
+{
+    NSTimeInterval now = 0.0;
+    NSTimeInterval nextArrival = 0.0;
+    NSTimeInterval waited = 0.0;
+    NSUInteger items = 0;
+    *polls = 0;
+    while (now < CHRAdaptiveIntervalSimulationDuration) {
+        now += (adaptive)? [adaptive nextInterval] : 1.0;
+        (*polls)++;
+        BOOL didWork = NO;
+        while (nextArrival <= now) {
+            waited += now - nextArrival;
+            items++;
+            didWork = YES;
+            nextArrival += CHRAdaptiveIntervalSimulationArrival;
+            if (fmod(nextArrival, CHRAdaptiveIntervalSimulationPeriod) >= CHRAdaptiveIntervalSimulationBurst) {
+                // The burst is over, skip to the next one.
+                nextArrival = (floor(nextArrival / CHRAdaptiveIntervalSimulationPeriod) + 1) * CHRAdaptiveIntervalSimulationPeriod;
+            }
+        }
+        [adaptive reportWork:didWork];
+    }
+    return waited / MAX(items, 1);
+}
+
+@end
@@ -0,0 +1,261 @@
+//
+//  CHRBatcherTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRBatcher.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSUInteger CHRBatcherBenchmarkItemsPerProducer = 100000;
+
+
+#pragma mark - CHRBatcherTests Interface
+
+@interface CHRBatcherTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRBatcherTests Implementation
+
+@implementation CHRBatcherTests
+
+- (void)testFlushOnCount
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSArray *flushed = nil;
+    CHRBatcher *batcher = [CHRBatcher batcherWithMaximumDelay:60.0
+                                                 maximumCount:3
+                                                   flushBlock:^(NSArray *items) {
+                                                       flushed = items;
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }];
+    [batcher addItem:@1];
+    [batcher addItem:@2];
+    [batcher addItem:@3];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+
+    NSArray *expected = @[@1, @2, @3];
+    XCTAssertEqualObjects(expected, flushed);
+    XCTAssertEqual(1, batcher.flushes);
+    XCTAssertEqual(0, batcher.count);
+
+    [batcher cancel];
+}
+
+- (void)testFlushOnBytes
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSUInteger flushedCount = 0;
+    CHRBatcher *batcher = [CHRBatcher batcherWithMaximumDelay:60.0
+                                                 maximumCount:0
+                                                 maximumBytes:1024
+                                                   flushBlock:^(NSArray *items) {
+                                                       flushedCount = items.count;
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }
+                                               executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    [batcher addItem:@"a" size:512];
+    [batcher addItem:@"b" size:512];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertEqual(2, flushedCount);
+
+    [batcher cancel];
+}
+
+- (void)testFlushOnDelay
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block CFAbsoluteTime flushed = 0;
+    CHRBatcher *batcher = [CHRBatcher batcherWithMaximumDelay:0.1
+                                                 maximumCount:100
+                                                   flushBlock:^(NSArray *items) {
+                                                       flushed = CFAbsoluteTimeGetCurrent();
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }];
+    CFAbsoluteTime added = CFAbsoluteTimeGetCurrent();
+    [batcher addItem:@1];
+    XCTAssertEqual(1, batcher.count);
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertGreaterThanOrEqual(flushed - added, 0.09);
+    XCTAssertEqual(1, batcher.flushes);
+
+    [batcher cancel];
+}
+
+- (void)testExplicitFlush
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRBatcher *batcher = [CHRBatcher batcherWithMaximumDelay:60.0
+                                                 maximumCount:100
+                                                   flushBlock:^(NSArray *items) {
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }];
+    [batcher addItem:@1];
+    [batcher flush];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+
+    [batcher cancel];
+}
+
+- (void)testBatchesNeverExceedMaximumCount
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSUInteger largest = 0;
+    __block NSUInteger total = 0;
+    CHRBatcher *batcher = [CHRBatcher batcherWithMaximumDelay:60.0
+                                                 maximumCount:10
+                                                   flushBlock:^(NSArray *items) {
+                                                       largest = MAX(largest, items.count);
+                                                       total += items.count;
+                                                       if (total == 95) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }];
+    for (NSUInteger i = 0; i < 95; ++i) {
+        [batcher addItem:@(i)];
+    }
+    [batcher flush];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertLessThanOrEqual(largest, 10);
+
+    [batcher cancel];
+}
+
+- (void)testIdleBatcherDoesNotFlush
+{
+    __block BOOL flushed = NO;
+    CHRBatcher *batcher = [CHRBatcher batcherWithMaximumDelay:0.01
+                                                 maximumCount:10
+                                                   flushBlock:^(NSArray *items) {
+                                                       flushed = YES;
+                                                   }];
+    [NSThread sleepForTimeInterval:0.2];
+
+    XCTAssertFalse(flushed);
+    XCTAssertEqual(0, batcher.flushes);
+
+    [batcher cancel];
+}
+
+- (void)testCancel
+{
+    __block BOOL flushed = NO;
+    CHRBatcher *batcher = [CHRBatcher batcherWithMaximumDelay:0.05
+                                                 maximumCount:10
+                                                   flushBlock:^(NSArray *items) {
+                                                       flushed = YES;
+                                                   }];
+    [batcher addItem:@1];
+    [batcher cancel];
+    [batcher addItem:@2];
+    [NSThread sleepForTimeInterval:0.2];
+
+    XCTAssertFalse(batcher.isValid);
+    XCTAssertFalse(flushed);
+}
+
+- (void)testConcurrentProducersLoseNothing
+{
+    [self benchmarkProducerCount:8 itemsPerProducer:10000];
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmark1Producer
+{
+    [self benchmarkProducerCount:1 itemsPerProducer:CHRBatcherBenchmarkItemsPerProducer];
+}
+
+- (void)testBenchmark8Producers
+{
+    [self benchmarkProducerCount:8 itemsPerProducer:CHRBatcherBenchmarkItemsPerProducer];
+}
+
+- (void)testBenchmark32Producers
+{
+    [self benchmarkProducerCount:32 itemsPerProducer:CHRBatcherBenchmarkItemsPerProducer];
+}
+
+#pragma mark Private
+
+/**
+ Reports the items added per second and the mean and maximum latency from adding
+ an item to its flush, with the given number of producers adding concurrently.
+ Every item records the time it was added.
+ */
+- (void)benchmarkProducerCount:(NSUInteger)producers itemsPerProducer:(NSUInteger)itemsPerProducer
+{
+    NSUInteger total = producers * itemsPerProducer;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSUInteger received = 0;
+    __block double latencySum = 0;
+    __block double latencyMax = 0;
+    CHRBatcher *batcher = [CHRBatcher batcherWithMaximumDelay:0.005
+                                                 maximumCount:1024
+                                                   flushBlock:^(NSArray *items) {
+                                                       CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+                                                       for (NSNumber *item in items) {
+                                                           double latency = now - item.doubleValue;
+                                                           latencySum += latency;
+                                                           latencyMax = MAX(latencyMax, latency);
+                                                       }
+                                                       received += items.count;
+                                                       if (received == total) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }];
+
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    dispatch_group_t group = dispatch_group_create();
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < producers; ++i) {
+        dispatch_group_async(group, queue, ^{
+            for (NSUInteger j = 0; j < itemsPerProducer; ++j) {
+                [batcher addItem:@(CFAbsoluteTimeGetCurrent())];
+            }
+        });
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    CFAbsoluteTime produced = CFAbsoluteTimeGetCurrent();
+
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    NSLog(@"%lu producers: %.0f items per second, %.3f ms mean latency, %.3f ms max latency, %llu flushes",
+          (unsigned long)producers,
+          total / (produced - start),
+          latencySum * 1000.0 / total,
+          latencyMax * 1000.0,
+          batcher.flushes);
+    XCTAssertEqual(total, received);
+
+    [batcher cancel];
+}
+
+@end
@@ -0,0 +1,221 @@
+//
+//  CHRCalendarScheduleTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRCalendarSchedule.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSUInteger CHRCalendarScheduleBenchmarkIterations = 10000;
+
+
+#pragma mark - CHRCalendarScheduleTests Interface
+
+@interface CHRCalendarScheduleTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRCalendarScheduleTests Implementation
+
+@implementation CHRCalendarScheduleTests
+
+- (void)testInvalidExpressions
+{
+    NSTimeZone *utc = [NSTimeZone timeZoneWithName:@"UTC"];
+    NSArray *expressions = @[@"", @"* * * *", @"* * * * * *", @"60 * * * *", @"* 24 * * *", @"* * 0 * *",
+                             @"* * * 13 *", @"* * * * 8", @"5-1 * * * *", @"*/0 * * * *", @"a b c d e",
+                             @"0 0 30 2 *", @"0 0 31 4,6 *", @"@often"];
+    for (NSString *expression in expressions) {
+        XCTAssertNil([CHRCalendarSchedule scheduleWithExpression:expression timeZone:utc], @"%@", expression);
+    }
+}
+
+- (void)testValidExpressions
+{
+    NSTimeZone *utc = [NSTimeZone timeZoneWithName:@"UTC"];
+    NSArray *expressions = @[@"* * * * *", @"*/15 9-17/2 1,15 jan-mar,DEC sun,7", @"5/20 * * * *",
+                             @"0 0 * * MON-FRI", @"  0 12 * * 7  ", @"@yearly", @"@DAILY", @"@hourly"];
+    for (NSString *expression in expressions) {
+        XCTAssertNotNil([CHRCalendarSchedule scheduleWithExpression:expression timeZone:utc], @"%@", expression);
+    }
+}
+
+- (void)testWeekdays
+{
+    NSTimeZone *utc = [NSTimeZone timeZoneWithName:@"UTC"];
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"15 2 * * 1-5" timeZone:utc];
+    
+    // Friday 2026-10-16 03:00 UTC, the next weekday is Monday 2026-10-19 02:15
+    XCTAssertEqual(1792376100, [schedule nextFireTimeAfterTime:1792119600]);
+    // Monday 2026-10-19 02:15 UTC, strictly after is Tuesday 02:15
+    XCTAssertEqual(1792376100 + 86400, [schedule nextFireTimeAfterTime:1792376100]);
+    // Monday 2026-10-19 02:14:59.5 UTC
+    XCTAssertEqual(1792376100, [schedule nextFireTimeAfterTime:1792376099.5]);
+}
+
+- (void)testMonthBoundaries
+{
+    NSTimeZone *utc = [NSTimeZone timeZoneWithName:@"UTC"];
+    
+    // 2026-01-31 00:00 UTC, February has no 31st, the next is 2026-03-31
+    CHRCalendarSchedule *lastDay = [CHRCalendarSchedule scheduleWithExpression:@"0 0 31 * *" timeZone:utc];
+    XCTAssertEqual(1774915200, [lastDay nextFireTimeAfterTime:1769817600]);
+    
+    // 2025-03-01 00:00 UTC, the next leap day is 2028-02-29 12:00
+    CHRCalendarSchedule *leapDay = [CHRCalendarSchedule scheduleWithExpression:@"0 12 29 2 *" timeZone:utc];
+    XCTAssertEqual(1835438400, [leapDay nextFireTimeAfterTime:1740787200]);
+    
+    // 2026-12-31 23:59 UTC, the next is 2027-01-01 00:00
+    CHRCalendarSchedule *yearly = [CHRCalendarSchedule scheduleWithExpression:@"@yearly" timeZone:utc];
+    XCTAssertEqual(1798761600, [yearly nextFireTimeAfterTime:1798761540]);
+}
+
+- (void)testDayOfMonthOrDayOfWeek
+{
+    NSTimeZone *utc = [NSTimeZone timeZoneWithName:@"UTC"];
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"0 0 13 * FRI" timeZone:utc];
+    
+    // 2026-11-01 00:00 UTC, Friday 2026-11-06 comes before the 13th
+    XCTAssertEqual(1793923200, [schedule nextFireTimeAfterTime:1793491200]);
+    // 2026-11-10 00:00 UTC, Friday 2026-11-13 matches both fields and fires once
+    XCTAssertEqual(1794528000, [schedule nextFireTimeAfterTime:1794268800]);
+    XCTAssertEqual(1794528000 + 7 * 86400, [schedule nextFireTimeAfterTime:1794528000]);
+}
+
+- (void)testDaylightSavingTimeSkippedTime
+{
+    NSTimeZone *newYork = [NSTimeZone timeZoneWithName:@"America/New_York"];
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"30 2 * * *" timeZone:newYork];
+    
+    // Clocks go from 02:00 EST to 03:00 EDT on 2026-03-08, skipping 02:30, which
+    // fires at 03:00 EDT (07:00 UTC) instead
+    NSTimeInterval first = [schedule nextFireTimeAfterTime:1772884800];
+    XCTAssertEqual(1772953200, first);
+    // 2026-03-09 02:30 EDT
+    XCTAssertEqual(1773037800, [schedule nextFireTimeAfterTime:first]);
+}
+
+- (void)testDaylightSavingTimeRepeatedTime
+{
+    NSTimeZone *newYork = [NSTimeZone timeZoneWithName:@"America/New_York"];
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"30 1 * * *" timeZone:newYork];
+    
+    // Clocks go from 02:00 EDT back to 01:00 EST on 2026-11-01, 01:30 fires at
+    // its first occurrence only
+    NSTimeInterval first = [schedule nextFireTimeAfterTime:1793448000];
+    XCTAssertEqual(1793511000, first);
+    // 2026-11-02 01:30 EST
+    XCTAssertEqual(1793601000, [schedule nextFireTimeAfterTime:first]);
+    
+    CHRCalendarSchedule *halfHourly = [CHRCalendarSchedule scheduleWithExpression:@"0,30 * * * *" timeZone:newYork];
+    // A wildcard hour keeps firing through the repeated hour: 01:30 EDT, then
+    // 01:00 EST, 01:30 EST and 02:00 EST
+    NSTimeInterval time = 1793511000;
+    for (NSNumber *expected in @[@1793512800, @1793514600, @1793516400, @1793518200]) {
+        time = [halfHourly nextFireTimeAfterTime:time];
+        XCTAssertEqual(expected.doubleValue, time);
+    }
+    // From inside the repeated hour, the second occurrence of 01:30
+    XCTAssertEqual(1793514600, [halfHourly nextFireTimeAfterTime:1793513700]);
+}
+
+- (void)testEveryMinuteMatchesCalendar
+{
+    NSTimeZone *newYork = [NSTimeZone timeZoneWithName:@"America/New_York"];
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"*/7 */5 * * *" timeZone:newYork];
+    NSCalendar *calendar = [NSCalendar calendarWithIdentifier:NSCalendarIdentifierGregorian];
+    calendar.timeZone = newYork;
+    
+    NSTimeInterval time = 1772323200;   // 2026-03-01 00:00 UTC, across both transitions
+    for (NSUInteger i = 0; i < 12000; ++i) {
+        NSTimeInterval next = [schedule nextFireTimeAfterTime:time];
+        XCTAssertGreaterThan(next, time);
+        NSDateComponents *components = [calendar components:NSCalendarUnitHour | NSCalendarUnitMinute
+                                                   fromDate:[NSDate dateWithTimeIntervalSince1970:next]];
+        XCTAssertEqual(0, components.minute % 7);
+        XCTAssertEqual(0, components.hour % 5);
+        time = next;
+    }
+}
+
+- (void)testNextFireDate
+{
+    NSTimeZone *utc = [NSTimeZone timeZoneWithName:@"UTC"];
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"@hourly" timeZone:utc];
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1792119600];
+    
+    XCTAssertEqualObjects([NSDate dateWithTimeIntervalSince1970:1792123200], [schedule nextFireDateAfterDate:date]);
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkNextFireTime
+{
+    NSTimeZone *newYork = [NSTimeZone timeZoneWithName:@"America/New_York"];
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"15 2 * * 1-5" timeZone:newYork];
+    NSCalendar *calendar = [NSCalendar calendarWithIdentifier:NSCalendarIdentifierGregorian];
+    calendar.timeZone = newYork;
+    
+    NSTimeInterval time = 1767225600;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < CHRCalendarScheduleBenchmarkIterations; ++i) {
+        time = [schedule nextFireTimeAfterTime:time];
+    }
+    CFAbsoluteTime compiled = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1767225600];
+    start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < CHRCalendarScheduleBenchmarkIterations; ++i) {
+        do {
+            date = [calendar nextDateAfterDate:date matchingHour:2 minute:15 second:0 options:NSCalendarMatchNextTime];
+        } while ([calendar isDateInWeekend:date]);
+    }
+    CFAbsoluteTime calendared = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSLog(@"next fire time: %.0f ns compiled, %.0f ns NSCalendar",
+          compiled * NSEC_PER_SEC / CHRCalendarScheduleBenchmarkIterations,
+          calendared * NSEC_PER_SEC / CHRCalendarScheduleBenchmarkIterations);
+    XCTAssertEqualWithAccuracy(time, date.timeIntervalSince1970, 1.0);
+}
+
+- (void)testPerformanceNextFireTime
+{
+    NSTimeZone *newYork = [NSTimeZone timeZoneWithName:@"America/New_York"];
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"*/5 9-17 * * MON-FRI" timeZone:newYork];
+    [self measureBlock:^{
+        NSTimeInterval time = 1767225600;
+        for (NSUInteger i = 0; i < CHRCalendarScheduleBenchmarkIterations; ++i) {
+            time = [schedule nextFireTimeAfterTime:time];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,120 @@
+//
+//  CHRCalendarTimerTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRCalendarTimer.h"
+
+
+#pragma mark - CHRCalendarTimerTests Interface
+
+@interface CHRCalendarTimerTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRCalendarTimerTests Implementation
+
+@implementation CHRCalendarTimerTests
+
+- (void)testStartNow
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"@yearly"];
+    CHRCalendarTimer *timer = [CHRCalendarTimer timerWithSchedule:schedule
+                                                   executionBlock:^(CHRCalendarTimer *__weak timer, NSUInteger invocation) {
+                                                       XCTAssertEqual(0, invocation);
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertTrue(timer.isRunning);
+    XCTAssertEqual(1, timer.invocations);
+
+    [timer cancel];
+}
+
+- (void)testNextFireDate
+{
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"0 3 * * *"];
+    CHRCalendarTimer *timer = [CHRCalendarTimer timerWithSchedule:schedule
+                                                   executionBlock:^(CHRCalendarTimer *__weak timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }];
+    XCTAssertNil(timer.nextFireDate);
+
+    NSDate *now = [NSDate date];
+    [timer start:NO];
+    XCTAssertEqualObjects([schedule nextFireDateAfterDate:now], timer.nextFireDate);
+
+    [timer pause];
+    XCTAssertFalse(timer.isRunning);
+    XCTAssertNil(timer.nextFireDate);
+
+    [timer start:NO];
+    XCTAssertNotNil(timer.nextFireDate);
+
+    [timer cancel];
+    XCTAssertFalse(timer.isValid);
+    XCTAssertNil(timer.nextFireDate);
+}
+
+- (void)testFiresAtMinuteBoundary
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSTimeInterval fired = 0;
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"* * * * *"];
+    CHRCalendarTimer *timer = [CHRCalendarTimer timerWithSchedule:schedule
+                                                   executionBlock:^(CHRCalendarTimer *__weak timer, NSUInteger invocation) {
+                                                       fired = [[NSDate date] timeIntervalSince1970];
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }];
+    [timer start:NO];
+    NSTimeInterval expected = timer.nextFireDate.timeIntervalSince1970;
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(61.0)));
+    XCTAssertGreaterThanOrEqual(fired, expected);
+    XCTAssertLessThan(fired - expected, 2.0);
+    XCTAssertEqualWithAccuracy(expected + 60.0, timer.nextFireDate.timeIntervalSince1970, 0.001);
+
+    [timer cancel];
+}
+
+- (void)testCanceledTimerThrows
+{
+    CHRCalendarSchedule *schedule = [CHRCalendarSchedule scheduleWithExpression:@"@daily"];
+    CHRCalendarTimer *timer = [CHRCalendarTimer timerWithSchedule:schedule
+                                                   executionBlock:^(CHRCalendarTimer *__weak timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }];
+    [timer cancel];
+
+    XCTAssertThrowsSpecific([timer start:NO], NSException);
+    XCTAssertThrowsSpecific([timer pause], NSException);
+}
+
+@end
@@ -0,0 +1,224 @@
+//
+//  CHRDebouncerTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRDebouncer.h"
+
+
+#pragma mark - Constants and Functions
+
+static size_t CHRDebouncerBenchmarkSignals = 10000000;
+static size_t CHRDebouncerBenchmarkTimers = 10000;
+
+
+#pragma mark - CHRDebouncerTests Interface
+
+@interface CHRDebouncerTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRDebouncerTests Implementation
+
+@implementation CHRDebouncerTests
+
+- (void)testBurstExecutesOnce
+{
+    __block atomic_int executions = 0;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDebouncer *debouncer = [CHRDebouncer debouncerWithInterval:0.1 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+        dispatch_semaphore_signal(semaphore);
+    }];
+    
+    dispatch_apply(1000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        [debouncer signal];
+    });
+    
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [NSThread sleepForTimeInterval:0.3];
+    XCTAssertEqual(1, atomic_load(&executions));
+    
+    [debouncer cancel];
+    XCTAssertFalse(debouncer.isValid);
+}
+
+- (void)testSignalsExtendBurst
+{
+    __block atomic_int executions = 0;
+    CHRDebouncer *debouncer = [CHRDebouncer debouncerWithInterval:0.2 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    for (NSUInteger i = 0; i < 5; ++i) {
+        [debouncer signal];
+        [NSThread sleepForTimeInterval:0.05];
+    }
+    XCTAssertEqual(0, atomic_load(&executions));
+    
+    [NSThread sleepForTimeInterval:0.4];
+    XCTAssertEqual(1, atomic_load(&executions));
+    
+    [debouncer signal];
+    [NSThread sleepForTimeInterval:0.4];
+    XCTAssertEqual(2, atomic_load(&executions));
+    
+    [debouncer cancel];
+}
+
+- (void)testLeadingEdge
+{
+    __block atomic_int executions = 0;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDebouncer *debouncer = [CHRDebouncer debouncerWithInterval:1.0 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+        dispatch_semaphore_signal(semaphore);
+    }];
+    debouncer.leading = YES;
+    debouncer.trailing = NO;
+    
+    [debouncer signal];
+    [debouncer signal];
+    [debouncer signal];
+    
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(0.5)));
+    XCTAssertEqual(1, atomic_load(&executions));
+    
+    [debouncer cancel];
+}
+
+- (void)testMaximumWait
+{
+    __block atomic_int executions = 0;
+    CHRDebouncer *debouncer = [CHRDebouncer debouncerWithInterval:0.2 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    debouncer.maximumWait = 0.3;
+    
+    NSDate *end = [NSDate dateWithTimeIntervalSinceNow:1.0];
+    while ([end timeIntervalSinceNow] > 0) {
+        [debouncer signal];
+        [NSThread sleepForTimeInterval:0.02];
+    }
+    
+    XCTAssertGreaterThanOrEqual(atomic_load(&executions), 2);
+    
+    [debouncer cancel];
+}
+
+- (void)testCancelDropsPendingExecution
+{
+    __block atomic_int executions = 0;
+    CHRDebouncer *debouncer = [CHRDebouncer debouncerWithInterval:0.1 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    [debouncer signal];
+    [debouncer cancel];
+    [debouncer signal];
+    [NSThread sleepForTimeInterval:0.3];
+    
+    XCTAssertEqual(0, atomic_load(&executions));
+}
+
+- (void)testSignalAfterCancelIsIgnored
+{
+    __block atomic_int executions = 0;
+    CHRDebouncer *debouncer = [CHRDebouncer debouncerWithInterval:0.1 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    debouncer.leading = YES;
+    
+    [debouncer cancel];
+    [debouncer signal];
+    [debouncer signal];
+    [NSThread sleepForTimeInterval:0.3];
+    
+    XCTAssertEqual(0, atomic_load(&executions));
+}
+
+#pragma mark Benchmarks
+
+/**
+ Reports the sustained signal rate of a debouncer under a burst of millions of
+ concurrent signals, next to the cost of restarting a dispatch timer per event.
+ */
+- (void)testBenchmarkSignalThroughput
+{
+    __block atomic_int executions = 0;
+    CHRDebouncer *debouncer = [CHRDebouncer debouncerWithInterval:0.05 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    dispatch_apply(CHRDebouncerBenchmarkSignals, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        [debouncer signal];
+    });
+    NSTimeInterval debounced = CFAbsoluteTimeGetCurrent() - start;
+    
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    start = CFAbsoluteTimeGetCurrent();
+    CHRDispatchTimer *timer = nil;
+    for (size_t i = 0; i < CHRDebouncerBenchmarkTimers; ++i) {
+        [timer cancel];
+        timer = [CHRDispatchTimer timerWithInterval:0.05
+                                     executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                         // nothing to do
+                                     }
+                                     executionQueue:queue];
+        [timer start:NO];
+    }
+    [timer cancel];
+    NSTimeInterval restarted = CFAbsoluteTimeGetCurrent() - start;
+    
+    [NSThread sleepForTimeInterval:0.2];
+    NSLog(@"debouncer: %.0f signals per second, %d executions; timer per event: %.0f events per second",
+          CHRDebouncerBenchmarkSignals / debounced,
+          atomic_load(&executions),
+          CHRDebouncerBenchmarkTimers / restarted);
+    XCTAssertEqual(1, atomic_load(&executions));
+    
+    [debouncer cancel];
+}
+
+- (void)testPerformanceSignal
+{
+    CHRDebouncer *debouncer = [CHRDebouncer debouncerWithInterval:1.0 executionBlock:^{
+        // nothing to do
+    }];
+    [self measureBlock:^{
+        for (size_t i = 0; i < 1000000; ++i) {
+            [debouncer signal];
+        }
+    }];
+    [debouncer cancel];
+}
+
+@end
@@ -31,6 +31,11 @@
 #import "CHRDispatchTimer.h"
 
 
+#pragma mark - Constants and Functions
+
+static size_t CHRStressIterations = 100000;
+
+
 #pragma mark - CHRDispatchTimerTests Interface
 
 @interface CHRDispatchTimerTests : XCTestCase
@@ -142,4 +147,241 @@
     [timer cancel];
 }
 
+
+- (void)testConcurrentStartPauseCancel
+{
+    __block _Atomic(int32_t) fired = 0;
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.001
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       atomic_store(&fired, 1);
+                                                   }];
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    dispatch_apply(CHRStressIterations, queue, ^(size_t i) {
+        if (i % 2) {
+            [timer start:(i % 3 == 0)];
+        } else {
+            [timer pause];
+        }
+    });
+    
+    // An unbalanced suspend count would keep the source from firing.
+    [timer pause];
+    XCTAssertFalse(timer.isRunning);
+    atomic_store(&fired, 0);
+    [timer start:YES];
+    XCTAssertTrue(timer.isRunning);
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(1, atomic_load(&fired));
+    
+    dispatch_apply(CHRStressIterations, queue, ^(size_t i) {
+        @try {
+            switch (i % 3) {
+                case 0: [timer start:NO]; break;
+                case 1: [timer pause]; break;
+                default: [timer cancel]; break;
+            }
+        } @catch (NSException *exception) {
+            // start and pause throw once the timer has been canceled
+        }
+    });
+    XCTAssertFalse(timer.isValid);
+    XCTAssertFalse(timer.isRunning);
+}
+
+- (void)testCatchUpPolicySkip
+{
+    NSArray *invocations = [self invocationsAfterOverrunWithPolicy:CHRCatchUpPolicySkip elapsedPeriods:NULL missed:NULL];
+    XCTAssertEqual(0, [invocations[0] unsignedIntegerValue]);
+    XCTAssertGreaterThan([invocations[1] unsignedIntegerValue], 1);
+}
+
+- (void)testCatchUpPolicyCoalesce
+{
+    NSUInteger elapsedPeriods = 0;
+    NSUInteger missed = 0;
+    NSArray *invocations = [self invocationsAfterOverrunWithPolicy:CHRCatchUpPolicyCoalesce elapsedPeriods:&elapsedPeriods missed:&missed];
+    XCTAssertEqual(1, [invocations[1] unsignedIntegerValue]);
+    XCTAssertGreaterThan(elapsedPeriods, 1);
+    XCTAssertEqual(0, missed);
+}
+
+- (void)testCatchUpPolicyReplay
+{
+    NSUInteger missed = 0;
+    NSArray *invocations = [self invocationsAfterOverrunWithPolicy:CHRCatchUpPolicyReplay elapsedPeriods:NULL missed:&missed];
+    NSUInteger first = [invocations[1] unsignedIntegerValue];
+    XCTAssertEqual(first + 1, [invocations[2] unsignedIntegerValue]);
+    XCTAssertEqual(first + 2, [invocations[3] unsignedIntegerValue]);
+    XCTAssertGreaterThan(missed, 0);
+    XCTAssertEqual(first, missed + 1);
+}
+
+- (void)testOverlapPolicyUnbounded
+{
+    NSUInteger skipped = 0;
+    NSUInteger overlap = [self maximumOverlapWithPolicy:CHROverlapPolicyUnbounded concurrency:1 skipped:&skipped];
+    
+    XCTAssertGreaterThan(overlap, 1);
+    XCTAssertEqual(0, skipped);
+}
+
+- (void)testOverlapPolicySkip
+{
+    NSUInteger skipped = 0;
+    NSUInteger overlap = [self maximumOverlapWithPolicy:CHROverlapPolicySkip concurrency:4 skipped:&skipped];
+    
+    XCTAssertEqual(1, overlap);
+    XCTAssertGreaterThan(skipped, 0);
+}
+
+- (void)testOverlapPolicyConcurrent
+{
+    NSUInteger skipped = 0;
+    NSUInteger overlap = [self maximumOverlapWithPolicy:CHROverlapPolicyConcurrent concurrency:2 skipped:&skipped];
+    
+    XCTAssertLessThanOrEqual(overlap, 2);
+    XCTAssertGreaterThan(skipped, 0);
+}
+
+- (void)testOverlapPolicyQueue
+{
+    NSUInteger skipped = 0;
+    NSUInteger overlap = [self maximumOverlapWithPolicy:CHROverlapPolicyQueue concurrency:2 skipped:&skipped];
+    
+    XCTAssertLessThanOrEqual(overlap, 2);
+    XCTAssertGreaterThan(skipped, 0);
+}
+
+- (void)testOverlapPolicyChangedWhilePaused
+{
+    __block atomic_uint inFlight = 0;
+    __block atomic_uint maximum = 0;
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.01
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       unsigned int current = atomic_fetch_add(&inFlight, 1) + 1;
+                                                       unsigned int observed = atomic_load(&maximum);
+                                                       while (current > observed && !atomic_compare_exchange_weak(&maximum, &observed, current));
+                                                       [NSThread sleepForTimeInterval:0.05];
+                                                       atomic_fetch_sub(&inFlight, 1);
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_CONCURRENT)
+                                                        scheduler:[CHRTimerWheel wheelWithResolution:0.005]];
+    timer.overlapPolicy = CHROverlapPolicySkip;
+    [timer start:YES];
+    [NSThread sleepForTimeInterval:0.2];
+    [timer pause];
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(1, atomic_load(&maximum));
+    
+    timer.overlapPolicy = CHROverlapPolicyConcurrent;
+    timer.maximumConcurrentExecutions = 3;
+    [timer start:YES];
+    [NSThread sleepForTimeInterval:0.3];
+    [timer cancel];
+    [NSThread sleepForTimeInterval:0.1];
+    
+    XCTAssertEqual(3, atomic_load(&maximum));
+}
+
+#pragma mark Benchmarks
+
+- (void)testPerformanceContendedStartPause
+{
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:60.0
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }];
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    [self measureBlock:^{
+        dispatch_apply(CHRStressIterations, queue, ^(size_t i) {
+            if (i % 2) {
+                [timer start:NO];
+            } else {
+                [timer pause];
+            }
+        });
+    }];
+    [timer cancel];
+}
+
+
+#pragma mark Private
+
+/**
+ Runs a timer whose first execution takes ten periods and returns the
+ invocation numbers of its first executions.
+ */
+- (NSArray *)invocationsAfterOverrunWithPolicy:(CHRCatchUpPolicy)policy
+                                elapsedPeriods:(NSUInteger *)elapsedPeriods
+                                        missed:(NSUInteger *)missed
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    NSMutableArray *invocations = [NSMutableArray array];
+    __block NSUInteger periods = 0;
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.01
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       [invocations addObject:@(invocation)];
+                                                       if (invocations.count == 1) {
+                                                           [NSThread sleepForTimeInterval:0.1];
+                                                       } else if (invocations.count == 2) {
+                                                           periods = timer.elapsedPeriods;
+                                                       } else if (invocations.count == 4) {
+                                                           [timer pause];
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    timer.catchUpPolicy = policy;
+    timer.maximumReplayedInvocations = 3;
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    if (elapsedPeriods) {
+        *elapsedPeriods = periods;
+    }
+    if (missed) {
+        *missed = timer.missedInvocations;
+    }
+    [timer cancel];
+    return invocations;
+}
+
+/**
+ Runs a timer whose executions take five periods on a concurrent queue and
+ returns the largest number of executions observed in flight at once.
+ */
+- (NSUInteger)maximumOverlapWithPolicy:(CHROverlapPolicy)policy
+                           concurrency:(NSUInteger)concurrency
+                               skipped:(NSUInteger *)skipped
+{
+    __block atomic_uint inFlight = 0;
+    __block atomic_uint maximum = 0;
+    __block atomic_uint skipBlockCalls = 0;
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.01
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       unsigned int current = atomic_fetch_add(&inFlight, 1) + 1;
+                                                       unsigned int observed = atomic_load(&maximum);
+                                                       while (current > observed && !atomic_compare_exchange_weak(&maximum, &observed, current));
+                                                       [NSThread sleepForTimeInterval:0.05];
+                                                       atomic_fetch_sub(&inFlight, 1);
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_CONCURRENT)
+                                                        scheduler:[CHRTimerWheel wheelWithResolution:0.005]];
+    timer.overlapPolicy = policy;
+    timer.maximumConcurrentExecutions = concurrency;
+    timer.maximumPendingExecutions = 2;
+    timer.skipBlock = ^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+        atomic_fetch_add(&skipBlockCalls, 1);
+    };
+    [timer start:YES];
+    [NSThread sleepForTimeInterval:0.5];
+    [timer cancel];
+    [NSThread sleepForTimeInterval:0.2];
+    
+    XCTAssertEqual(timer.skippedInvocations, atomic_load(&skipBlockCalls));
+    if (skipped) {
+        *skipped = timer.skippedInvocations;
+    }
+    return atomic_load(&maximum);
+}
+
 @end
@@ -0,0 +1,338 @@
+//
+//  CHRExecutionQueuePoolTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+#import "CHRExecutionQueuePool.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSTimeInterval CHRExecutionQueuePoolBenchmarkInterval = 0.01;
+static NSTimeInterval CHRExecutionQueuePoolBenchmarkDuration = 1.0;
+static NSTimeInterval CHRExecutionQueuePoolFloodWork = 0.005;
+static NSTimeInterval CHRExecutionQueuePoolHeartbeatInterval = 0.01;
+static NSUInteger CHRExecutionQueuePoolHeartbeatCount = 4;
+
+
+#pragma mark - CHRExecutionQueuePoolTests Interface
+
+@interface CHRExecutionQueuePoolTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRExecutionQueuePoolTests Implementation
+
+@implementation CHRExecutionQueuePoolTests
+
+- (void)testQueueIsStablePerObject
+{
+    CHRExecutionQueuePool *pool = [[CHRExecutionQueuePool alloc]initWithQueueCount:8];
+    NSObject *object = [NSObject new];
+    
+    XCTAssertEqual([pool queueForObject:object], [pool queueForObject:object]);
+}
+
+- (void)testQueueCountIsBounded
+{
+    CHRExecutionQueuePool *pool = [[CHRExecutionQueuePool alloc]initWithQueueCount:4];
+    NSMutableSet *queues = [NSMutableSet set];
+    for (NSUInteger i = 0; i < 1000; ++i) {
+        [queues addObject:[pool queueForObject:[NSObject new]]];
+    }
+    
+    XCTAssertEqual(4, pool.queueCount);
+    XCTAssertLessThanOrEqual(queues.count, 4);
+    XCTAssertGreaterThan(queues.count, 1);
+}
+
+- (void)testZeroQueueCount
+{
+    CHRExecutionQueuePool *pool = [[CHRExecutionQueuePool alloc]initWithQueueCount:0];
+    
+    XCTAssertEqual(1, pool.queueCount);
+    XCTAssertNotNil([pool queueForObject:[NSObject new]]);
+}
+
+- (void)testDefaultQueueIsFromSharedPool
+{
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.5
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }];
+    
+    XCTAssertEqual([[CHRExecutionQueuePool sharedPool] queueForObject:timer], timer.executionQueue);
+    
+    [timer cancel];
+}
+
+- (void)testTimerExecutionIsSerial
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block _Atomic(int32_t) executing = 0;
+    __block BOOL overlapped = NO;
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.01
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       if (atomic_fetch_add(&executing, 1) > 0) {
+                                                           overlapped = YES;
+                                                       }
+                                                       [NSThread sleepForTimeInterval:0.02];
+                                                       atomic_fetch_sub(&executing, 1);
+                                                       if (invocation == 5) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }];
+    [timer start:YES];
+    dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout));
+    [timer cancel];
+    
+    XCTAssertFalse(overlapped);
+}
+
+- (void)testPriorityPools
+{
+    CHRExecutionQueuePool *high = [CHRExecutionQueuePool sharedPoolForPriority:CHRTimerPriorityHigh];
+    CHRExecutionQueuePool *background = [CHRExecutionQueuePool sharedPoolForPriority:CHRTimerPriorityBackground];
+    
+    XCTAssertEqual([CHRExecutionQueuePool sharedPool], [CHRExecutionQueuePool sharedPoolForPriority:CHRTimerPriorityDefault]);
+    XCTAssertEqual(high, [CHRExecutionQueuePool sharedPoolForPriority:CHRTimerPriorityHigh]);
+    XCTAssertNotEqual(high, background);
+    XCTAssertNotEqual(high, [CHRExecutionQueuePool sharedPoolForPriority:CHRTimerPriorityUtility]);
+    XCTAssertGreaterThanOrEqual(background.queueCount, 1);
+    XCTAssertLessThanOrEqual(background.queueCount, high.queueCount);
+}
+
+- (void)testPriorityTimerQueue
+{
+    CHRDispatchTimer *dispatchTimer = [CHRDispatchTimer timerWithInterval:0.5
+                                                           executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                               // nothing to do
+                                                           }
+                                                                 priority:CHRTimerPriorityHigh];
+    CHRVariableTimer *variableTimer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.5;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    } priority:CHRTimerPriorityBackground];
+    
+    XCTAssertEqual(CHRTimerPriorityHigh, dispatchTimer.priority);
+    XCTAssertEqual([[CHRExecutionQueuePool sharedPoolForPriority:CHRTimerPriorityHigh] queueForObject:dispatchTimer], dispatchTimer.executionQueue);
+    XCTAssertEqual(CHRTimerPriorityBackground, variableTimer.priority);
+    XCTAssertEqual([[CHRExecutionQueuePool sharedPoolForPriority:CHRTimerPriorityBackground] queueForObject:variableTimer], variableTimer.executionQueue);
+    
+    [dispatchTimer cancel];
+    [variableTimer cancel];
+}
+
+- (void)testPriorityTimerFires
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.01
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       if (invocation == 3) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }
+                                                         priority:CHRTimerPriorityHigh];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    
+    [timer cancel];
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkPriorityIsolation
+{
+    [self benchmarkHeartbeatLatenessIsolated:NO];
+    [self benchmarkHeartbeatLatenessIsolated:YES];
+}
+
+- (void)testBenchmark10kTimers
+{
+    [self benchmarkTimerCount:10000 pooled:NO];
+    [self benchmarkTimerCount:10000 pooled:YES];
+}
+
+- (void)testBenchmark50kTimers
+{
+    [self benchmarkTimerCount:50000 pooled:NO];
+    [self benchmarkTimerCount:50000 pooled:YES];
+}
+
+- (void)testPerformancePrivateQueueCreation
+{
+    [self measureBlock:^{
+        [self createAndCancelTimerCount:10000 pooled:NO];
+    }];
+}
+
+- (void)testPerformancePooledQueueCreation
+{
+    [self measureBlock:^{
+        [self createAndCancelTimerCount:10000 pooled:YES];
+    }];
+}
+
+#pragma mark Private
+
+- (CHRDispatchTimer *)benchmarkTimerPooled:(BOOL)pooled invocations:(_Atomic(int64_t) *)invocations
+{
+    CHRRepeatingTimerExecutionBlock executionBlock = ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        atomic_fetch_add_explicit(invocations, 1, memory_order_relaxed);
+    };
+    if (pooled) {
+        return [CHRDispatchTimer timerWithInterval:CHRExecutionQueuePoolBenchmarkInterval
+                                    executionBlock:executionBlock];
+    }
+    // The per-timer private queue used before the shared pool existed.
+    return [CHRDispatchTimer timerWithInterval:CHRExecutionQueuePoolBenchmarkInterval
+                                executionBlock:executionBlock
+                                executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+}
+
+- (void)createAndCancelTimerCount:(NSUInteger)count pooled:(BOOL)pooled
+{
+    static _Atomic(int64_t) invocations = 0;
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        [timers addObject:[self benchmarkTimerPooled:pooled invocations:&invocations]];
+    }
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+}
+
+/**
+ Floods the pools with timers whose execution blocks spin for a few
+ milliseconds, far more work than there are processors, and reports the
+ lateness percentiles of a few heartbeat timers. Without isolation every timer
+ uses the shared pool; with isolation the flood runs at background priority and
+ the heartbeats at high priority.
+ */
+- (void)benchmarkHeartbeatLatenessIsolated:(BOOL)isolated
+{
+    NSUInteger processorCount = [[NSProcessInfo processInfo] activeProcessorCount];
+    CHRTimerPriority floodPriority = (isolated)? CHRTimerPriorityBackground : CHRTimerPriorityDefault;
+    CHRTimerPriority heartbeatPriority = (isolated)? CHRTimerPriorityHigh : CHRTimerPriorityDefault;
+    
+    NSMutableArray *floodTimers = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 4 * processorCount; ++i) {
+        CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:CHRExecutionQueuePoolFloodWork * 2
+                                                       executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                           CFAbsoluteTime end = CFAbsoluteTimeGetCurrent() + CHRExecutionQueuePoolFloodWork;
+                                                           while (CFAbsoluteTimeGetCurrent() < end) {
+                                                               // busy
+                                                           }
+                                                       }
+                                                             priority:floodPriority];
+        [timer start:NO];
+        [floodTimers addObject:timer];
+    }
+    
+    NSMutableArray *heartbeats = [NSMutableArray array];
+    NSMutableArray *samples = [NSMutableArray array];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < CHRExecutionQueuePoolHeartbeatCount; ++i) {
+        NSMutableArray *lateness = [NSMutableArray array];
+        __block CFAbsoluteTime deadline = start + CHRExecutionQueuePoolHeartbeatInterval;
+        CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:CHRExecutionQueuePoolHeartbeatInterval
+                                                       executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                           // Late relative to the earliest period not executed yet.
+                                                           CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+                                                           [lateness addObject:@(MAX(now - deadline, 0.0))];
+                                                           deadline += CHRExecutionQueuePoolHeartbeatInterval * (floor((now - deadline) / CHRExecutionQueuePoolHeartbeatInterval) + 1);
+                                                       }
+                                                             priority:heartbeatPriority];
+        [timer start:NO];
+        [heartbeats addObject:timer];
+        [samples addObject:lateness];
+    }
+    
+    [NSThread sleepForTimeInterval:CHRExecutionQueuePoolBenchmarkDuration * 2];
+    for (CHRDispatchTimer *timer in [heartbeats arrayByAddingObjectsFromArray:floodTimers]) {
+        [timer cancel];
+    }
+    for (CHRDispatchTimer *timer in heartbeats) {
+        dispatch_sync(timer.executionQueue, ^{});
+    }
+    
+    NSArray *sorted = [[samples valueForKeyPath:@"@unionOfArrays.self"] sortedArrayUsingSelector:@selector(compare:)];
+    XCTAssertGreaterThan(sorted.count, 0);
+    if (sorted.count == 0) {
+        return;
+    }
+    double (^percentile)(double) = ^double(double fraction) {
+        return [sorted[MIN((NSUInteger)(fraction * sorted.count), sorted.count - 1)] doubleValue] * 1000.0;
+    };
+    NSLog(@"%@ heartbeat lateness: p50 %.3f ms, p99 %.3f ms, p99.9 %.3f ms, max %.3f ms, %lu samples",
+          (isolated)? @"isolated" : @"shared",
+          percentile(0.5),
+          percentile(0.99),
+          percentile(0.999),
+          [sorted.lastObject doubleValue] * 1000.0,
+          (unsigned long)sorted.count);
+}
+
+/**
+ Reports the resident memory added per timer and the number of execution blocks
+ run per second with every timer firing, for private and pooled queues.
+ */
+- (void)benchmarkTimerCount:(NSUInteger)count pooled:(BOOL)pooled
+{
+    static _Atomic(int64_t) invocations;
+    invocations = 0;
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:count];
+    
+    uint64_t residentBefore = chr_residentSize();
+    for (NSUInteger i = 0; i < count; ++i) {
+        [timers addObject:[self benchmarkTimerPooled:pooled invocations:&invocations]];
+    }
+    uint64_t residentAfter = chr_residentSize();
+    
+    for (CHRDispatchTimer *timer in timers) {
+        [timer start:NO];
+    }
+    [NSThread sleepForTimeInterval:CHRExecutionQueuePoolBenchmarkDuration];
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+    int64_t executions = atomic_load(&invocations);
+    
+    NSLog(@"%@ queues, %lu timers: %.0f bytes per timer, %.0f executions per second",
+          (pooled)? @"pooled" : @"private",
+          (unsigned long)count,
+          (double)(int64_t)(residentAfter - residentBefore) / count,
+          executions / CHRExecutionQueuePoolBenchmarkDuration);
+    XCTAssertGreaterThan(executions, 0);
+}
+
+@end
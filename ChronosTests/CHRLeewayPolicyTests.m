@@ -0,0 +1,168 @@
+//
+//  CHRLeewayPolicyTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRTimerInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRLeewayPolicy.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSTimeInterval CHRLeewayPolicyBenchmarkInterval = 0.01;
+static NSUInteger CHRLeewayPolicyBenchmarkFirings = 200;
+
+static int chr_compareLateness(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+
+#pragma mark - CHRLeewayPolicyTests Interface
+
+@interface CHRLeewayPolicyTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRLeewayPolicyTests Implementation
+
+@implementation CHRLeewayPolicyTests
+
+- (void)testDefaultPolicy
+{
+    CHRLeewayPolicy *policy = [CHRLeewayPolicy defaultPolicy];
+    XCTAssertFalse(policy.isStrict);
+    XCTAssertEqual(50 * NSEC_PER_MSEC, [policy leewayForInterval:1.0]);
+    XCTAssertEqual(0, [policy leewayForInterval:0.0]);
+}
+
+- (void)testPercentagePolicy
+{
+    CHRLeewayPolicy *policy = [CHRLeewayPolicy policyWithPercentage:0.5];
+    XCTAssertFalse(policy.isStrict);
+    XCTAssertEqual(NSEC_PER_SEC, [policy leewayForInterval:2.0]);
+}
+
+- (void)testFixedPolicy
+{
+    CHRLeewayPolicy *policy = [CHRLeewayPolicy policyWithFixedLeeway:0.001];
+    XCTAssertFalse(policy.isStrict);
+    XCTAssertEqual(NSEC_PER_MSEC, [policy leewayForInterval:0.0]);
+    XCTAssertEqual(NSEC_PER_MSEC, [policy leewayForInterval:60.0]);
+}
+
+- (void)testStrictPolicy
+{
+    CHRLeewayPolicy *policy = [CHRLeewayPolicy strictPolicy];
+    XCTAssertTrue(policy.isStrict);
+    XCTAssertEqual(0, [policy leewayForInterval:60.0]);
+}
+
+- (void)testTimerUsesDefaultPolicy
+{
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:1.0
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }];
+    XCTAssertEqual([CHRLeewayPolicy defaultPolicy], timer.leewayPolicy);
+}
+
+- (void)testStrictTimerFires
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.05
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       if (invocation == 2) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)
+                                                     leewayPolicy:[CHRLeewayPolicy strictPolicy]
+                                                     failureBlock:NULL];
+    XCTAssertTrue(timer.leewayPolicy.isStrict);
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [timer cancel];
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkLatenessByPolicy
+{
+    [self benchmarkPolicy:[CHRLeewayPolicy defaultPolicy]];
+    [self benchmarkPolicy:[CHRLeewayPolicy policyWithPercentage:0.5]];
+    [self benchmarkPolicy:[CHRLeewayPolicy policyWithFixedLeeway:0.0001]];
+    [self benchmarkPolicy:[CHRLeewayPolicy strictPolicy]];
+}
+
+#pragma mark Private
+
+/**
+ Reports the median, 99th percentile and maximum lateness of a timer firing at
+ a short interval with the given policy.
+ */
+- (void)benchmarkPolicy:(CHRLeewayPolicy *)policy
+{
+    NSUInteger firings = CHRLeewayPolicyBenchmarkFirings;
+    uint64_t interval = chr_nanoseconds(CHRLeewayPolicyBenchmarkInterval);
+    uint64_t *lateness = calloc(firings, sizeof(uint64_t));
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block uint64_t start = 0;
+
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:CHRLeewayPolicyBenchmarkInterval
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       if (invocation >= firings) {
+                                                           return;
+                                                       }
+                                                       uint64_t expected = start + (invocation + 1) * interval;
+                                                       uint64_t now = chr_now();
+                                                       lateness[invocation] = (now > expected)? now - expected : 0;
+                                                       if (invocation == firings - 1) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)
+                                                     leewayPolicy:policy
+                                                     failureBlock:NULL];
+    start = chr_now();
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [timer cancel];
+
+    qsort(lateness, firings, sizeof(uint64_t), chr_compareLateness);
+    NSLog(@"%@: p50 %.3f ms, p99 %.3f ms, max %.3f ms",
+          policy,
+          lateness[firings / 2] / (double)NSEC_PER_MSEC,
+          lateness[firings * 99 / 100] / (double)NSEC_PER_MSEC,
+          lateness[firings - 1] / (double)NSEC_PER_MSEC);
+    free(lateness);
+}
+
+@end
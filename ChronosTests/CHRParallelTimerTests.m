@@ -0,0 +1,223 @@
+//
+//  CHRParallelTimerTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRParallelTimer.h"
+#import "CHRTimerStatistics.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSUInteger CHRParallelTimerBenchmarkShards = 64;
+static NSTimeInterval CHRParallelTimerBenchmarkShardWork = 0.002;
+
+/**
+ Spins for the given duration, standing in for CPU bound shard work.
+ */
+static void chr_spin(NSTimeInterval duration) {
+    CFAbsoluteTime end = CFAbsoluteTimeGetCurrent() + duration;
+    while (CFAbsoluteTimeGetCurrent() < end) {
+        // spin
+    }
+}
+
+
+#pragma mark - CHRParallelTimerTests Interface
+
+@interface CHRParallelTimerTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRParallelTimerTests Implementation
+
+@implementation CHRParallelTimerTests
+
+- (void)testInit
+{
+    CHRParallelTimerShardBlock shardBlock = ^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSUInteger shard) {
+        // nothing to do
+    };
+    CHRParallelTimer *timer = [[CHRParallelTimer alloc]initWithInterval:1.0
+                                                             shardCount:8
+                                                             shardBlock:shardBlock];
+    XCTAssertNotNil(timer);
+    XCTAssertEqual(1.0, timer.interval);
+    XCTAssertEqual(8, timer.shardCount);
+    XCTAssertEqual(0, timer.invocations);
+    XCTAssertNotNil(timer.executionQueue);
+    XCTAssertTrue(timer.isValid);
+    XCTAssertFalse(timer.isRunning);
+}
+
+- (void)testEveryShardRunsEachInvocation
+{
+    NSUInteger shardCount = 16;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    NSMutableArray *counts = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 3; ++i) {
+        [counts addObject:@(0)];
+    }
+    NSLock *lock = [NSLock new];
+    __block BOOL unexpectedInvocation = NO;
+    
+    CHRParallelTimer *timer = [CHRParallelTimer timerWithInterval:0.05
+                                                       shardCount:shardCount
+                                                       shardBlock:^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSUInteger shard) {
+                                                           [lock lock];
+                                                           if (invocation < counts.count) {
+                                                               counts[invocation] = @([counts[invocation] unsignedIntegerValue] + 1);
+                                                           } else {
+                                                               unexpectedInvocation = YES;
+                                                           }
+                                                           [lock unlock];
+                                                       }];
+    timer.tickBlock = ^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSTimeInterval duration) {
+        if (invocation == 2) {
+            [timer cancel];
+            dispatch_semaphore_signal(semaphore);
+        }
+    };
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    
+    XCTAssertFalse(unexpectedInvocation);
+    XCTAssertEqual(3, timer.invocations);
+    for (NSNumber *count in counts) {
+        XCTAssertEqual(shardCount, count.unsignedIntegerValue);
+    }
+}
+
+- (void)testTickBlockRunsAfterAllShards
+{
+    NSUInteger shardCount = 32;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block atomic_uint completed = 0;
+    __block NSUInteger completedAtTick = 0;
+    
+    CHRParallelTimer *timer = [CHRParallelTimer timerWithInterval:1.0
+                                                       shardCount:shardCount
+                                                       shardBlock:^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSUInteger shard) {
+                                                           chr_spin(0.001);
+                                                           atomic_fetch_add(&completed, 1);
+                                                       }];
+    timer.tickBlock = ^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSTimeInterval duration) {
+        completedAtTick = atomic_load(&completed);
+        [timer pause];
+        dispatch_semaphore_signal(semaphore);
+    };
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    
+    XCTAssertEqual(shardCount, completedAtTick);
+    XCTAssertGreaterThan(timer.lastTickDuration, 0);
+    XCTAssertFalse(timer.isRunning);
+    
+    [timer cancel];
+}
+
+- (void)testStatisticsRecordTicks
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRParallelTimer *timer = [CHRParallelTimer timerWithInterval:0.05
+                                                       shardCount:4
+                                                       shardBlock:^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSUInteger shard) {
+                                                           // nothing to do
+                                                       }];
+    timer.statistics = [CHRTimerStatistics statistics];
+    timer.tickBlock = ^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSTimeInterval duration) {
+        if (invocation == 1) {
+            [timer cancel];
+            dispatch_semaphore_signal(semaphore);
+        }
+    };
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    
+    XCTAssertEqual(2, timer.statistics.fires);
+}
+
+- (void)testInvalidTimerThrows
+{
+    CHRParallelTimer *timer = [CHRParallelTimer timerWithInterval:1.0
+                                                       shardCount:1
+                                                       shardBlock:^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSUInteger shard) {
+                                                           // nothing to do
+                                                       }];
+    [timer cancel];
+    XCTAssertFalse(timer.isValid);
+    XCTAssertThrowsSpecific([timer start:NO], NSException);
+    XCTAssertThrowsSpecific([timer pause], NSException);
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkSerialVersusParallelTick
+{
+    NSTimeInterval serial = [self tickDurationWithQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    NSTimeInterval parallel = [self tickDurationWithQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+    
+    NSLog(@"%lu shards of %.1f ms on %lu cores: %.1f ms serial, %.1f ms parallel, %.1fx speedup",
+          (unsigned long)CHRParallelTimerBenchmarkShards,
+          CHRParallelTimerBenchmarkShardWork * 1000.0,
+          (unsigned long)[NSProcessInfo processInfo].activeProcessorCount,
+          serial * 1000.0,
+          parallel * 1000.0,
+          serial / parallel);
+    XCTAssertGreaterThan(serial, 0);
+    XCTAssertGreaterThan(parallel, 0);
+}
+
+#pragma mark Private
+
+/**
+ Returns the wall time of a single tick of CPU bound shards processed on the
+ given queue.
+ */
+- (NSTimeInterval)tickDurationWithQueue:(dispatch_queue_t)queue
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSTimeInterval tickDuration = 0;
+    CHRParallelTimer *timer = [CHRParallelTimer timerWithInterval:1.0
+                                                       shardCount:CHRParallelTimerBenchmarkShards
+                                                       shardBlock:^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSUInteger shard) {
+                                                           chr_spin(CHRParallelTimerBenchmarkShardWork);
+                                                       }
+                                                   executionQueue:queue];
+    timer.tickBlock = ^(CHRParallelTimer *__weak timer, NSUInteger invocation, NSTimeInterval duration) {
+        tickDuration = duration;
+        [timer cancel];
+        dispatch_semaphore_signal(semaphore);
+    };
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    return tickDuration;
+}
+
+@end
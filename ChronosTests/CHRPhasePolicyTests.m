@@ -0,0 +1,263 @@
+//
+//  CHRPhasePolicyTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRTimerInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRPhasePolicy.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSUInteger CHRPhasePolicyBenchmarkTimerCount = 10000;
+static NSTimeInterval CHRPhasePolicyBenchmarkInterval = 0.5;
+static NSTimeInterval CHRPhasePolicyBenchmarkDuration = 2.0;
+static NSTimeInterval CHRPhasePolicyBenchmarkTick = 0.01;
+static NSTimeInterval CHRPhasePolicyBenchmarkWork = 0.00001;
+
+/**
+ Raises the recorded peak to the given value if it is higher.
+ */
+static void chr_recordPeak(chr_counter_t *peak, NSUInteger value) {
+    NSUInteger observed = atomic_load_explicit(peak, memory_order_relaxed);
+    while (value > observed &&
+           !atomic_compare_exchange_weak_explicit(peak, &observed, value, memory_order_relaxed, memory_order_relaxed)) {
+        // observed was reloaded, try again
+    }
+}
+
+
+#pragma mark - CHRPhasePolicyTests Interface
+
+@interface CHRPhasePolicyTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRPhasePolicyTests Implementation
+
+@implementation CHRPhasePolicyTests
+
+- (void)testSlotCountRoundsUpToPowerOfTwo
+{
+    XCTAssertEqual(16, [CHRSpreadRegistry registryWithSlotCount:10].slotCount);
+    XCTAssertEqual(8, [CHRSpreadRegistry registryWithSlotCount:8].slotCount);
+    XCTAssertEqual(1, [CHRSpreadRegistry registryWithSlotCount:0].slotCount);
+    XCTAssertEqual(64, [CHRSpreadRegistry sharedRegistry].slotCount);
+}
+
+- (void)testSlotsSpreadApart
+{
+    CHRSpreadRegistry *registry = [CHRSpreadRegistry registryWithSlotCount:8];
+    NSMutableArray *slots = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 9; ++i) {
+        [slots addObject:@([registry acquireSlotForInterval:1.0])];
+    }
+    NSArray *expectedSlots = @[@(0), @(4), @(2), @(6), @(1), @(5), @(3), @(7), @(0)];
+    XCTAssertEqualObjects(expectedSlots, slots);
+    XCTAssertEqual(2, [registry countForSlot:0 interval:1.0]);
+    XCTAssertEqual(1, [registry countForSlot:4 interval:1.0]);
+    
+    [registry releaseSlot:6 forInterval:1.0];
+    XCTAssertEqual(0, [registry countForSlot:6 interval:1.0]);
+    XCTAssertEqual(6, [registry acquireSlotForInterval:1.0]);
+}
+
+- (void)testIntervalsAreBalancedSeparately
+{
+    CHRSpreadRegistry *registry = [CHRSpreadRegistry registryWithSlotCount:4];
+    XCTAssertEqual(0, [registry acquireSlotForInterval:1.0]);
+    XCTAssertEqual(0, [registry acquireSlotForInterval:2.0]);
+    XCTAssertEqual(2, [registry acquireSlotForInterval:1.0]);
+    
+    [registry releaseSlot:0 forInterval:2.0];
+    [registry releaseSlot:0 forInterval:2.0];
+    XCTAssertEqual(0, [registry countForSlot:0 interval:2.0]);
+    XCTAssertEqual(1, [registry countForSlot:0 interval:1.0]);
+}
+
+- (void)testHashedPolicy
+{
+    uint64_t offset = [[CHRPhasePolicy hashedPolicyWithKey:@"connection-1"] acquireOffsetForInterval:1.0];
+    XCTAssertEqual(offset, [[CHRPhasePolicy hashedPolicyWithKey:@"connection-1"] acquireOffsetForInterval:1.0]);
+    XCTAssertNotEqual(offset, [[CHRPhasePolicy hashedPolicyWithKey:@"connection-2"] acquireOffsetForInterval:1.0]);
+    XCTAssertLessThan(offset, NSEC_PER_SEC);
+    XCTAssertNil([CHRPhasePolicy hashedPolicyWithKey:@"connection-1"].registry);
+}
+
+- (void)testRandomPolicy
+{
+    CHRPhasePolicy *policy = [CHRPhasePolicy randomPolicy];
+    XCTAssertEqual(policy, [CHRPhasePolicy randomPolicy]);
+    for (NSUInteger i = 0; i < 100; ++i) {
+        XCTAssertLessThan([policy acquireOffsetForInterval:0.001], NSEC_PER_MSEC);
+    }
+    XCTAssertEqual(0, [policy acquireOffsetForInterval:0.0]);
+}
+
+- (void)testBalancedPolicy
+{
+    CHRSpreadRegistry *registry = [CHRSpreadRegistry registryWithSlotCount:4];
+    CHRPhasePolicy *policy = [CHRPhasePolicy balancedPolicyWithRegistry:registry];
+    XCTAssertEqual(registry, policy.registry);
+    XCTAssertEqual([CHRSpreadRegistry sharedRegistry], [CHRPhasePolicy balancedPolicy].registry);
+    
+    XCTAssertEqual(0, [policy acquireOffsetForInterval:1.0]);
+    XCTAssertEqual(NSEC_PER_SEC / 2, [policy acquireOffsetForInterval:1.0]);
+    XCTAssertEqual(NSEC_PER_SEC / 4, [policy acquireOffsetForInterval:1.0]);
+    XCTAssertEqual(1, [registry countForSlot:2 interval:1.0]);
+    
+    [policy releaseOffset:NSEC_PER_SEC / 2 forInterval:1.0];
+    XCTAssertEqual(0, [registry countForSlot:2 interval:1.0]);
+    XCTAssertEqual(1, [registry countForSlot:1 interval:1.0]);
+}
+
+- (void)testTimerDelaysFirstFiringByOffset
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRSpreadRegistry *registry = [CHRSpreadRegistry registryWithSlotCount:2];
+    [registry acquireSlotForInterval:1.0];
+    
+    __block CFAbsoluteTime fired = 0.0;
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:1.0
+                                                   executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                       fired = CFAbsoluteTimeGetCurrent();
+                                                       [timer pause];
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }];
+    timer.phasePolicy = [CHRPhasePolicy balancedPolicyWithRegistry:registry];
+    XCTAssertEqual(0.0, timer.phaseOffset);
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    [timer start:YES];
+    XCTAssertEqualWithAccuracy(0.5, timer.phaseOffset, 0.000001);
+    XCTAssertEqual(1, [registry countForSlot:1 interval:1.0]);
+    
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertEqualWithAccuracy(0.5, fired - start, 0.1);
+    
+    [timer cancel];
+    XCTAssertEqual(0, [registry countForSlot:1 interval:1.0]);
+    XCTAssertEqual(0.0, timer.phaseOffset);
+}
+
+- (void)testChangingPolicyReleasesOffset
+{
+    CHRSpreadRegistry *registry = [CHRSpreadRegistry registryWithSlotCount:4];
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:60.0
+                                                   executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }];
+    timer.phasePolicy = [CHRPhasePolicy balancedPolicyWithRegistry:registry];
+    [timer start:NO];
+    [timer pause];
+    XCTAssertEqual(1, [registry countForSlot:0 interval:60.0]);
+    
+    timer.phasePolicy = nil;
+    XCTAssertEqual(0, [registry countForSlot:0 interval:60.0]);
+    [timer start:NO];
+    XCTAssertEqual(0.0, timer.phaseOffset);
+    [timer cancel];
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkPeakExecutionsPerTick
+{
+    [self benchmarkPhasePolicy:nil];
+    [self benchmarkPhasePolicy:[CHRPhasePolicy randomPolicy]];
+    [self benchmarkPhasePolicy:[CHRPhasePolicy balancedPolicyWithRegistry:[CHRSpreadRegistry registryWithSlotCount:64]]];
+}
+
+#pragma mark Private
+
+/**
+ Reports the largest number of executions falling into a single tick, and the
+ largest number of executions running at once, while many timers with the same
+ interval started together fire.
+ */
+- (void)benchmarkPhasePolicy:(CHRPhasePolicy *)policy
+{
+    NSUInteger count = CHRPhasePolicyBenchmarkTimerCount;
+    NSUInteger ticks = (CHRPhasePolicyBenchmarkDuration + CHRPhasePolicyBenchmarkInterval) / CHRPhasePolicyBenchmarkTick;
+    chr_counter_t *fires = calloc(ticks, sizeof(chr_counter_t));
+    chr_counter_t executing = 0;
+    chr_counter_t peak = 0;
+    chr_counter_t *executingPointer = &executing;
+    chr_counter_t *peakPointer = &peak;
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    CHRRepeatingTimerExecutionBlock executionBlock = ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+        NSUInteger tick = (now - start) / CHRPhasePolicyBenchmarkTick;
+        if (tick < ticks) {
+            atomic_fetch_add_explicit(&fires[tick], 1, memory_order_relaxed);
+        }
+        chr_recordPeak(peakPointer, atomic_fetch_add_explicit(executingPointer, 1, memory_order_relaxed) + 1);
+        while (CFAbsoluteTimeGetCurrent() - now < CHRPhasePolicyBenchmarkWork) {
+            // simulate a short execution
+        }
+        atomic_fetch_sub_explicit(executingPointer, 1, memory_order_relaxed);
+    };
+    
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:CHRPhasePolicyBenchmarkInterval
+                                                       executionBlock:executionBlock];
+        timer.phasePolicy = policy;
+        [timers addObject:timer];
+    }
+    for (CHRDispatchTimer *timer in timers) {
+        [timer start:YES];
+    }
+    [NSThread sleepForTimeInterval:CHRPhasePolicyBenchmarkDuration];
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+    
+    NSUInteger peakPerTick = 0;
+    NSUInteger executions = 0;
+    for (NSUInteger i = 0; i < ticks; ++i) {
+        NSUInteger fired = chr_counter_load(&fires[i]);
+        peakPerTick = MAX(peakPerTick, fired);
+        executions += fired;
+    }
+    free(fires);
+    
+    NSLog(@"%@ %lu timers: %lu peak executions per %.0f ms tick, %lu peak concurrent executions, %lu executions",
+          (policy)? policy.description : @"unstaggered",
+          (unsigned long)count,
+          (unsigned long)peakPerTick,
+          CHRPhasePolicyBenchmarkTick * 1000.0,
+          (unsigned long)chr_counter_load(&peak),
+          (unsigned long)executions);
+    XCTAssertGreaterThan(executions, 0);
+}
+
+@end
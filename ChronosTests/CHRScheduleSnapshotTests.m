@@ -0,0 +1,318 @@
+//
+//  CHRScheduleSnapshotTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRScheduleSnapshot.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSUInteger CHRScheduleSnapshotBenchmarkTimerCount = 100000;
+static NSTimeInterval CHRScheduleSnapshotBenchmarkInterval = 60.0;
+
+
+#pragma mark - CHRScheduleSnapshotTests Interface
+
+@interface CHRScheduleSnapshotTests : XCTestCase
+
+@property (nonatomic) NSString *path;
+
+@end
+
+
+#pragma mark - CHRScheduleSnapshotTests Implementation
+
+@implementation CHRScheduleSnapshotTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.path error:NULL];
+    [super tearDown];
+}
+
+- (void)testDispatchTimerResumesInvocations
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.2
+                                                   executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                       if (invocation == 2) {
+                                                           [timer pause];
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }];
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [timer start:NO];
+    
+    NSError *error = nil;
+    XCTAssertTrue([CHRScheduleSnapshot writeTimers:@[timer] toFile:self.path error:&error]);
+    XCTAssertNil(error);
+    [timer cancel];
+    
+    __block NSUInteger firstInvocation = NSNotFound;
+    CHRDispatchTimer *restored = [CHRDispatchTimer timerWithInterval:0.2
+                                                      executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                          firstInvocation = invocation;
+                                                          [timer cancel];
+                                                          dispatch_semaphore_signal(semaphore);
+                                                      }];
+    CHRScheduleSnapshot *snapshot = [CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:&error];
+    XCTAssertNotNil(snapshot);
+    XCTAssertEqual(1, snapshot.count);
+    XCTAssertEqual(1, [snapshot restoreTimers:@[restored]]);
+    XCTAssertTrue(restored.isRunning);
+    XCTAssertEqual(3, restored.invocations);
+    
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertEqual(3, firstInvocation);
+}
+
+- (void)testVariableTimerResumesProviderPosition
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.05;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        if (invocation == 1) {
+            [timer pause];
+            dispatch_semaphore_signal(semaphore);
+        }
+    }];
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [timer start:NO];
+    XCTAssertTrue([CHRScheduleSnapshot writeTimers:@[timer] toFile:self.path error:NULL]);
+    [timer cancel];
+    
+    NSMutableArray *providedInvocations = [NSMutableArray array];
+    __block NSUInteger firstInvocation = NSNotFound;
+    CHRVariableTimer *restored = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        [providedInvocations addObject:@(nextInvocation)];
+        return 0.05;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        firstInvocation = invocation;
+        [timer cancel];
+        dispatch_semaphore_signal(semaphore);
+    } executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    CHRScheduleSnapshot *snapshot = [CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:NULL];
+    XCTAssertTrue([snapshot restoreTimer:restored atIndex:0]);
+    XCTAssertEqual(2, restored.invocations);
+    
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertEqual(2, firstInvocation);
+    XCTAssertEqualObjects(@[], providedInvocations);
+}
+
+- (void)testMissedDeadlineKeepsPhase
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.5
+                                                   executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    [timer start:NO];
+    XCTAssertTrue([CHRScheduleSnapshot writeTimers:@[timer] toFile:self.path error:NULL]);
+    [timer cancel];
+    
+    // The recorded deadline passes, the restored timer fires one interval after it.
+    [NSThread sleepForTimeInterval:0.7];
+    __block CFAbsoluteTime fired = 0.0;
+    CHRDispatchTimer *restored = [CHRDispatchTimer timerWithInterval:0.5
+                                                      executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                          fired = CFAbsoluteTimeGetCurrent();
+                                                          [timer cancel];
+                                                          dispatch_semaphore_signal(semaphore);
+                                                      }];
+    CHRScheduleSnapshot *snapshot = [CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:NULL];
+    XCTAssertEqual(1, [snapshot restoreTimers:@[restored]]);
+    
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertEqualWithAccuracy(1.0, fired - start, 0.1);
+    XCTAssertEqual(1, restored.invocations);
+}
+
+- (void)testPausedTimerRestoresStopped
+{
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:60.0
+                                                   executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }];
+    XCTAssertTrue([CHRScheduleSnapshot writeTimers:@[timer] toFile:self.path error:NULL]);
+    
+    CHRDispatchTimer *restored = [CHRDispatchTimer timerWithInterval:60.0
+                                                      executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                          // nothing to do
+                                                      }];
+    CHRScheduleSnapshot *snapshot = [CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:NULL];
+    XCTAssertTrue([snapshot restoreTimer:restored atIndex:0]);
+    XCTAssertFalse(restored.isRunning);
+    XCTAssertEqual(0, restored.invocations);
+    
+    [timer cancel];
+    [restored cancel];
+}
+
+- (void)testMismatchedTimersAreSkipped
+{
+    CHRRepeatingTimerExecutionBlock executionBlock = ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    };
+    CHRVariableTimerIntervalProvider intervalProvider = ^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 60.0;
+    };
+    CHRDispatchTimer *dispatchTimer = [CHRDispatchTimer timerWithInterval:60.0 executionBlock:executionBlock];
+    CHRVariableTimer *variableTimer = [CHRVariableTimer timerWithIntervalProvider:intervalProvider executionBlock:executionBlock];
+    [dispatchTimer start:NO];
+    [variableTimer start:NO];
+    XCTAssertTrue([CHRScheduleSnapshot writeTimers:@[dispatchTimer, [NSNull null], variableTimer]
+                                            toFile:self.path
+                                             error:NULL]);
+    CHRScheduleSnapshot *snapshot = [CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:NULL];
+    XCTAssertEqual(3, snapshot.count);
+    
+    // Class mismatch, empty record, running timer, missing record.
+    CHRVariableTimer *wrongClass = [CHRVariableTimer timerWithIntervalProvider:intervalProvider executionBlock:executionBlock];
+    CHRDispatchTimer *emptyRecord = [CHRDispatchTimer timerWithInterval:60.0 executionBlock:executionBlock];
+    CHRDispatchTimer *extra = [CHRDispatchTimer timerWithInterval:60.0 executionBlock:executionBlock];
+    XCTAssertEqual(0, [snapshot restoreTimers:@[wrongClass, emptyRecord, variableTimer, extra]]);
+    XCTAssertFalse(wrongClass.isRunning);
+    XCTAssertFalse(emptyRecord.isRunning);
+    XCTAssertFalse(extra.isRunning);
+    
+    [wrongClass cancel];
+    XCTAssertFalse([snapshot restoreTimer:wrongClass atIndex:2]);
+    
+    for (id<CHRRepeatingTimer> timer in @[dispatchTimer, variableTimer, emptyRecord, extra]) {
+        [timer cancel];
+    }
+}
+
+- (void)testSnapshotDate
+{
+    XCTAssertTrue([CHRScheduleSnapshot writeTimers:@[] toFile:self.path error:NULL]);
+    CHRScheduleSnapshot *snapshot = [CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:NULL];
+    XCTAssertEqual(0, snapshot.count);
+    XCTAssertEqualWithAccuracy(0.0, [snapshot.date timeIntervalSinceNow], 1.0);
+}
+
+- (void)testInvalidFiles
+{
+    NSError *error = nil;
+    XCTAssertNil([CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:&error]);
+    XCTAssertEqualObjects(NSPOSIXErrorDomain, error.domain);
+    XCTAssertEqual(ENOENT, error.code);
+    
+    error = nil;
+    [[@"not a snapshot, but long enough" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:self.path atomically:YES];
+    XCTAssertNil([CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:&error]);
+    XCTAssertEqualObjects(NSCocoaErrorDomain, error.domain);
+    XCTAssertEqual(NSFileReadCorruptFileError, error.code);
+    
+    NSString *directory = [self.path stringByAppendingPathComponent:@"missing"];
+    error = nil;
+    XCTAssertFalse([CHRScheduleSnapshot writeTimers:@[] toFile:[directory stringByAppendingPathComponent:@"snapshot"] error:&error]);
+    XCTAssertEqualObjects(NSPOSIXErrorDomain, error.domain);
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkRestore100kTimers
+{
+    [self benchmarkRestoring:NO];
+    [self benchmarkRestoring:YES];
+}
+
+#pragma mark Private
+
+- (NSMutableArray *)timersWithCount:(NSUInteger)count
+{
+    CHRRepeatingTimerExecutionBlock executionBlock = ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    };
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        [timers addObject:[CHRDispatchTimer timerWithInterval:CHRScheduleSnapshotBenchmarkInterval
+                                               executionBlock:executionBlock
+                                               executionQueue:queue]];
+    }
+    return timers;
+}
+
+/**
+ Reports the time taken to bring back a large set of timers, either by
+ starting each one or by restoring them from a snapshot, along with the time
+ taken to write the snapshot.
+ */
+- (void)benchmarkRestoring:(BOOL)restoring
+{
+    NSUInteger count = CHRScheduleSnapshotBenchmarkTimerCount;
+    NSMutableArray *timers = [self timersWithCount:count];
+    for (CHRDispatchTimer *timer in timers) {
+        [timer start:NO];
+    }
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    XCTAssertTrue([CHRScheduleSnapshot writeTimers:timers toFile:self.path error:NULL]);
+    CFAbsoluteTime written = CFAbsoluteTimeGetCurrent() - start;
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+    
+    timers = [self timersWithCount:count];
+    start = CFAbsoluteTimeGetCurrent();
+    if (restoring) {
+        CHRScheduleSnapshot *snapshot = [CHRScheduleSnapshot snapshotWithContentsOfFile:self.path error:NULL];
+        XCTAssertEqual(count, [snapshot restoreTimers:timers]);
+    } else {
+        for (CHRDispatchTimer *timer in timers) {
+            [timer start:NO];
+        }
+    }
+    CFAbsoluteTime resumed = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSLog(@"%@ %lu timers: %.3f ms to write, %.3f ms to resume",
+          (restoring)? @"restore" : @"start",
+          (unsigned long)count,
+          written * 1000.0,
+          resumed * 1000.0);
+    for (CHRDispatchTimer *timer in timers) {
+        XCTAssertTrue(timer.isRunning);
+        [timer cancel];
+    }
+}
+
+@end
@@ -28,6 +28,13 @@
 #define Chronos_CHRTestInternal
 
 
+#pragma mark - Imports
+
+#import <mach/mach.h>
+#import <sys/resource.h>
+#import <stdatomic.h>
+
+
 #pragma mark - Constants and Functions
 
 static NSTimeInterval CHRDefaultAsyncTestTimeout = 10.0;
@@ -35,4 +42,26 @@ static inline dispatch_time_t chr_timeout(NSTimeInterval seconds) {
     return dispatch_time(DISPATCH_TIME_NOW, (int64_t) seconds * NSEC_PER_SEC);
 }
 
+/**
+ Returns the resident memory size of the test process, in bytes.
+ */
+static inline uint64_t chr_residentSize(void) {
+    struct mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+}
+
+/**
+ Returns the user and system CPU time consumed by the test process, in seconds.
+ */
+static inline NSTimeInterval chr_cpuTime(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / (NSTimeInterval)USEC_PER_SEC;
+}
+
 #endif
@@ -0,0 +1,149 @@
+//
+//  CHRThrottlerTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRThrottler.h"
+
+
+#pragma mark - Constants and Functions
+
+static size_t CHRThrottlerBenchmarkSignals = 10000000;
+
+
+#pragma mark - CHRThrottlerTests Interface
+
+@interface CHRThrottlerTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRThrottlerTests Implementation
+
+@implementation CHRThrottlerTests
+
+- (void)testLeadingAndTrailingEdges
+{
+    __block atomic_int executions = 0;
+    CHRThrottler *throttler = [CHRThrottler throttlerWithInterval:0.2 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    dispatch_apply(1000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        [throttler signal];
+    });
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(1, atomic_load(&executions));
+    
+    [NSThread sleepForTimeInterval:0.6];
+    XCTAssertEqual(2, atomic_load(&executions));
+    
+    [throttler cancel];
+    XCTAssertFalse(throttler.isValid);
+}
+
+- (void)testLeadingEdgeOnly
+{
+    __block atomic_int executions = 0;
+    CHRThrottler *throttler = [CHRThrottler throttlerWithInterval:0.2 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    throttler.trailing = NO;
+    
+    [throttler signal];
+    [throttler signal];
+    [throttler signal];
+    [NSThread sleepForTimeInterval:0.5];
+    
+    XCTAssertEqual(1, atomic_load(&executions));
+    
+    [throttler cancel];
+}
+
+- (void)testRateIsLimited
+{
+    __block atomic_int executions = 0;
+    CHRThrottler *throttler = [CHRThrottler throttlerWithInterval:0.1 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    NSDate *end = [NSDate dateWithTimeIntervalSinceNow:1.0];
+    while ([end timeIntervalSinceNow] > 0) {
+        [throttler signal];
+        [NSThread sleepForTimeInterval:0.001];
+    }
+    [throttler cancel];
+    
+    XCTAssertGreaterThanOrEqual(atomic_load(&executions), 5);
+    XCTAssertLessThanOrEqual(atomic_load(&executions), 12);
+}
+
+- (void)testSignalAfterCancelIsIgnored
+{
+    __block atomic_int executions = 0;
+    CHRThrottler *throttler = [CHRThrottler throttlerWithInterval:0.1 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    [throttler cancel];
+    [throttler signal];
+    [throttler signal];
+    [NSThread sleepForTimeInterval:0.3];
+    
+    XCTAssertEqual(0, atomic_load(&executions));
+}
+
+#pragma mark Benchmarks
+
+/**
+ Reports the sustained signal rate of a throttler under a burst of millions of
+ concurrent signals.
+ */
+- (void)testBenchmarkSignalThroughput
+{
+    __block atomic_int executions = 0;
+    CHRThrottler *throttler = [CHRThrottler throttlerWithInterval:0.05 executionBlock:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    dispatch_apply(CHRThrottlerBenchmarkSignals, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        [throttler signal];
+    });
+    NSTimeInterval elapsed = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSLog(@"throttler: %.0f signals per second, %d executions in %.3f s",
+          CHRThrottlerBenchmarkSignals / elapsed,
+          atomic_load(&executions),
+          elapsed);
+    XCTAssertGreaterThan(atomic_load(&executions), 0);
+    
+    [throttler cancel];
+}
+
+@end
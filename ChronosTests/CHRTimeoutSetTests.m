@@ -0,0 +1,206 @@
+//
+//  CHRTimeoutSetTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRTimeoutSet.h"
+
+
+#pragma mark - Constants and Functions
+
+static size_t CHRTimeoutSetBenchmarkPairs = 5000000;
+static size_t CHRTimeoutSetBenchmarkTimers = 10000;
+
+static void chr_countTimeout(void *context) {
+    atomic_fetch_add((atomic_int *)context, 1);
+}
+
+
+#pragma mark - CHRTimeoutSetTests Interface
+
+@interface CHRTimeoutSetTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimeoutSetTests Implementation
+
+@implementation CHRTimeoutSetTests
+
+- (void)testTimeoutFiresOnce
+{
+    __block atomic_int executions = 0;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRTimeoutSet *set = [CHRTimeoutSet timeoutSetWithResolution:0.01];
+    CHRTimeoutToken token = [set addTimeout:0.1 handler:^{
+        atomic_fetch_add(&executions, 1);
+        dispatch_semaphore_signal(semaphore);
+    }];
+    
+    XCTAssertNotEqual(CHRTimeoutTokenNone, token);
+    XCTAssertEqual(1, set.count);
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [NSThread sleepForTimeInterval:0.1];
+    
+    XCTAssertEqual(1, atomic_load(&executions));
+    XCTAssertEqual(0, set.count);
+    XCTAssertFalse([set cancelTimeout:token]);
+}
+
+- (void)testCanceledTimeoutDoesNotFire
+{
+    __block atomic_int executions = 0;
+    CHRTimeoutSet *set = [CHRTimeoutSet timeoutSetWithResolution:0.01];
+    CHRTimeoutToken token = [set addTimeout:0.05 handler:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    XCTAssertTrue([set cancelTimeout:token]);
+    XCTAssertFalse([set cancelTimeout:token]);
+    XCTAssertEqual(0, set.count);
+    [NSThread sleepForTimeInterval:0.2];
+    
+    XCTAssertEqual(0, atomic_load(&executions));
+}
+
+- (void)testStaleTokenDoesNotCancelReusedEntry
+{
+    atomic_int executions = 0;
+    CHRTimeoutSet *set = [CHRTimeoutSet timeoutSetWithResolution:0.01];
+    CHRTimeoutToken stale = [set addTimeout:0.01 function:chr_countTimeout context:&executions];
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(1, atomic_load(&executions));
+    
+    CHRTimeoutToken token = [set addTimeout:0.05 function:chr_countTimeout context:&executions];
+    XCTAssertNotEqual(stale, token);
+    XCTAssertFalse([set cancelTimeout:stale]);
+    XCTAssertFalse([set cancelTimeout:CHRTimeoutTokenNone]);
+    [NSThread sleepForTimeInterval:0.2];
+    
+    XCTAssertEqual(2, atomic_load(&executions));
+}
+
+- (void)testTimeoutsExpireInOrder
+{
+    NSMutableArray *order = [NSMutableArray array];
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRTimeoutSet *set = [CHRTimeoutSet timeoutSetWithResolution:0.01
+                                                  executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    for (NSUInteger i = 3; i > 0; --i) {
+        [set addTimeout:0.1 * i handler:^{
+            [order addObject:@(i)];
+            if (order.count == 3) {
+                dispatch_semaphore_signal(semaphore);
+            }
+        }];
+    }
+    
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    NSArray *expectedOrder = @[@(1), @(2), @(3)];
+    XCTAssertEqualObjects(expectedOrder, order);
+}
+
+- (void)testLongTimeoutDoesNotFireEarly
+{
+    __block atomic_int executions = 0;
+    CHRTimeoutSet *set = [CHRTimeoutSet timeoutSetWithResolution:0.0001];
+    CHRTimeoutToken token = [set addTimeout:5.0 handler:^{
+        atomic_fetch_add(&executions, 1);
+    }];
+    
+    // Wraps the wheel at least once.
+    [NSThread sleepForTimeInterval:0.5];
+    
+    XCTAssertEqual(0, atomic_load(&executions));
+    XCTAssertEqual(1, set.count);
+    XCTAssertTrue([set cancelTimeout:token]);
+}
+
+#pragma mark Benchmarks
+
+/**
+ Reports the rate of add and cancel pairs on a single thread, for function and
+ block timeouts, next to creating, starting and canceling a dispatch timer per
+ timeout.
+ */
+- (void)testBenchmarkAddCancelPairs
+{
+    atomic_int executions = 0;
+    CHRTimeoutSet *set = [CHRTimeoutSet timeoutSetWithResolution:0.01];
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (size_t i = 0; i < CHRTimeoutSetBenchmarkPairs; ++i) {
+        CHRTimeoutToken token = [set addTimeout:30.0 function:chr_countTimeout context:&executions];
+        [set cancelTimeout:token];
+    }
+    NSTimeInterval functions = CFAbsoluteTimeGetCurrent() - start;
+    
+    start = CFAbsoluteTimeGetCurrent();
+    for (size_t i = 0; i < CHRTimeoutSetBenchmarkPairs; ++i) {
+        CHRTimeoutToken token = [set addTimeout:30.0 handler:^{
+            atomic_fetch_add(&executions, 1);
+        }];
+        [set cancelTimeout:token];
+    }
+    NSTimeInterval blocks = CFAbsoluteTimeGetCurrent() - start;
+    
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    start = CFAbsoluteTimeGetCurrent();
+    for (size_t i = 0; i < CHRTimeoutSetBenchmarkTimers; ++i) {
+        CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:30.0
+                                                       executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                           // nothing to do
+                                                       }
+                                                       executionQueue:queue];
+        [timer start:NO];
+        [timer cancel];
+    }
+    NSTimeInterval timers = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSLog(@"timeout set: %.0f function pairs per second, %.0f block pairs per second; dispatch timers: %.0f pairs per second",
+          CHRTimeoutSetBenchmarkPairs / functions,
+          CHRTimeoutSetBenchmarkPairs / blocks,
+          CHRTimeoutSetBenchmarkTimers / timers);
+    XCTAssertEqual(0, set.count);
+    XCTAssertEqual(0, atomic_load(&executions));
+}
+
+- (void)testPerformanceAddCancel
+{
+    atomic_int executions = 0;
+    CHRTimeoutSet *set = [CHRTimeoutSet timeoutSetWithResolution:0.01];
+    [self measureBlock:^{
+        for (size_t i = 0; i < 1000000; ++i) {
+            CHRTimeoutToken token = [set addTimeout:30.0 function:chr_countTimeout context:(void *)&executions];
+            [set cancelTimeout:token];
+        }
+    }];
+}
+
+@end
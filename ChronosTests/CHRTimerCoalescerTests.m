@@ -0,0 +1,187 @@
+//
+//  CHRTimerCoalescerTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRTimerCoalescer.h"
+
+
+#pragma mark - CHRTimerCoalescerTests Interface
+
+@interface CHRTimerCoalescerTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimerCoalescerTests Implementation
+
+@implementation CHRTimerCoalescerTests
+
+- (void)testTimerFireOnce
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRTimerCoalescer *coalescer = [CHRTimerCoalescer coalescer];
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.5
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       XCTAssertEqual(0, invocation);
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)
+                                                        scheduler:coalescer];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    
+    [timer cancel];
+    
+    XCTAssertEqual(0, coalescer.count);
+    XCTAssertEqual(1, coalescer.firings);
+}
+
+- (void)testOverlappingWindowsShareWakeups
+{
+    NSUInteger timerCount = 10;
+    dispatch_group_t group = dispatch_group_create();
+    CHRTimerCoalescer *coalescer = [CHRTimerCoalescer coalescer];
+    NSMutableArray *timers = [NSMutableArray array];
+    for (NSUInteger i = 0; i < timerCount; ++i) {
+        dispatch_group_enter(group);
+        CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.5
+                                                       executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                           [timer pause];
+                                                           dispatch_group_leave(group);
+                                                       }
+                                                       executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)
+                                                            scheduler:coalescer];
+        [timers addObject:timer];
+    }
+    for (CHRDispatchTimer *timer in timers) {
+        [timer start:NO];
+    }
+    XCTAssertEqual(timerCount, coalescer.count);
+    XCTAssertEqual(0, dispatch_group_wait(group, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    
+    XCTAssertEqual(timerCount, coalescer.firings);
+    XCTAssertLessThan(coalescer.wakeups, timerCount);
+    XCTAssertEqual(coalescer.firings - coalescer.wakeups, coalescer.savedWakeups);
+    
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+}
+
+- (void)testStaggeredDeadlinesShareWakeup
+{
+    NSUInteger timerCount = 3;
+    dispatch_group_t group = dispatch_group_create();
+    CHRTimerCoalescer *coalescer = [CHRTimerCoalescer coalescer];
+    NSMutableArray *timers = [NSMutableArray array];
+    for (NSUInteger i = 0; i < timerCount; ++i) {
+        dispatch_group_enter(group);
+        // The default leeway of a 2 s interval is 100 ms.
+        CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:2.0
+                                                       executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                           [timer pause];
+                                                           dispatch_group_leave(group);
+                                                       }
+                                                       executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)
+                                                            scheduler:coalescer];
+        [timers addObject:timer];
+    }
+    // Deadlines 30 ms apart, each inside the window of the first timer.
+    for (CHRDispatchTimer *timer in timers) {
+        [timer start:NO];
+        [NSThread sleepForTimeInterval:0.03];
+    }
+    XCTAssertEqual(0, dispatch_group_wait(group, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    
+    XCTAssertEqual(timerCount, coalescer.firings);
+    XCTAssertEqual(1, coalescer.wakeups);
+    
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+}
+
+- (void)testPauseRemovesTimer
+{
+    CHRTimerCoalescer *coalescer = [CHRTimerCoalescer coalescer];
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:60.0
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)
+                                                        scheduler:coalescer];
+    [timer start:NO];
+    XCTAssertEqual(1, coalescer.count);
+    
+    [timer pause];
+    XCTAssertEqual(0, coalescer.count);
+    
+    [timer cancel];
+    XCTAssertEqual(0, coalescer.firings);
+}
+
+#pragma mark Benchmarks
+
+/**
+ Simulates a fleet of metrics flushers with one second intervals and random
+ phases, and reports how many wakeups coalescing saved.
+ */
+- (void)testBenchmarkMetricsFlushers
+{
+    NSUInteger timerCount = 1000;
+    NSTimeInterval duration = 3.0;
+    CHRTimerCoalescer *coalescer = [CHRTimerCoalescer coalescer];
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:timerCount];
+    for (NSUInteger i = 0; i < timerCount; ++i) {
+        CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:1.0
+                                                       executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                           // nothing to do
+                                                       }
+                                                       executionQueue:queue
+                                                            scheduler:coalescer];
+        [timers addObject:timer];
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, arc4random_uniform(NSEC_PER_SEC)), queue, ^{
+            [timer start:NO];
+        });
+    }
+    [NSThread sleepForTimeInterval:duration];
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+    
+    NSLog(@"coalescer, %lu timers over %.0f s: %llu firings, %llu wakeups, %llu wakeups saved (%.1fx fewer)",
+          (unsigned long)timerCount, duration,
+          coalescer.firings, coalescer.wakeups, coalescer.savedWakeups,
+          (double)coalescer.firings / MAX(coalescer.wakeups, 1));
+    XCTAssertLessThan(coalescer.wakeups, coalescer.firings);
+}
+
+@end
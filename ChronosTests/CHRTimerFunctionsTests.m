@@ -0,0 +1,183 @@
+//
+//  CHRTimerFunctionsTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRTimerFunctions.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSTimeInterval CHRTimerFunctionsBenchmarkDuration = 0.5;
+
+typedef struct chr_test_context_s {
+    dispatch_semaphore_t    semaphore;
+    NSUInteger              signalInvocation;
+    NSUInteger              lastInvocation;
+    bool                    finalized;
+} chr_test_context_t;
+
+static void chr_testFire(void *context, NSUInteger invocation, NSUInteger periods) {
+    chr_test_context_t *test = context;
+    test->lastInvocation = invocation + periods - 1;
+    if (invocation <= test->signalInvocation && test->signalInvocation < invocation + periods) {
+        dispatch_semaphore_signal(test->semaphore);
+    }
+}
+
+static void chr_testFinalize(void *context) {
+    chr_test_context_t *test = context;
+    test->finalized = true;
+    dispatch_semaphore_signal(test->semaphore);
+}
+
+static void chr_benchmarkFire(void *context, NSUInteger invocation, NSUInteger periods) {
+    ++*(NSUInteger *)context;
+}
+
+
+#pragma mark - CHRTimerFunctionsTests Interface
+
+@interface CHRTimerFunctionsTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimerFunctionsTests Implementation
+
+@implementation CHRTimerFunctionsTests
+
+- (void)testTimerFires
+{
+    chr_test_context_t context = { dispatch_semaphore_create(0), 3, 0, false };
+    chr_timer_t timer = chr_timer_create(0.01, dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL), &context, chr_testFire);
+    XCTAssertTrue(timer != NULL);
+    XCTAssertFalse(chr_timer_is_running(timer));
+
+    chr_timer_start(timer, YES);
+    XCTAssertTrue(chr_timer_is_running(timer));
+    XCTAssertEqual(0, dispatch_semaphore_wait(context.semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertGreaterThanOrEqual(chr_timer_invocations(timer), 4);
+
+    chr_timer_set_finalizer_f(timer, chr_testFinalize);
+    chr_timer_cancel(timer);
+    XCTAssertEqual(0, dispatch_semaphore_wait(context.semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertTrue(context.finalized);
+}
+
+- (void)testPauseAndResume
+{
+    chr_test_context_t context = { dispatch_semaphore_create(0), 1, 0, false };
+    chr_timer_t timer = chr_timer_create(0.01, dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL), &context, chr_testFire);
+    chr_timer_set_finalizer_f(timer, chr_testFinalize);
+
+    chr_timer_pause(timer);
+    chr_timer_start(timer, NO);
+    chr_timer_start(timer, NO);
+    chr_timer_pause(timer);
+    XCTAssertFalse(chr_timer_is_running(timer));
+    chr_timer_start(timer, NO);
+    XCTAssertEqual(0, dispatch_semaphore_wait(context.semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+
+    chr_timer_cancel(timer);
+    XCTAssertEqual(0, dispatch_semaphore_wait(context.semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertTrue(context.finalized);
+}
+
+- (void)testCancelWhilePaused
+{
+    chr_test_context_t context = { dispatch_semaphore_create(0), 0, 0, false };
+    chr_timer_t timer = chr_timer_create(60.0, dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL), &context, chr_testFire);
+    chr_timer_set_finalizer_f(timer, chr_testFinalize);
+    chr_timer_cancel(timer);
+    XCTAssertEqual(0, dispatch_semaphore_wait(context.semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertTrue(context.finalized);
+}
+
+- (void)testResetWhilePaused
+{
+    chr_test_context_t context = { dispatch_semaphore_create(0), 2, 0, false };
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    chr_timer_t timer = chr_timer_create(0.01, queue, &context, chr_testFire);
+    chr_timer_start(timer, YES);
+    XCTAssertEqual(0, dispatch_semaphore_wait(context.semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertFalse(chr_timer_reset(timer, 0.02, 0));
+    
+    chr_timer_pause(timer);
+    dispatch_sync(queue, ^{});
+    XCTAssertTrue(chr_timer_reset(timer, 0.02, 0));
+    XCTAssertEqual(0, chr_timer_invocations(timer));
+    
+    chr_timer_start(timer, YES);
+    XCTAssertEqual(0, dispatch_semaphore_wait(context.semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    chr_timer_cancel(timer);
+}
+
+#pragma mark Benchmarks
+
+/**
+ Fires a timer as often as the system allows and reports the CPU time spent per
+ firing, for the block based CHRDispatchTimer and for a chr_timer_t.
+ */
+- (void)testBenchmarkPerFireOverhead
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+
+    __block NSUInteger blockInvocations = 0;
+    CHRDispatchTimer *blockTimer = [CHRDispatchTimer timerWithInterval:1e-9
+                                                        executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                            ++blockInvocations;
+                                                        }
+                                                        executionQueue:queue];
+    NSTimeInterval cpuBefore = chr_cpuTime();
+    [blockTimer start:YES];
+    [NSThread sleepForTimeInterval:CHRTimerFunctionsBenchmarkDuration];
+    [blockTimer pause];
+    dispatch_sync(queue, ^{});
+    NSTimeInterval blockCPU = chr_cpuTime() - cpuBefore;
+    [blockTimer cancel];
+
+    NSUInteger functionInvocations = 0;
+    chr_timer_t functionTimer = chr_timer_create(1e-9, queue, &functionInvocations, chr_benchmarkFire);
+    cpuBefore = chr_cpuTime();
+    chr_timer_start(functionTimer, YES);
+    [NSThread sleepForTimeInterval:CHRTimerFunctionsBenchmarkDuration];
+    chr_timer_pause(functionTimer);
+    dispatch_sync(queue, ^{});
+    NSTimeInterval functionCPU = chr_cpuTime() - cpuBefore;
+    chr_timer_cancel(functionTimer);
+
+    NSLog(@"block: %lu fires, %.1f ns CPU per fire; function: %lu fires, %.1f ns CPU per fire",
+          (unsigned long)blockInvocations, blockCPU * NSEC_PER_SEC / MAX(blockInvocations, 1),
+          (unsigned long)functionInvocations, functionCPU * NSEC_PER_SEC / MAX(functionInvocations, 1));
+    XCTAssertGreaterThan(blockInvocations, 0);
+    XCTAssertGreaterThan(functionInvocations, 0);
+}
+
+@end
@@ -0,0 +1,221 @@
+//
+//  CHRTimerGroupTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRTimerGroup.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSUInteger CHRTimerGroupBenchmarkTimerCount = 100000;
+static NSTimeInterval CHRTimerGroupBenchmarkInterval = 1.0;
+
+
+#pragma mark - CHRTimerGroupTests Interface
+
+@interface CHRTimerGroupTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimerGroupTests Implementation
+
+@implementation CHRTimerGroupTests
+
+- (void)testStartAllPauseAll
+{
+    __block _Atomic(int64_t) executions = 0;
+    CHRTimerGroup *group = [CHRTimerGroup group];
+    for (NSUInteger i = 0; i < 10; ++i) {
+        [group timerWithInterval:0.01 executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+            atomic_fetch_add(&executions, 1);
+        }];
+    }
+    XCTAssertEqual(10, group.count);
+    for (CHRDispatchTimer *timer in group.timers) {
+        XCTAssertFalse(timer.isRunning);
+    }
+
+    [group startAll:YES];
+    [NSThread sleepForTimeInterval:0.2];
+    XCTAssertGreaterThan(atomic_load(&executions), 10);
+
+    [group pauseAll];
+    [group drain];
+    XCTAssertTrue(group.isPaused);
+    XCTAssertEqual(0, group.executing);
+    NSMutableArray *invocations = [NSMutableArray array];
+    for (CHRDispatchTimer *timer in group.timers) {
+        XCTAssertFalse(timer.isRunning);
+        // A handler may have been queued before its source was suspended.
+        dispatch_sync(timer.executionQueue, ^{});
+        [invocations addObject:@(timer.invocations)];
+    }
+    int64_t paused = atomic_load(&executions);
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(paused, atomic_load(&executions));
+    XCTAssertEqualObjects(invocations, [group.timers valueForKey:@"invocations"]);
+
+    [group startAll:NO];
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertGreaterThan(atomic_load(&executions), paused);
+
+    [group cancelAll];
+}
+
+- (void)testDrainWaitsForExecution
+{
+    dispatch_semaphore_t started = dispatch_semaphore_create(0);
+    __block _Atomic(bool) finished = false;
+    CHRTimerGroup *group = [CHRTimerGroup group];
+    [group timerWithInterval:10.0 executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        dispatch_semaphore_signal(started);
+        [NSThread sleepForTimeInterval:0.2];
+        atomic_store(&finished, true);
+    }];
+    [group startAll:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(started, chr_timeout(CHRDefaultAsyncTestTimeout)));
+
+    [group pauseAll];
+    XCTAssertEqual(1, group.executing);
+    [group drain];
+    XCTAssertTrue(atomic_load(&finished));
+
+    [group cancelAll];
+}
+
+- (void)testCancelAll
+{
+    CHRTimerGroup *group = [CHRTimerGroup group];
+    CHRDispatchTimer *dispatchTimer = [group timerWithInterval:0.01
+                                                executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                    // nothing to do
+                                                }];
+    CHRVariableTimer *variableTimer = [group timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.01;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    }];
+    [group startAll:NO];
+    XCTAssertTrue(dispatchTimer.isRunning);
+    XCTAssertTrue(variableTimer.isRunning);
+
+    [group cancelAll];
+
+    XCTAssertEqual(0, group.count);
+    XCTAssertFalse(dispatchTimer.isValid);
+    XCTAssertFalse(variableTimer.isValid);
+}
+
+- (void)testStartAllSkipsCanceledTimers
+{
+    CHRTimerGroup *group = [CHRTimerGroup group];
+    CHRDispatchTimer *timer = [group timerWithInterval:0.01
+                                        executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                            // nothing to do
+                                        }];
+    [timer cancel];
+
+    XCTAssertNoThrow([group startAll:NO]);
+
+    [group cancelAll];
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkQuiesce100kTimers
+{
+    [self benchmarkQuiesceGrouped:NO];
+    [self benchmarkQuiesceGrouped:YES];
+}
+
+#pragma mark Private
+
+/**
+ Reports the time from deciding to quiesce 100k running timers until no
+ execution block can run anymore, and the time to cancel them, for a loop over
+ the timers and for a group.
+ */
+- (void)benchmarkQuiesceGrouped:(BOOL)grouped
+{
+    CHRRepeatingTimerExecutionBlock executionBlock = ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    };
+    CHRTimerGroup *group = [CHRTimerGroup group];
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:CHRTimerGroupBenchmarkTimerCount];
+    for (NSUInteger i = 0; i < CHRTimerGroupBenchmarkTimerCount; ++i) {
+        if (grouped) {
+            [group timerWithInterval:CHRTimerGroupBenchmarkInterval executionBlock:executionBlock];
+        } else {
+            CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:CHRTimerGroupBenchmarkInterval
+                                                           executionBlock:executionBlock];
+            [timer start:NO];
+            [timers addObject:timer];
+        }
+    }
+    if (grouped) {
+        [group startAll:NO];
+    }
+
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    if (grouped) {
+        [group pauseAll];
+        [group drain];
+    } else {
+        NSMutableSet *queues = [NSMutableSet set];
+        for (CHRDispatchTimer *timer in timers) {
+            [timer pause];
+            [queues addObject:timer.executionQueue];
+        }
+        // A handler may have been queued before its source was suspended.
+        for (dispatch_queue_t queue in queues) {
+            dispatch_sync(queue, ^{});
+        }
+    }
+    CFAbsoluteTime quiesced = CFAbsoluteTimeGetCurrent() - start;
+
+    start = CFAbsoluteTimeGetCurrent();
+    if (grouped) {
+        [group cancelAll];
+    } else {
+        for (CHRDispatchTimer *timer in timers) {
+            [timer cancel];
+        }
+    }
+    CFAbsoluteTime canceled = CFAbsoluteTimeGetCurrent() - start;
+
+    NSLog(@"%@ %lu timers: %.3f ms to quiesce, %.3f ms to cancel",
+          (grouped)? @"group" : @"loop",
+          (unsigned long)CHRTimerGroupBenchmarkTimerCount,
+          quiesced * 1000.0,
+          canceled * 1000.0);
+    XCTAssertEqual(0, group.count);
+}
+
+@end
@@ -0,0 +1,226 @@
+//
+//  CHRTimerPoolTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRTimerPool.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSUInteger CHRTimerPoolBenchmarkRounds = 100;
+static NSUInteger CHRTimerPoolBenchmarkBatch = 100;
+
+
+#pragma mark - CHRTimerPoolTests Interface
+
+@interface CHRTimerPoolTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimerPoolTests Implementation
+
+@implementation CHRTimerPoolTests
+
+- (void)testRecycledTimerIsReused
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    CHRTimerPool *pool = [CHRTimerPool poolWithCapacity:4 executionQueue:queue];
+    CHRDispatchTimer *first = [pool timerWithInterval:0.05 executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    }];
+    XCTAssertEqual(0, pool.hits);
+    XCTAssertEqual(1, pool.misses);
+    
+    [pool recycleTimer:first];
+    dispatch_sync(queue, ^{});
+    XCTAssertEqual(1, pool.count);
+    
+    CHRDispatchTimer *second = [pool timerWithInterval:0.05 executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    }];
+    XCTAssertEqual(first, second);
+    XCTAssertEqual(1, pool.hits);
+    XCTAssertEqual(0, pool.count);
+    XCTAssertTrue(second.isValid);
+    XCTAssertFalse(second.isRunning);
+    
+    [second cancel];
+}
+
+- (void)testRecycledTimerIsReset
+{
+    __block atomic_int staleExecutions = 0;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    CHRTimerPool *pool = [CHRTimerPool poolWithCapacity:4 executionQueue:queue];
+    
+    CHRDispatchTimer *timer = [pool timerWithInterval:0.01 executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        atomic_fetch_add(&staleExecutions, 1);
+        if (invocation == 2) {
+            dispatch_semaphore_signal(semaphore);
+        }
+    }];
+    timer.catchUpPolicy = CHRCatchUpPolicyCoalesce;
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [pool recycleTimer:timer];
+    dispatch_sync(queue, ^{});
+    int stale = atomic_load(&staleExecutions);
+    
+    timer = [pool timerWithInterval:0.02 executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        if (invocation == 1) {
+            dispatch_semaphore_signal(semaphore);
+        }
+    }];
+    XCTAssertEqual(1, pool.hits);
+    XCTAssertEqual(0, timer.invocations);
+    XCTAssertEqual(0.02, timer.interval);
+    XCTAssertEqual(CHRCatchUpPolicySkip, timer.catchUpPolicy);
+    
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertEqual(stale, atomic_load(&staleExecutions));
+    
+    [timer cancel];
+}
+
+- (void)testCapacityIsBounded
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    CHRTimerPool *pool = [CHRTimerPool poolWithCapacity:2 executionQueue:queue];
+    NSMutableArray *timers = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 3; ++i) {
+        [timers addObject:[pool timerWithInterval:1.0 executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+            // nothing to do
+        }]];
+    }
+    for (CHRDispatchTimer *timer in timers) {
+        [pool recycleTimer:timer];
+    }
+    dispatch_sync(queue, ^{});
+    
+    XCTAssertEqual(2, pool.count);
+    XCTAssertFalse([timers[2] isValid]);
+    
+    [pool drain];
+    XCTAssertEqual(0, pool.count);
+    XCTAssertFalse([timers[0] isValid]);
+}
+
+- (void)testForeignTimerIsCanceled
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    CHRTimerPool *pool = [CHRTimerPool poolWithCapacity:2 executionQueue:queue];
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:1.0
+                                                   executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+                                                       // nothing to do
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    [pool recycleTimer:timer];
+    dispatch_sync(queue, ^{});
+    
+    XCTAssertFalse(timer.isValid);
+    XCTAssertEqual(0, pool.count);
+}
+
+#pragma mark Benchmarks
+
+/**
+ Reports the rate of timers taken, started and given back through a pool, next
+ to creating, starting and canceling plain timers at the same rate.
+ */
+- (void)testBenchmarkChurn
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    CHRTimerPool *pool = [CHRTimerPool poolWithCapacity:CHRTimerPoolBenchmarkBatch executionQueue:queue];
+    NSUInteger count = CHRTimerPoolBenchmarkRounds * CHRTimerPoolBenchmarkBatch;
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    [self churnWithQueue:queue pool:pool];
+    NSTimeInterval pooled = CFAbsoluteTimeGetCurrent() - start;
+    
+    start = CFAbsoluteTimeGetCurrent();
+    [self churnWithQueue:queue pool:nil];
+    NSTimeInterval plain = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSLog(@"pool: %.0f timers per second (%lu hits, %lu misses); plain: %.0f timers per second",
+          count / pooled,
+          (unsigned long)pool.hits,
+          (unsigned long)pool.misses,
+          count / plain);
+    XCTAssertGreaterThan(pool.hits, 0);
+}
+
+- (void)testPerformancePooledChurn
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    CHRTimerPool *pool = [CHRTimerPool poolWithCapacity:CHRTimerPoolBenchmarkBatch executionQueue:queue];
+    [self measureBlock:^{
+        [self churnWithQueue:queue pool:pool];
+    }];
+}
+
+- (void)testPerformancePlainChurn
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    [self measureBlock:^{
+        [self churnWithQueue:queue pool:nil];
+    }];
+}
+
+#pragma mark Private
+
+- (void)churnWithQueue:(dispatch_queue_t)queue pool:(CHRTimerPool *)pool
+{
+    CHRRepeatingTimerExecutionBlock executionBlock = ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    };
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:CHRTimerPoolBenchmarkBatch];
+    for (NSUInteger round = 0; round < CHRTimerPoolBenchmarkRounds; ++round) {
+        for (NSUInteger i = 0; i < CHRTimerPoolBenchmarkBatch; ++i) {
+            CHRDispatchTimer *timer = (pool)?
+                [pool timerWithInterval:1.0 executionBlock:executionBlock] :
+                [CHRDispatchTimer timerWithInterval:1.0 executionBlock:executionBlock executionQueue:queue];
+            [timer start:NO];
+            [timers addObject:timer];
+        }
+        for (CHRDispatchTimer *timer in timers) {
+            if (pool) {
+                [pool recycleTimer:timer];
+            } else {
+                [timer cancel];
+            }
+        }
+        [timers removeAllObjects];
+        dispatch_sync(queue, ^{});
+    }
+}
+
+@end
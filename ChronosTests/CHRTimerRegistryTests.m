@@ -0,0 +1,193 @@
+//
+//  CHRTimerRegistryTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+#import "CHRTimerRegistry.h"
+
+
+#pragma mark - CHRTimerRegistryTests Interface
+
+@interface CHRTimerRegistryTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimerRegistryTests Implementation
+
+@implementation CHRTimerRegistryTests
+
+- (void)tearDown
+{
+    [CHRTimerRegistry setEnabled:NO];
+    [super tearDown];
+}
+
+- (void)testDisabledDoesNotRegister
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    CHRDispatchTimer *timer = [self idleTimerWithQueue:queue];
+    
+    XCTAssertEqual(0, [self snapshotsForQueue:queue].count);
+    XCTAssertNotNil(timer);
+}
+
+- (void)testSnapshotReflectsTimerState
+{
+    [CHRTimerRegistry setEnabled:YES];
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    CHRDispatchTimer *timer = [self idleTimerWithQueue:queue];
+    
+    CHRTimerSnapshot *snapshot = [self snapshotsForQueue:queue].firstObject;
+    XCTAssertEqual([CHRDispatchTimer class], snapshot.timerClass);
+    XCTAssertEqualWithAccuracy(60.0, snapshot.interval, 0.001);
+    XCTAssertFalse(snapshot.isRunning);
+    XCTAssertTrue(snapshot.isValid);
+    
+    [timer start:NO];
+    snapshot = [self snapshotsForQueue:queue].firstObject;
+    XCTAssertTrue(snapshot.isRunning);
+    
+    [timer cancel];
+    snapshot = [self snapshotsForQueue:queue].firstObject;
+    XCTAssertFalse(snapshot.isValid);
+}
+
+- (void)testDeallocatedTimersUnregister
+{
+    [CHRTimerRegistry setEnabled:YES];
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    @autoreleasepool {
+        CHRDispatchTimer *timer = [self idleTimerWithQueue:queue];
+        XCTAssertEqual(1, [self snapshotsForQueue:queue].count);
+        [timer cancel];
+    }
+    XCTAssertEqual(0, [self snapshotsForQueue:queue].count);
+}
+
+- (void)testQueueLoadAggregatesTimers
+{
+    [CHRTimerRegistry setEnabled:YES];
+    dispatch_queue_t queue = dispatch_queue_create("com.chronus.CHRTimerRegistryTests", DISPATCH_QUEUE_SERIAL);
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDispatchTimer *idle = [self idleTimerWithQueue:queue];
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.01;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        [NSThread sleepForTimeInterval:0.005];
+        if (invocation == 2) {
+            [timer pause];
+            dispatch_semaphore_signal(semaphore);
+        }
+    } executionQueue:queue];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    // Let the last execution finish accounting for itself.
+    dispatch_sync(queue, ^{});
+    
+    CHRQueueLoad *load = nil;
+    for (CHRQueueLoad *candidate in [CHRTimerRegistry queueLoads]) {
+        if (candidate.executionQueue == queue) {
+            load = candidate;
+        }
+    }
+    XCTAssertEqualObjects(@"com.chronus.CHRTimerRegistryTests", load.label);
+    XCTAssertEqual(2, load.timers);
+    XCTAssertEqual(3, load.invocations);
+    XCTAssertGreaterThan(load.executionTime, 0.01);
+    
+    [idle cancel];
+    [timer cancel];
+}
+
+#pragma mark Benchmarks
+
+- (void)testPerformanceCreateTimersUnregistered
+{
+    [self measureBlock:^{
+        [self createAndDestroyTimerCount:10000];
+    }];
+}
+
+- (void)testPerformanceCreateTimersRegistered
+{
+    [CHRTimerRegistry setEnabled:YES];
+    [self measureBlock:^{
+        [self createAndDestroyTimerCount:10000];
+    }];
+}
+
+- (void)testPerformanceSnapshot10kTimers
+{
+    [CHRTimerRegistry setEnabled:YES];
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    NSMutableArray *timers = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 10000; ++i) {
+        [timers addObject:[self idleTimerWithQueue:queue]];
+    }
+    [self measureBlock:^{
+        XCTAssertGreaterThanOrEqual([CHRTimerRegistry queueLoads].count, 1);
+    }];
+}
+
+#pragma mark Private
+
+- (CHRDispatchTimer *)idleTimerWithQueue:(dispatch_queue_t)queue
+{
+    return [CHRDispatchTimer timerWithInterval:60.0
+                                executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                    // nothing to do
+                                }
+                                executionQueue:queue];
+}
+
+- (NSArray *)snapshotsForQueue:(dispatch_queue_t)queue
+{
+    NSMutableArray *snapshots = [NSMutableArray array];
+    for (CHRTimerSnapshot *snapshot in [CHRTimerRegistry timerSnapshots]) {
+        if (snapshot.executionQueue == queue) {
+            [snapshots addObject:snapshot];
+        }
+    }
+    return snapshots;
+}
+
+- (void)createAndDestroyTimerCount:(NSUInteger)count
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    @autoreleasepool {
+        NSMutableArray *timers = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; ++i) {
+            [timers addObject:[self idleTimerWithQueue:queue]];
+        }
+    }
+}
+
+@end
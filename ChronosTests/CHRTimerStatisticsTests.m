@@ -0,0 +1,164 @@
+//
+//  CHRTimerStatisticsTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+#import "CHRTimerStatisticsInternal.h"
+
+
+#pragma mark - CHRTimerStatisticsTests Interface
+
+@interface CHRTimerStatisticsTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimerStatisticsTests Implementation
+
+@implementation CHRTimerStatisticsTests
+
+- (void)testEmptyStatistics
+{
+    CHRTimerStatistics *statistics = [CHRTimerStatistics statistics];
+    XCTAssertEqual(0, statistics.fires);
+    XCTAssertEqual(0, statistics.skips);
+    XCTAssertEqual(0.0, [statistics latenessAtPercentile:50.0]);
+    XCTAssertEqual(0.0, [statistics durationAtPercentile:99.9]);
+    XCTAssertEqual(0.0, statistics.maximumLateness);
+}
+
+- (void)testPercentiles
+{
+    CHRTimerStatistics *statistics = [CHRTimerStatistics statistics];
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        [statistics recordLateness:i * NSEC_PER_USEC duration:NSEC_PER_MSEC skipped:0];
+    }
+    XCTAssertEqual(1000, statistics.fires);
+    XCTAssertEqualWithAccuracy(0.000500, [statistics latenessAtPercentile:50.0], 0.000500 * 0.125);
+    XCTAssertEqualWithAccuracy(0.000990, [statistics latenessAtPercentile:99.0], 0.000990 * 0.125);
+    XCTAssertEqualWithAccuracy(0.001000, statistics.maximumLateness, 0.000000001);
+    XCTAssertEqualWithAccuracy(0.001, [statistics durationAtPercentile:50.0], 0.001 * 0.125);
+    XCTAssertLessThanOrEqual([statistics latenessAtPercentile:100.0], statistics.maximumLateness);
+}
+
+- (void)testSmallValuesAreExact
+{
+    CHRTimerStatistics *statistics = [CHRTimerStatistics statistics];
+    [statistics recordLateness:0 duration:3 skipped:0];
+    [statistics recordLateness:0 duration:5 skipped:2];
+    XCTAssertEqual(0.0, [statistics latenessAtPercentile:100.0]);
+    XCTAssertEqual(3.0 / NSEC_PER_SEC, [statistics durationAtPercentile:50.0]);
+    XCTAssertEqual(5.0 / NSEC_PER_SEC, [statistics durationAtPercentile:100.0]);
+    XCTAssertEqual(2, statistics.skips);
+}
+
+- (void)testReset
+{
+    CHRTimerStatistics *statistics = [CHRTimerStatistics statistics];
+    [statistics recordLateness:NSEC_PER_MSEC duration:NSEC_PER_MSEC skipped:1];
+    [statistics reset];
+    XCTAssertEqual(0, statistics.fires);
+    XCTAssertEqual(0, statistics.skips);
+    XCTAssertEqual(0.0, statistics.maximumDuration);
+}
+
+- (void)testDispatchTimerRecordsFirings
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.02
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       if (invocation == 4) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    XCTAssertNil(timer.statistics);
+    timer.statistics = [CHRTimerStatistics statistics];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [timer cancel];
+
+    XCTAssertGreaterThanOrEqual(timer.statistics.fires, 5);
+    XCTAssertLessThan([timer.statistics latenessAtPercentile:50.0], CHRDefaultAsyncTestTimeout);
+}
+
+- (void)testDispatchTimerCountsSkips
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.01
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       if (invocation == 0) {
+                                                           [NSThread sleepForTimeInterval:0.1];
+                                                       } else if (invocation == 2) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    timer.statistics = [CHRTimerStatistics statistics];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [timer cancel];
+
+    XCTAssertGreaterThan(timer.statistics.skips, 0);
+    XCTAssertGreaterThanOrEqual(timer.statistics.maximumDuration, 0.1);
+}
+
+- (void)testVariableTimerRecordsFirings
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.01 * (nextInvocation + 1);
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        if (invocation == 3) {
+            dispatch_semaphore_signal(semaphore);
+        }
+    } executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    timer.statistics = [CHRTimerStatistics statistics];
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [timer cancel];
+
+    XCTAssertGreaterThanOrEqual(timer.statistics.fires, 4);
+    XCTAssertEqual(0, timer.statistics.skips);
+}
+
+#pragma mark Benchmarks
+
+- (void)testPerformanceRecord
+{
+    CHRTimerStatistics *statistics = [CHRTimerStatistics statistics];
+    [self measureBlock:^{
+        for (uint64_t i = 0; i < 1000000; ++i) {
+            [statistics recordLateness:i duration:i skipped:0];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,198 @@
+//
+//  CHRTimerTraceTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+#import "CHRTimerTrace.h"
+
+
+#pragma mark - CHRTimerTraceTests Interface
+
+@interface CHRTimerTraceTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimerTraceTests Implementation
+
+@implementation CHRTimerTraceTests
+
+- (void)setUp
+{
+    [super setUp];
+    [CHRTimerTrace clear];
+}
+
+- (void)tearDown
+{
+    [CHRTimerTrace setEnabled:NO];
+    [CHRTimerTrace clear];
+    [super tearDown];
+}
+
+- (void)testDisabledRecordsNothing
+{
+    XCTAssertFalse([CHRTimerTrace isEnabled]);
+    [self runDispatchTimerUntilInvocation:2];
+    
+    XCTAssertEqual(0, [self traceEvents].count);
+}
+
+- (void)testDispatchTimerEvents
+{
+    [CHRTimerTrace setEnabled:YES];
+    NSString *timer = [self runDispatchTimerUntilInvocation:2];
+    [CHRTimerTrace setEnabled:NO];
+    
+    NSArray *events = [self traceEventsForTimer:timer];
+    NSArray *names = [events valueForKey:@"name"];
+    XCTAssertEqualObjects(@"arm", names.firstObject);
+    XCTAssertEqual(1, [self countOfEvents:events name:@"cancel" phase:@"i"]);
+    XCTAssertEqual(3, [self countOfEvents:events name:@"fire" phase:@"i"]);
+    XCTAssertEqual(3, [self countOfEvents:events name:@"execute" phase:@"b"]);
+    XCTAssertEqual(3, [self countOfEvents:events name:@"execute" phase:@"e"]);
+}
+
+- (void)testVariableTimerPauseAndResume
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    [CHRTimerTrace setEnabled:YES];
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.01;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        if (invocation == 0) {
+            [timer pause];
+            [timer start:NO];
+        } else if (invocation == 1) {
+            [timer cancel];
+            dispatch_semaphore_signal(semaphore);
+        }
+    }];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [CHRTimerTrace setEnabled:NO];
+    
+    NSArray *events = [self traceEventsForTimer:[NSString stringWithFormat:@"%p", timer]];
+    XCTAssertEqual(1, [self countOfEvents:events name:@"pause" phase:@"i"]);
+    XCTAssertEqual(1, [self countOfEvents:events name:@"resume" phase:@"i"]);
+    XCTAssertEqual(1, [self countOfEvents:events name:@"cancel" phase:@"i"]);
+    XCTAssertEqual(2, [self countOfEvents:events name:@"fire" phase:@"i"]);
+}
+
+- (void)testClearDiscardsEvents
+{
+    [CHRTimerTrace setEnabled:YES];
+    [self runDispatchTimerUntilInvocation:0];
+    XCTAssertGreaterThan([self traceEvents].count, 0);
+    
+    [CHRTimerTrace clear];
+    XCTAssertEqual(0, [self traceEvents].count);
+}
+
+- (void)testWriteChromeTrace
+{
+    [CHRTimerTrace setEnabled:YES];
+    [self runDispatchTimerUntilInvocation:0];
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    NSError *error = nil;
+    XCTAssertTrue([CHRTimerTrace writeChromeTraceToFile:path error:&error]);
+    XCTAssertNil(error);
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:path] options:0 error:NULL];
+    XCTAssertNotNil(trace[@"traceEvents"]);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+#pragma mark Benchmarks
+
+- (void)testPerformanceFireWithTracingDisabled
+{
+    [self measureBlock:^{
+        [self runDispatchTimerUntilInvocation:999 interval:0.0001];
+    }];
+}
+
+- (void)testPerformanceFireWithTracingEnabled
+{
+    [CHRTimerTrace setEnabled:YES];
+    [self measureBlock:^{
+        [self runDispatchTimerUntilInvocation:999 interval:0.0001];
+    }];
+}
+
+#pragma mark Private
+
+/**
+ Runs a dispatch timer until the given invocation, cancels it and returns its
+ address as it appears in the trace.
+ */
+- (NSString *)runDispatchTimerUntilInvocation:(NSUInteger)last
+{
+    return [self runDispatchTimerUntilInvocation:last interval:0.01];
+}
+
+- (NSString *)runDispatchTimerUntilInvocation:(NSUInteger)last interval:(NSTimeInterval)interval
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:interval
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       if (invocation == last) {
+                                                           [timer cancel];
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    return [NSString stringWithFormat:@"%p", timer];
+}
+
+- (NSArray *)traceEvents
+{
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[CHRTimerTrace chromeTraceData] options:0 error:NULL];
+    return trace[@"traceEvents"];
+}
+
+/**
+ Returns the exported events of the given timer, in timestamp order.
+ */
+- (NSArray *)traceEventsForTimer:(NSString *)timer
+{
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"args.timer == %@", timer];
+    NSArray *events = [[self traceEvents] filteredArrayUsingPredicate:predicate];
+    return [events sortedArrayUsingDescriptors:@[[NSSortDescriptor sortDescriptorWithKey:@"ts" ascending:YES]]];
+}
+
+- (NSUInteger)countOfEvents:(NSArray *)events name:(NSString *)name phase:(NSString *)phase
+{
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"name == %@ AND ph == %@", name, phase];
+    return [events filteredArrayUsingPredicate:predicate].count;
+}
+
+@end
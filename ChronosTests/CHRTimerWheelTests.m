@@ -0,0 +1,315 @@
+//
+//  CHRTimerWheelTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+#import "CHRTimerWheel.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSTimeInterval CHRTimerWheelBenchmarkInterval = 0.05;
+static NSTimeInterval CHRTimerWheelBenchmarkDuration = 1.0;
+
+
+#pragma mark - CHRTimerWheelTests Interface
+
+@interface CHRTimerWheelTests : XCTestCase
+
+@end
+
+
+#pragma mark - CHRTimerWheelTests Implementation
+
+@implementation CHRTimerWheelTests
+
+- (void)testTimerFireOnce
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRTimerWheel *wheel = [CHRTimerWheel wheelWithResolution:0.01];
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.5
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       XCTAssertEqual(0, invocation);
+                                                       dispatch_semaphore_signal(semaphore);
+                                                   }
+                                                   executionQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)
+                                                        scheduler:wheel];
+    [timer start:YES];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertTrue(timer.isRunning);
+
+    [timer cancel];
+
+    XCTAssertFalse(timer.isValid);
+    XCTAssertFalse(timer.isRunning);
+    XCTAssertEqual(0, wheel.count);
+}
+
+- (void)testTimerRepeats
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRTimerWheel *wheel = [CHRTimerWheel wheelWithResolution:0.01];
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.05
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       if (invocation == 3) {
+                                                           dispatch_semaphore_signal(semaphore);
+                                                       }
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)
+                                                        scheduler:wheel];
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+
+    [timer cancel];
+}
+
+- (void)testCountTracksArmedTimers
+{
+    CHRTimerWheel *wheel = [CHRTimerWheel wheelWithResolution:0.01];
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    NSMutableArray *timers = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 3; ++i) {
+        CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:60.0
+                                                       executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                           // nothing to do
+                                                       }
+                                                       executionQueue:queue
+                                                            scheduler:wheel];
+        [timer start:NO];
+        [timers addObject:timer];
+    }
+    XCTAssertEqual(3, wheel.count);
+
+    [timers[0] pause];
+    XCTAssertEqual(2, wheel.count);
+
+    [timers[0] start:NO];
+    XCTAssertEqual(3, wheel.count);
+
+    [timers[1] cancel];
+    [timers[2] pause];
+    [timers[2] cancel];
+    XCTAssertEqual(1, wheel.count);
+
+    [timers[0] cancel];
+    XCTAssertEqual(0, wheel.count);
+}
+
+- (void)testLongIntervalDoesNotFire
+{
+    __block BOOL fired = NO;
+    CHRTimerWheel *wheel = [CHRTimerWheel wheelWithResolution:0.001];
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:5.0
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       fired = YES;
+                                                   }
+                                                   executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)
+                                                        scheduler:wheel];
+    [timer start:NO];
+    [NSThread sleepForTimeInterval:0.5];
+
+    XCTAssertFalse(fired);
+    XCTAssertEqual(1, wheel.count);
+
+    [timer cancel];
+}
+
+- (void)testVariableTimerPauseInsideStartInside
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    NSMutableArray *executedInvocations = @[].mutableCopy;
+    NSMutableArray *intervalInvocations = @[].mutableCopy;
+    CHRTimerWheel *wheel = [CHRTimerWheel wheelWithResolution:0.01];
+
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        [intervalInvocations addObject:@(nextInvocation)];
+        return 0.05;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        [executedInvocations addObject:@(invocation)];
+        if (invocation == 0) {
+            [timer pause];
+            [timer start:NO];
+        } else if (invocation == 3) {
+            [timer cancel];
+            dispatch_semaphore_signal(semaphore);
+        }
+    } executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL) scheduler:wheel];
+
+    [timer start:NO];
+
+    dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout));
+
+    XCTAssertEqual(4, timer.invocations);
+    XCTAssertEqual(0, wheel.count);
+
+    NSArray *expectedExecutedInvocations = @[@(0), @(1), @(2), @(3)];
+    NSArray *expectedIntervalInvocations = @[@(0), @(1), @(2), @(3)];
+    XCTAssertEqualObjects(expectedExecutedInvocations, executedInvocations);
+    XCTAssertEqualObjects(expectedIntervalInvocations, intervalInvocations);
+}
+
+- (void)testConcurrentExpiriesCountEveryInvocation
+{
+    CHRTimerWheel *wheel = [CHRTimerWheel wheelWithResolution:0.001];
+    NSMutableIndexSet *invocations = [NSMutableIndexSet indexSet];
+    __block NSUInteger executions = 0;
+    __block NSUInteger duplicates = 0;
+    NSLock *lock = [[NSLock alloc]init];
+    CHRDispatchTimer *timer = [CHRDispatchTimer timerWithInterval:0.001
+                                                   executionBlock:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+                                                       [lock lock];
+                                                       if ([invocations containsIndex:invocation]) {
+                                                           duplicates++;
+                                                       }
+                                                       [invocations addIndex:invocation];
+                                                       executions++;
+                                                       [lock unlock];
+                                                       // Outlast several expiries so that their handlers overlap.
+                                                       [NSThread sleepForTimeInterval:0.005];
+                                                   }
+                                                   executionQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)
+                                                        scheduler:wheel];
+    [timer start:NO];
+    [NSThread sleepForTimeInterval:0.3];
+    [timer cancel];
+    [NSThread sleepForTimeInterval:0.1];
+    
+    [lock lock];
+    XCTAssertGreaterThan(executions, 1);
+    XCTAssertEqual(0, duplicates);
+    XCTAssertEqual(timer.invocations, executions + timer.missedInvocations);
+    [lock unlock];
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmark1kTimers
+{
+    [self benchmarkTimerCount:1000 wheel:nil];
+    [self benchmarkTimerCount:1000 wheel:[CHRTimerWheel wheelWithResolution:0.01]];
+}
+
+- (void)testBenchmark10kTimers
+{
+    [self benchmarkTimerCount:10000 wheel:nil];
+    [self benchmarkTimerCount:10000 wheel:[CHRTimerWheel wheelWithResolution:0.01]];
+}
+
+- (void)testBenchmark100kTimers
+{
+    [self benchmarkTimerCount:100000 wheel:nil];
+    [self benchmarkTimerCount:100000 wheel:[CHRTimerWheel wheelWithResolution:0.01]];
+}
+
+- (void)testPerformanceSourceStartAndCancel
+{
+    [self measureBlock:^{
+        [self startAndCancelTimerCount:10000 wheel:nil];
+    }];
+}
+
+- (void)testPerformanceWheelStartAndCancel
+{
+    CHRTimerWheel *wheel = [CHRTimerWheel wheelWithResolution:0.01];
+    [self measureBlock:^{
+        [self startAndCancelTimerCount:10000 wheel:wheel];
+    }];
+}
+
+#pragma mark Private
+
+- (CHRDispatchTimer *)benchmarkTimerWithQueue:(dispatch_queue_t)queue wheel:(CHRTimerWheel *)wheel
+{
+    CHRRepeatingTimerExecutionBlock executionBlock = ^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        // nothing to do
+    };
+    if (wheel) {
+        return [CHRDispatchTimer timerWithInterval:CHRTimerWheelBenchmarkInterval
+                                    executionBlock:executionBlock
+                                    executionQueue:queue
+                                         scheduler:wheel];
+    }
+    return [CHRDispatchTimer timerWithInterval:CHRTimerWheelBenchmarkInterval
+                                executionBlock:executionBlock
+                                executionQueue:queue];
+}
+
+- (void)startAndCancelTimerCount:(NSUInteger)count wheel:(CHRTimerWheel *)wheel
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        CHRDispatchTimer *timer = [self benchmarkTimerWithQueue:queue wheel:wheel];
+        [timer start:NO];
+        [timers addObject:timer];
+    }
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+}
+
+/**
+ Reports the resident memory added per timer and the CPU time spent per period
+ while every timer fires, for either one source per timer or a shared wheel.
+ */
+- (void)benchmarkTimerCount:(NSUInteger)count wheel:(CHRTimerWheel *)wheel
+{
+    dispatch_queue_t queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:count];
+
+    uint64_t residentBefore = chr_residentSize();
+    for (NSUInteger i = 0; i < count; ++i) {
+        CHRDispatchTimer *timer = [self benchmarkTimerWithQueue:queue wheel:wheel];
+        [timer start:NO];
+        [timers addObject:timer];
+    }
+    uint64_t residentAfter = chr_residentSize();
+
+    NSTimeInterval cpuBefore = chr_cpuTime();
+    [NSThread sleepForTimeInterval:CHRTimerWheelBenchmarkDuration];
+    NSTimeInterval cpuAfter = chr_cpuTime();
+
+    NSUInteger invocations = 0;
+    for (CHRDispatchTimer *timer in timers) {
+        invocations += timer.invocations;
+        [timer cancel];
+    }
+
+    NSTimeInterval periods = CHRTimerWheelBenchmarkDuration / CHRTimerWheelBenchmarkInterval;
+    NSLog(@"%@ %lu timers: %.0f bytes per timer, %.3f ms CPU per period, %lu invocations",
+          (wheel)? @"wheel" : @"sources",
+          (unsigned long)count,
+          (double)(int64_t)(residentAfter - residentBefore) / count,
+          (cpuAfter - cpuBefore) * 1000.0 / periods,
+          (unsigned long)invocations);
+    XCTAssertGreaterThan(invocations, 0);
+}
+
+@end
@@ -31,6 +31,11 @@
 #import "CHRVariableTimer.h"
 
 
+#pragma mark - Constants and Functions
+
+static size_t CHRStressIterations = 100000;
+
+
 #pragma mark - CHRVariableTimerTests Interface
 
 @interface CHRVariableTimerTests : XCTestCase
@@ -183,4 +188,253 @@
     XCTAssertEqualObjects(expectedIntervalInvocations, intervalInvocations);
 }
 
+
+- (void)testConcurrentStartPauseCancel
+{
+    __block _Atomic(int32_t) fired = 0;
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.001;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        atomic_store(&fired, 1);
+    }];
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    dispatch_apply(CHRStressIterations, queue, ^(size_t i) {
+        if (i % 2) {
+            [timer start:(i % 3 == 0)];
+        } else {
+            [timer pause];
+        }
+    });
+    
+    // An unbalanced suspend count would keep the source from firing.
+    [timer pause];
+    XCTAssertFalse(timer.isRunning);
+    atomic_store(&fired, 0);
+    [timer start:YES];
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(1, atomic_load(&fired));
+    
+    dispatch_apply(CHRStressIterations, queue, ^(size_t i) {
+        @try {
+            switch (i % 3) {
+                case 0: [timer start:NO]; break;
+                case 1: [timer pause]; break;
+                default: [timer cancel]; break;
+            }
+        } @catch (NSException *exception) {
+            // start and pause throw once the timer has been canceled
+        }
+    });
+    XCTAssertFalse(timer.isValid);
+    XCTAssertFalse(timer.isRunning);
+}
+
+
+- (void)testPauseStartWhileFiring
+{
+    __block NSUInteger lastInvocation = 0;
+    __block BOOL ordered = YES;
+    __block _Atomic(int32_t) fired = 0;
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.0001;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        if (invocation && invocation <= lastInvocation) {
+            ordered = NO;
+        }
+        lastInvocation = invocation;
+        atomic_store(&fired, 1);
+    } executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    [timer start:YES];
+    
+    // Control calls race with the event handler rescheduling the source.
+    CFAbsoluteTime end = CFAbsoluteTimeGetCurrent() + 0.5;
+    dispatch_apply(4, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        while (CFAbsoluteTimeGetCurrent() < end) {
+            if (i % 2) {
+                [timer start:NO];
+            } else {
+                [timer pause];
+            }
+        }
+    });
+    
+    [timer start:NO];
+    atomic_store(&fired, 0);
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(1, atomic_load(&fired));
+    [timer cancel];
+    dispatch_sync(timer.executionQueue, ^{});
+    XCTAssertTrue(ordered);
+}
+
+- (void)testAbsoluteDeadlinesDoNotDrift
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.05;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        [NSThread sleepForTimeInterval:0.03];
+        if (invocation == 5) {
+            dispatch_semaphore_signal(semaphore);
+        }
+    } executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    timer.usesAbsoluteDeadlines = YES;
+    
+    NSDate *start = [NSDate date];
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    [timer cancel];
+    
+    // Six firings 50ms apart end at 330ms, measuring from each block's return would take 480ms.
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 0.42);
+}
+
+- (void)testMissedDeadlineFireImmediately
+{
+    XCTAssertGreaterThanOrEqual([self invocationsAfterMissedDeadlinesWithPolicy:CHRMissedDeadlinePolicyFireImmediately], 10);
+}
+
+- (void)testMissedDeadlineSkip
+{
+    XCTAssertLessThan([self invocationsAfterMissedDeadlinesWithPolicy:CHRMissedDeadlinePolicySkip], 10);
+}
+
+- (void)testBatchIntervalProvider
+{
+    __block NSUInteger batches = 0;
+    CHRVariableTimerIntervalProvider provider = [CHRVariableTimer intervalProviderWithBatchSize:4 batchProvider:^NSUInteger(CHRVariableTimer *__weak timer, NSUInteger nextInvocation, NSTimeInterval *intervals, NSUInteger count) {
+        ++batches;
+        for (NSUInteger i = 0; i < count; ++i) {
+            intervals[i] = nextInvocation + i;
+        }
+        return count;
+    }];
+    
+    for (NSUInteger i = 0; i < 9; ++i) {
+        XCTAssertEqual((NSTimeInterval)i, provider(nil, i));
+    }
+    XCTAssertEqual(3, batches);
+    
+    XCTAssertEqual(20.0, provider(nil, 20));
+    XCTAssertEqual(21.0, provider(nil, 21));
+    XCTAssertEqual(4, batches);
+}
+
+- (void)testBatchIntervalProviderDrivesTimer
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSUInteger batches = 0;
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:[CHRVariableTimer intervalProviderWithBatchSize:8 batchProvider:^NSUInteger(CHRVariableTimer *__weak timer, NSUInteger nextInvocation, NSTimeInterval *intervals, NSUInteger count) {
+        ++batches;
+        for (NSUInteger i = 0; i < count; ++i) {
+            intervals[i] = 0.01;
+        }
+        return count;
+    }] executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        if (invocation == 9) {
+            [timer cancel];
+            dispatch_semaphore_signal(semaphore);
+        }
+    } executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    
+    [timer start:NO];
+    XCTAssertEqual(0, dispatch_semaphore_wait(semaphore, chr_timeout(CHRDefaultAsyncTestTimeout)));
+    XCTAssertEqual(2, batches);
+}
+
+- (void)testOverlapPolicySkip
+{
+    __block atomic_uint inFlight = 0;
+    __block atomic_uint maximum = 0;
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.01;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        unsigned int current = atomic_fetch_add(&inFlight, 1) + 1;
+        unsigned int observed = atomic_load(&maximum);
+        while (current > observed && !atomic_compare_exchange_weak(&maximum, &observed, current));
+        [NSThread sleepForTimeInterval:0.05];
+        atomic_fetch_sub(&inFlight, 1);
+    } executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_CONCURRENT)];
+    timer.overlapPolicy = CHROverlapPolicySkip;
+    
+    [timer start:YES];
+    [NSThread sleepForTimeInterval:0.5];
+    [timer cancel];
+    [NSThread sleepForTimeInterval:0.1];
+    
+    XCTAssertEqual(1, atomic_load(&maximum));
+    XCTAssertGreaterThan(timer.skippedInvocations, 0);
+    XCTAssertGreaterThan(timer.invocations, 20);
+}
+
+- (void)testAsyncCompletionGatesRescheduling
+{
+    __block atomic_uint inFlight = 0;
+    __block atomic_uint maximum = 0;
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.01;
+    } asyncExecutionBlock:^(CHRVariableTimer *__weak timer, NSUInteger invocation, dispatch_block_t completion) {
+        unsigned int current = atomic_fetch_add(&inFlight, 1) + 1;
+        unsigned int observed = atomic_load(&maximum);
+        while (current > observed && !atomic_compare_exchange_weak(&maximum, &observed, current));
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            atomic_fetch_sub(&inFlight, 1);
+            completion();
+            completion();
+        });
+    }];
+    
+    [timer start:YES];
+    [NSThread sleepForTimeInterval:0.55];
+    [timer cancel];
+    
+    XCTAssertEqual(1, atomic_load(&maximum));
+    XCTAssertGreaterThanOrEqual(timer.invocations, 3);
+    XCTAssertLessThanOrEqual(timer.invocations, 6);
+    XCTAssertEqual(0, timer.timedOutCompletions);
+}
+
+- (void)testAsyncCompletionTimeout
+{
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.01;
+    } asyncExecutionBlock:^(CHRVariableTimer *__weak timer, NSUInteger invocation, dispatch_block_t completion) {
+        // never completes
+    }];
+    timer.completionTimeout = 0.05;
+    
+    [timer start:YES];
+    [NSThread sleepForTimeInterval:0.5];
+    [timer cancel];
+    
+    XCTAssertGreaterThanOrEqual(timer.invocations, 3);
+    XCTAssertLessThanOrEqual(timer.invocations, 9);
+    XCTAssertGreaterThanOrEqual(timer.timedOutCompletions, timer.invocations - 1);
+}
+
+#pragma mark Private
+
+/**
+ Runs a 20ms timer with absolute deadlines whose first execution takes 200ms,
+ and returns the number of invocations after 300ms.
+ */
+- (NSUInteger)invocationsAfterMissedDeadlinesWithPolicy:(CHRMissedDeadlinePolicy)policy
+{
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 0.02;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        if (invocation == 0) {
+            [NSThread sleepForTimeInterval:0.2];
+        }
+    } executionQueue:dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL)];
+    timer.usesAbsoluteDeadlines = YES;
+    timer.missedDeadlinePolicy = policy;
+    
+    [timer start:YES];
+    [NSThread sleepForTimeInterval:0.3];
+    NSUInteger invocations = timer.invocations;
+    [timer cancel];
+    return invocations;
+}
+
 @end
@@ -0,0 +1,422 @@
+//
+//  CHRVirtualClockTests.m
+//  Chronos
+//
+//  Copyright (c) 2015 Comyar Zaheri. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//  IN THE SOFTWARE.
+//
+
+
+#pragma mark - Imports
+
+@import XCTest;
+#import "CHRTestInternal.h"
+#import "CHRDispatchTimer.h"
+#import "CHRVariableTimer.h"
+#import "CHRTimerStatistics.h"
+#import "CHRVirtualClock.h"
+
+
+#pragma mark - Constants and Functions
+
+static NSUInteger CHRVirtualClockBenchmarkTimers = 1000;
+static NSTimeInterval CHRVirtualClockBenchmarkDuration = 3600.0;
+
+
+#pragma mark - CHRVirtualClockTests Interface
+
+/**
+ Exercises the clock itself, and runs the scheduling tests of
+ CHRDispatchTimerTests and CHRVariableTimerTests on virtual time, where they
+ are exact and take no real time.
+ */
+@interface CHRVirtualClockTests : XCTestCase
+
+@property (nonatomic) dispatch_queue_t queue;
+
+@end
+
+
+#pragma mark - CHRVirtualClockTests Implementation
+
+@implementation CHRVirtualClockTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.queue = dispatch_queue_create(NULL, DISPATCH_QUEUE_SERIAL);
+}
+
+#pragma mark Clock
+
+- (void)testEntriesFireInDeadlineOrder
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    NSMutableArray *fired = [NSMutableArray array];
+    NSMutableArray *entries = [NSMutableArray array];
+    NSArray *delays = @[@(30), @(10), @(20), @(10)];
+    for (NSUInteger i = 0; i < delays.count; ++i) {
+        CHRTimerSchedulerEntry entry = [clock createEntryWithQueue:self.queue handler:^{
+            [fired addObject:@(i)];
+        }];
+        [clock armEntry:entry delay:[delays[i] unsignedLongLongValue] * NSEC_PER_MSEC interval:0 leeway:0];
+        [entries addObject:[NSValue valueWithPointer:entry]];
+    }
+    XCTAssertEqual(4, clock.count);
+    
+    XCTAssertEqual(0, [clock advanceBy:0.005]);
+    XCTAssertEqual(2, [clock advanceToNextDeadline]);
+    XCTAssertEqualWithAccuracy(0.01, clock.now, 1e-9);
+    XCTAssertEqual(2, [clock advanceBy:1.0]);
+    XCTAssertEqualWithAccuracy(1.01, clock.now, 1e-9);
+    
+    XCTAssertEqualObjects((@[@(1), @(3), @(2), @(0)]), fired);
+    XCTAssertEqual(0, clock.count);
+    XCTAssertEqual(4, clock.firings);
+    for (NSValue *entry in entries) {
+        [clock destroyEntry:entry.pointerValue];
+    }
+}
+
+- (void)testRepeatingEntryAndDisarm
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    __block NSUInteger fired = 0;
+    CHRTimerSchedulerEntry entry = [clock createEntryWithQueue:self.queue handler:^{
+        fired++;
+    }];
+    [clock armEntry:entry delay:NSEC_PER_SEC interval:NSEC_PER_SEC leeway:0];
+    
+    XCTAssertEqual(10, [clock advanceBy:10.0]);
+    XCTAssertEqual(1, clock.count);
+    
+    [clock disarmEntry:entry];
+    XCTAssertEqual(0, [clock advanceBy:10.0]);
+    XCTAssertEqual(10, fired);
+    [clock destroyEntry:entry];
+}
+
+- (void)testElapseDelaysFollowingFirings
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    NSMutableArray *times = [NSMutableArray array];
+    __weak CHRVirtualClock *weak = clock;
+    CHRTimerSchedulerEntry entry = [clock createEntryWithQueue:self.queue handler:^{
+        [times addObject:@(weak.now)];
+        if (times.count == 1) {
+            [weak elapse:3.5];
+        }
+    }];
+    [clock armEntry:entry delay:NSEC_PER_SEC interval:NSEC_PER_SEC leeway:0];
+    [clock advanceBy:6.0];
+    
+    // The overrun skips the periods it covered, like a dispatch source.
+    XCTAssertEqualObjects((@[@(1.0), @(4.5), @(5.5)]), times);
+    [clock destroyEntry:entry];
+}
+
+#pragma mark Dispatch Timer
+
+- (void)testDispatchTimerFireOnce
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    NSMutableArray *invocations = [NSMutableArray array];
+    CHRDispatchTimer *timer = [self dispatchTimerWithInterval:0.5 clock:clock block:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+        [invocations addObject:@(invocation)];
+    }];
+    [timer start:YES];
+    [clock advanceBy:0.0];
+    XCTAssertEqualObjects(@[@(0)], invocations);
+    XCTAssertTrue(timer.isRunning);
+    
+    [timer cancel];
+    
+    XCTAssertFalse(timer.isValid);
+    XCTAssertFalse(timer.isRunning);
+    XCTAssertEqual(0, clock.count);
+}
+
+- (void)testDispatchTimerPauseAndStart
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    __block NSUInteger lastInvocation = NSNotFound;
+    CHRDispatchTimer *timer = [self dispatchTimerWithInterval:0.5 clock:clock block:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+        lastInvocation = invocation;
+    }];
+    [timer start:YES];
+    [clock advanceBy:0.1];
+    XCTAssertEqual(0, lastInvocation);
+    
+    [timer pause];
+    [clock advanceBy:10.0];
+    XCTAssertFalse(timer.isRunning);
+    XCTAssertEqual(0, lastInvocation);
+    
+    [timer start:YES];
+    [clock advanceBy:0.0];
+    XCTAssertTrue(timer.isRunning);
+    XCTAssertEqual(1, lastInvocation);
+    
+    [clock advanceBy:1.0];
+    XCTAssertEqual(3, lastInvocation);
+    [timer cancel];
+}
+
+- (void)testDispatchTimerCatchUpPolicySkip
+{
+    NSArray *invocations = [self invocationsAfterOverrunWithPolicy:CHRCatchUpPolicySkip elapsedPeriods:NULL missed:NULL];
+    XCTAssertEqualObjects((@[@(0), @(10), @(11), @(12)]), invocations);
+}
+
+- (void)testDispatchTimerCatchUpPolicyCoalesce
+{
+    NSUInteger elapsedPeriods = 0;
+    NSUInteger missed = 0;
+    NSArray *invocations = [self invocationsAfterOverrunWithPolicy:CHRCatchUpPolicyCoalesce elapsedPeriods:&elapsedPeriods missed:&missed];
+    XCTAssertEqualObjects((@[@(0), @(1), @(11), @(12)]), invocations);
+    XCTAssertEqual(10, elapsedPeriods);
+    XCTAssertEqual(0, missed);
+}
+
+- (void)testDispatchTimerCatchUpPolicyReplay
+{
+    NSUInteger missed = 0;
+    NSArray *invocations = [self invocationsAfterOverrunWithPolicy:CHRCatchUpPolicyReplay elapsedPeriods:NULL missed:&missed];
+    XCTAssertEqualObjects((@[@(0), @(8), @(9), @(10)]), invocations);
+    XCTAssertEqual(7, missed);
+}
+
+- (void)testDispatchTimerStatisticsUseVirtualTime
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    __weak CHRVirtualClock *weak = clock;
+    CHRDispatchTimer *timer = [self dispatchTimerWithInterval:1.0 clock:clock block:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+        [weak elapse:0.25];
+    }];
+    timer.statistics = [CHRTimerStatistics statistics];
+    [timer start:NO];
+    [clock advanceBy:100.0];
+    
+    XCTAssertEqual(100, timer.statistics.fires);
+    XCTAssertEqualWithAccuracy(0.25, timer.statistics.maximumDuration, 0.01);
+    [timer cancel];
+}
+
+#pragma mark Variable Timer
+
+- (void)testVariableTimerStartPauseInsideStartInside
+{
+    [self assertPauseInsideWithStartNow:NO restartNow:NO expectedIntervalInvocations:@[@(0), @(1), @(2), @(3)]];
+}
+
+- (void)testVariableTimerStartPauseInsideStartNowInside
+{
+    [self assertPauseInsideWithStartNow:NO restartNow:YES expectedIntervalInvocations:@[@(0), @(2), @(3)]];
+}
+
+- (void)testVariableTimerStartNowPauseInsideStartNowInside
+{
+    [self assertPauseInsideWithStartNow:YES restartNow:YES expectedIntervalInvocations:@[@(2), @(3)]];
+}
+
+- (void)testVariableTimerAbsoluteDeadlinesDoNotDrift
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    __weak CHRVirtualClock *weak = clock;
+    __block NSTimeInterval end = 0.0;
+    CHRVariableTimer *timer = [self variableTimerWithInterval:0.05 clock:clock block:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        [weak elapse:0.03];
+        if (invocation == 5) {
+            end = weak.now;
+            [timer cancel];
+        }
+    }];
+    timer.usesAbsoluteDeadlines = YES;
+    [timer start:NO];
+    [clock advanceBy:1.0];
+    
+    // Six firings 50ms apart end at 330ms, measuring from each block's return would take 480ms.
+    XCTAssertEqualWithAccuracy(0.33, end, 1e-6);
+}
+
+- (void)testVariableTimerMissedDeadlineFireImmediately
+{
+    XCTAssertEqual(16, [self invocationsAfterMissedDeadlinesWithPolicy:CHRMissedDeadlinePolicyFireImmediately]);
+}
+
+- (void)testVariableTimerMissedDeadlineSkip
+{
+    XCTAssertEqual(6, [self invocationsAfterMissedDeadlinesWithPolicy:CHRMissedDeadlinePolicySkip]);
+}
+
+- (void)testVariableTimerIntervals
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    NSMutableArray *times = [NSMutableArray array];
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return 2 * (nextInvocation + 1);
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        [times addObject:@(clock.now)];
+    } executionQueue:self.queue scheduler:clock];
+    [timer start:NO];
+    [clock advanceBy:30.0];
+    
+    XCTAssertEqualObjects((@[@(2.0), @(6.0), @(12.0), @(20.0), @(30.0)]), times);
+    [timer cancel];
+}
+
+#pragma mark Benchmarks
+
+- (void)testBenchmarkSimulatedFiringsPerSecond
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    NSMutableArray *timers = [NSMutableArray arrayWithCapacity:CHRVirtualClockBenchmarkTimers];
+    for (NSUInteger i = 0; i < CHRVirtualClockBenchmarkTimers; ++i) {
+        CHRDispatchTimer *timer = [self dispatchTimerWithInterval:1.0 + i * 0.001 clock:clock block:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+            // nothing to do
+        }];
+        [timer start:NO];
+        [timers addObject:timer];
+    }
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    NSUInteger firings = [clock advanceBy:CHRVirtualClockBenchmarkDuration];
+    CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSLog(@"%lu timers over %.0f simulated seconds: %lu firings in %.3f s, %.0f firings per second",
+          (unsigned long)CHRVirtualClockBenchmarkTimers,
+          CHRVirtualClockBenchmarkDuration,
+          (unsigned long)firings,
+          elapsed,
+          firings / elapsed);
+    XCTAssertGreaterThan(firings, CHRVirtualClockBenchmarkTimers * 1800);
+    for (CHRDispatchTimer *timer in timers) {
+        [timer cancel];
+    }
+}
+
+#pragma mark Private
+
+- (CHRDispatchTimer *)dispatchTimerWithInterval:(NSTimeInterval)interval
+                                          clock:(CHRVirtualClock *)clock
+                                          block:(CHRRepeatingTimerExecutionBlock)block
+{
+    return [CHRDispatchTimer timerWithInterval:interval
+                                executionBlock:block
+                                executionQueue:self.queue
+                                     scheduler:clock];
+}
+
+- (CHRVariableTimer *)variableTimerWithInterval:(NSTimeInterval)interval
+                                          clock:(CHRVirtualClock *)clock
+                                          block:(CHRRepeatingTimerExecutionBlock)block
+{
+    return [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        return interval;
+    } executionBlock:block executionQueue:self.queue scheduler:clock];
+}
+
+/**
+ Runs a 10ms timer whose first execution takes 100ms and returns the invocation
+ numbers of its first four executions.
+ */
+- (NSArray *)invocationsAfterOverrunWithPolicy:(CHRCatchUpPolicy)policy
+                                elapsedPeriods:(NSUInteger *)elapsedPeriods
+                                        missed:(NSUInteger *)missed
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    __weak CHRVirtualClock *weak = clock;
+    NSMutableArray *invocations = [NSMutableArray array];
+    __block NSUInteger periods = 0;
+    CHRDispatchTimer *timer = [self dispatchTimerWithInterval:0.01 clock:clock block:^(CHRDispatchTimer *__weak timer, NSUInteger invocation) {
+        [invocations addObject:@(invocation)];
+        if (invocations.count == 1) {
+            [weak elapse:0.1];
+        } else if (invocations.count == 2) {
+            periods = timer.elapsedPeriods;
+        } else if (invocations.count == 4) {
+            [timer pause];
+        }
+    }];
+    timer.catchUpPolicy = policy;
+    timer.maximumReplayedInvocations = 3;
+    [timer start:YES];
+    [clock advanceBy:1.0];
+    if (elapsedPeriods) {
+        *elapsedPeriods = periods;
+    }
+    if (missed) {
+        *missed = timer.missedInvocations;
+    }
+    [timer cancel];
+    return invocations;
+}
+
+- (void)assertPauseInsideWithStartNow:(BOOL)startNow
+                           restartNow:(BOOL)restartNow
+          expectedIntervalInvocations:(NSArray *)expectedIntervalInvocations
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    NSMutableArray *executedInvocations = @[].mutableCopy;
+    NSMutableArray *intervalInvocations = @[].mutableCopy;
+    CHRVariableTimer *timer = [CHRVariableTimer timerWithIntervalProvider:^NSTimeInterval(CHRVariableTimer *__weak timer, NSUInteger nextInvocation) {
+        [intervalInvocations addObject:@(nextInvocation)];
+        return 0.25;
+    } executionBlock:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        XCTAssertEqual(invocation + 1, timer.invocations);
+        [executedInvocations addObject:@(invocation)];
+        if (invocation == 0) {
+            [timer pause];
+            [timer start:restartNow];
+        } else if (invocation == 3) {
+            [timer cancel];
+        }
+    } executionQueue:self.queue scheduler:clock];
+    [timer start:startNow];
+    [clock advanceBy:10.0];
+    
+    XCTAssertEqual(4, timer.invocations);
+    XCTAssertEqualObjects((@[@(0), @(1), @(2), @(3)]), executedInvocations);
+    XCTAssertEqualObjects(expectedIntervalInvocations, intervalInvocations);
+}
+
+/**
+ Runs a 20ms timer with absolute deadlines whose first execution takes 200ms,
+ and returns the number of invocations after 300ms.
+ */
+- (NSUInteger)invocationsAfterMissedDeadlinesWithPolicy:(CHRMissedDeadlinePolicy)policy
+{
+    CHRVirtualClock *clock = [CHRVirtualClock clock];
+    __weak CHRVirtualClock *weak = clock;
+    CHRVariableTimer *timer = [self variableTimerWithInterval:0.02 clock:clock block:^(__weak id<CHRRepeatingTimer> timer, NSUInteger invocation) {
+        if (invocation == 0) {
+            [weak elapse:0.2];
+        }
+    }];
+    timer.usesAbsoluteDeadlines = YES;
+    timer.missedDeadlinePolicy = policy;
+    [timer start:YES];
+    [clock advanceBy:0.3];
+    NSUInteger invocations = timer.invocations;
+    [timer cancel];
+    return invocations;
+}
+
+@end